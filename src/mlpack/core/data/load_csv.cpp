@@ -3,7 +3,8 @@
  * @author Tham Ngap Wei
  * @author Mehul Kumar Nirala
  *
- * A CSV reader that uses boost::spirit.
+ * A CSV reader that uses boost::spirit, parsing chunks of the file in
+ * parallel.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -20,7 +21,10 @@ namespace data {
 LoadCSV::LoadCSV(const std::string& file) :
   extension(Extension(file)),
   filename(file),
-  inFile(file)
+  inFile(file),
+  blockSize(64 * 1024 * 1024),
+  streaming(false),
+  streamedLines(0)
 {
   // Attempt to open stream.
   CheckOpen();
@@ -83,5 +87,96 @@ void LoadCSV::CheckOpen()
   inFile.unsetf(std::ios::skipws);
 }
 
+void LoadCSV::Reset()
+{
+  inFile.clear();
+  inFile.seekg(0, std::ios::beg);
+  carry.clear();
+}
+
+bool LoadCSV::ReadBlock(std::string& block)
+{
+  // Start with the rest of the line that did not fit in the last block.
+  block.swap(carry);
+  carry.clear();
+
+  const size_t readSize = std::max(blockSize, (size_t) 1);
+  while (true)
+  {
+    const size_t oldSize = block.size();
+    block.resize(oldSize + readSize);
+    inFile.read(&block[oldSize], readSize);
+    block.resize(oldSize + (size_t) inFile.gcount());
+
+    // At the end of the file, the block holds everything that is left.
+    if (!inFile)
+      break;
+
+    // Otherwise, keep the partial last line for the next block.  If there is
+    // no newline at all, the line is longer than the block, so keep reading.
+    const size_t lastNewline = block.rfind('\n');
+    if (lastNewline != std::string::npos)
+    {
+      carry.assign(block, lastNewline + 1, std::string::npos);
+      block.resize(lastNewline + 1);
+      break;
+    }
+  }
+
+  return !block.empty();
+}
+
+size_t LoadCSV::CountLines(const char* begin, const char* end)
+{
+  if (begin == end)
+    return 0;
+
+  return std::count(begin, end, '\n') + ((*(end - 1) != '\n') ? 1 : 0);
+}
+
+void LoadCSV::SplitChunks(const char* begin,
+                          const char* end,
+                          std::vector<size_t>& bounds,
+                          std::vector<size_t>& lines)
+{
+  // Use a few chunks per thread so that the work is balanced even if some
+  // lines are much longer than others, but don't make the chunks so small
+  // that the overhead of parsing a chunk matters.
+  const size_t minChunkSize = 64 * 1024;
+  const size_t size = end - begin;
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  const size_t numChunks = std::max(std::min(4 * numThreads,
+      size / minChunkSize), (size_t) 1);
+
+  // Move the end of each chunk forward to the end of a line.
+  bounds.assign(1, 0);
+  for (size_t i = 1; i < numChunks; ++i)
+  {
+    size_t bound = std::max(i * (size / numChunks), bounds.back());
+    const char* newline = (const char*) std::memchr(begin + bound, '\n',
+        size - bound);
+    if (newline == NULL)
+      break;
+
+    bound = (newline - begin) + 1;
+    if (bound > bounds.back() && bound < size)
+      bounds.push_back(bound);
+  }
+  bounds.push_back(size);
+
+  // Count the lines of each chunk, and turn the counts into the index of the
+  // first line of each chunk.
+  lines.assign(bounds.size(), 0);
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) bounds.size() - 1; ++c)
+    lines[c + 1] = CountLines(begin + bounds[c], begin + bounds[c + 1]);
+
+  for (size_t c = 1; c < lines.size(); ++c)
+    lines[c] += lines[c - 1];
+}
+
 } // namespace data
 } // namespace mlpack
@@ -18,8 +18,11 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/util/log.hpp>
 
+#include <cstring>
 #include <set>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 
 #include "extension.hpp"
 #include "format.hpp"
@@ -32,6 +35,31 @@ namespace data {
  *Load the csv file.This class use boost::spirit
  *to implement the parser, please refer to following link
  *http://theboostcpplibraries.com/boost.spirit for quick review.
+ *
+ * The file is read in blocks of BlockSize() bytes that end on a newline.  Each
+ * block is split into chunks of whole lines, and the chunks are parsed in
+ * parallel with OpenMP directly into the preallocated output matrix.  Every
+ * chunk maps strings with its own copy of the DatasetMapper; the new mappings
+ * found by each chunk are merged into the given DatasetMapper afterwards, in
+ * the order of the chunks, so the mappings are the same as if the file had
+ * been parsed from start to end by one thread.  This assumes that in a
+ * dimension whose mapped values depend on the order of the mappings (such as
+ * categorical dimensions with IncrementPolicy), every value is a mapped value,
+ * and that the first pass of a mapping policy (if it needs one) only changes
+ * the types of the dimensions.
+ *
+ * Instead of loading the whole file, NextBatch() can be used to load a
+ * transposed matrix a fixed number of columns at a time:
+ *
+ * @code
+ * LoadCSV loader("dataset.csv");
+ * DatasetInfo info;
+ * arma::mat batch;
+ * while (loader.NextBatch(batch, info, 10000))
+ * {
+ *   // Use batch; its categorical values are mapped with info.
+ * }
+ * @endcode
  */
 class LoadCSV
 {
@@ -57,6 +85,7 @@ class LoadCSV
             const bool transpose = true)
   {
     CheckOpen();
+    streaming = false;
 
     if (transpose)
       TransposeParse(inout, infoSet);
@@ -64,6 +93,77 @@ class LoadCSV
       NonTransposeParse(inout, infoSet);
   }
 
+  /**
+   * Load the next batch of points of the file into the given matrix, which
+   * will have one point in each column (so the file is always transposed).
+   * On the first call, a first pass is taken over the whole file to
+   * initialize the DatasetMapper; after that, only one batch is held in memory
+   * at a time.  The same DatasetMapper must be passed to every call, so that
+   * the categorical mappings of all batches are consistent.  Throws exceptions
+   * on errors.
+   *
+   * @param batch Matrix to load the batch into.
+   * @param infoSet DatasetMapper to use while loading.
+   * @param batchSize Number of points to load; the last batch of the file may
+   *     hold fewer points.
+   * @return false if there are no more points in the file.
+   */
+  template<typename T, typename PolicyType>
+  bool NextBatch(arma::Mat<T>& batch,
+                 DatasetMapper<PolicyType>& infoSet,
+                 const size_t batchSize)
+  {
+    CheckOpen();
+    if (batchSize == 0)
+    {
+      throw std::invalid_argument("LoadCSV::NextBatch(): batchSize must be "
+          "positive!");
+    }
+
+    if (!streaming)
+    {
+      size_t rows, cols;
+      GetTransposeMatrixSize<T>(rows, cols, infoSet);
+
+      Reset();
+      pending.clear();
+      streamedLines = 0;
+      streaming = true;
+    }
+
+    // Read until we have enough lines for the batch, or the file ends.
+    size_t pendingLines = CountLines(pending.data(),
+        pending.data() + pending.size());
+    std::string block;
+    while (pendingLines < batchSize && ReadBlock(block))
+    {
+      pendingLines += CountLines(block.data(), block.data() + block.size());
+      pending.append(block);
+    }
+
+    if (pendingLines == 0)
+      return false;
+
+    // Find the end of the last line of the batch.
+    size_t end = pending.size();
+    if (pendingLines > batchSize)
+    {
+      end = 0;
+      for (size_t i = 0; i < batchSize; ++i)
+        end = pending.find('\n', end) + 1;
+    }
+
+    const size_t lines = std::min(pendingLines, batchSize);
+    batch.set_size(infoSet.Dimensionality(), lines);
+    ParseBlock(pending.data(), pending.data() + end, streamedLines, 0, batch,
+        infoSet, true);
+
+    pending.erase(0, end);
+    streamedLines += lines;
+
+    return true;
+  }
+
   /**
    * Peek at the file to determine the number of rows and columns in the matrix,
    * assuming a non-transposed matrix.  This will also take a first pass over
@@ -77,141 +177,449 @@ class LoadCSV
   template<typename T, typename MapPolicy>
   void GetMatrixSize(size_t& rows, size_t& cols, DatasetMapper<MapPolicy>& info)
   {
-    using namespace boost::spirit;
+    FirstPass<T>(rows, cols, info, false);
+  }
 
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
+  /**
+   * Peek at the file to determine the number of rows and columns in the matrix,
+   * assuming a transposed matrix.  This will also take a first pass over the
+   * data for DatasetMapper, if MapPolicy::NeedsFirstPass is true.  The info
+   * object will be re-initialized with the correct dimensionality.
+   *
+   * @param rows Variable to be filled with the number of rows.
+   * @param cols Variable to be filled with the number of columns.
+   * @param info DatasetMapper object to use for first pass.
+   */
+  template<typename T, typename MapPolicy>
+  void GetTransposeMatrixSize(size_t& rows,
+                              size_t& cols,
+                              DatasetMapper<MapPolicy>& info)
+  {
+    FirstPass<T>(cols, rows, info, true);
+  }
 
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
+  //! Get the number of bytes read from the file at a time.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of bytes read from the file at a time.
+  size_t& BlockSize() { return blockSize; }
 
-    // First, count the number of rows in the file (this is the dimensionality).
-    std::string line;
-    while (std::getline(inFile, line))
+ private:
+  using iter_type = boost::iterator_range<std::string::iterator>;
+
+  /**
+   * Check whether or not the file has successfully opened; throw an exception
+   * if not.
+   */
+  void CheckOpen();
+
+  //! Go back to the start of the file.
+  void Reset();
+
+  /**
+   * Read the next block of the file.  The block holds whole lines, unless the
+   * end of the file is reached; the rest of the last line is kept for the next
+   * block.
+   *
+   * @param block String to read the block into.
+   * @return false if there is nothing left to read.
+   */
+  bool ReadBlock(std::string& block);
+
+  /**
+   * Count the lines of the given text, in the same way that std::getline()
+   * would: a final line without a newline is counted too.
+   */
+  static size_t CountLines(const char* begin, const char* end);
+
+  /**
+   * Split the given text into chunks of whole lines to be parsed in parallel,
+   * and count the lines in each chunk.
+   *
+   * @param begin Start of the text.
+   * @param end End of the text.
+   * @param bounds Filled with the offset of each chunk, followed by the size
+   *     of the text.
+   * @param lines Filled with the index of the first line of each chunk,
+   *     followed by the number of lines in the text.
+   */
+  static void SplitChunks(const char* begin,
+                          const char* end,
+                          std::vector<size_t>& bounds,
+                          std::vector<size_t>& lines);
+
+  /**
+   * Call f(begin, end, index) for each line of the given text; stop if f
+   * returns false.
+   */
+  template<typename LineFunction>
+  static void ForEachLine(const char* begin,
+                          const char* end,
+                          LineFunction f)
+  {
+    size_t index = 0;
+    while (begin < end)
     {
-      ++rows;
+      const char* newline = (const char*) std::memchr(begin, '\n',
+          end - begin);
+      const char* lineEnd = (newline == NULL) ? end : newline;
+      if (!f(begin, lineEnd, index++))
+        return;
+
+      begin = (newline == NULL) ? end : newline + 1;
     }
-    info = DatasetMapper<MapPolicy>(rows);
+  }
 
-    // Now, jump back to the beginning of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
+  /**
+   * Parse one line with boost::spirit, and call f(str, field) for each field
+   * in it, after removing whitespace from either side.
+   *
+   * @param begin Start of the line.
+   * @param end End of the line.
+   * @param line String to hold the line while it is parsed.
+   * @param f Function to call for each field.
+   * @param canParse Set to false if the line could not be parsed.
+   * @return The number of fields in the line.
+   */
+  template<typename FieldFunction>
+  size_t ParseLine(const char* begin,
+                   const char* end,
+                   std::string& line,
+                   FieldFunction f,
+                   bool& canParse) const
+  {
+    using namespace boost::spirit;
+
+    // Remove whitespace from either side.
+    line.assign(begin, end);
+    boost::trim(line);
 
-    while (std::getline(inFile, line))
+    size_t fields = 0;
+    auto parseField = [&](iter_type const &iter)
     {
-      ++rows;
-      // Remove whitespace from either side.
-      boost::trim(line);
+      std::string str(iter.begin(), iter.end());
+      boost::trim(str);
+
+      f(str, fields++);
+    };
+
+    canParse = qi::parse(line.begin(), line.end(),
+        stringRule[parseField] % delimiterRule);
+    return fields;
+  }
 
-      if (rows == 1)
+  /**
+   * Take a pass through the file to count its lines and the fields of its
+   * first line.  If the DatasetMapper policy requires it, we will pass every
+   * string through MapFirstPass().  This might be useful if, e.g., the
+   * MapPolicy needs to find which dimensions are numeric or categorical.
+   *
+   * @param lines Variable to be filled with the number of lines.
+   * @param fields Variable to be filled with the number of fields in the first
+   *     line.
+   * @param info DatasetMapper object to use for first pass.
+   * @param transpose If true, each line is a point; otherwise, each line is a
+   *     dimension.
+   */
+  template<typename T, typename MapPolicy>
+  void FirstPass(size_t& lines,
+                 size_t& fields,
+                 DatasetMapper<MapPolicy>& info,
+                 const bool transpose)
+  {
+    Reset();
+    lines = 0;
+    fields = 0;
+
+    // If the file is transposed, we know the dimensionality after the first
+    // line, so the first pass for the DatasetMapper can be done while the
+    // lines are counted.  Otherwise, every line is a dimension, so the lines
+    // have to be counted first.
+    std::string block, line;
+    while (ReadBlock(block))
+    {
+      const char* begin = block.data();
+      const char* end = begin + block.size();
+      if (lines == 0)
       {
-        // Extract the number of columns.
-        auto findColSize = [&cols](iter_type) { ++cols; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findColSize] % delimiterRule);
+        // Extract the number of fields of the first line.
+        const char* lineEnd = (const char*) std::memchr(begin, '\n',
+            end - begin);
+        bool canParse;
+        fields = ParseLine(begin, (lineEnd == NULL) ? end : lineEnd, line,
+            [](std::string&, const size_t) { }, canParse);
+
+        if (transpose)
+          info.SetDimensionality(fields);
       }
 
-      // I guess this is technically a second pass, but that's ok... still the
-      // same idea...
+      lines += FirstPassBlock<T>(begin, end, lines, info, transpose,
+          transpose && MapPolicy::NeedsFirstPass);
+    }
+
+    if (!transpose)
+    {
+      info.SetDimensionality(lines);
       if (MapPolicy::NeedsFirstPass)
       {
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
+        Reset();
+        size_t firstLine = 0;
+        while (ReadBlock(block))
         {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), rows - 1);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
+          firstLine += FirstPassBlock<T>(block.data(),
+              block.data() + block.size(), firstLine, info, false, true);
+        }
       }
     }
   }
 
   /**
-   * Peek at the file to determine the number of rows and columns in the matrix,
-   * assuming a transposed matrix.  This will also take a first pass over the
-   * data for DatasetMapper, if MapPolicy::NeedsFirstPass is true.  The info
-   * object will be re-initialized with the correct dimensionality.
+   * Count the lines of one block, and if requested, pass every string in the
+   * block through MapFirstPass().  Each chunk of the block is passed to its
+   * own copy of the DatasetMapper in parallel, and the types of the
+   * dimensions found by the chunks are combined afterwards.
    *
-   * @param rows Variable to be filled with the number of rows.
-   * @param cols Variable to be filled with the number of columns.
+   * @param begin Start of the block.
+   * @param end End of the block.
+   * @param firstLine Index of the first line of the block in the file.
    * @param info DatasetMapper object to use for first pass.
+   * @param transpose If true, each line is a point.
+   * @param map If true, call MapFirstPass() for every string.
+   * @return The number of lines in the block.
    */
   template<typename T, typename MapPolicy>
-  void GetTransposeMatrixSize(size_t& rows,
-                              size_t& cols,
-                              DatasetMapper<MapPolicy>& info)
+  size_t FirstPassBlock(const char* begin,
+                        const char* end,
+                        const size_t firstLine,
+                        DatasetMapper<MapPolicy>& info,
+                        const bool transpose,
+                        const bool map)
   {
-    using namespace boost::spirit;
+    std::vector<size_t> bounds, lines;
+    SplitChunks(begin, end, bounds, lines);
+    const size_t numChunks = bounds.size() - 1;
+    if (!map)
+      return lines[numChunks];
+
+    std::vector<std::vector<Datatype>> types(numChunks);
 
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      MapPolicy policy(info.Policy());
+      DatasetMapper<MapPolicy> chunkInfo(policy, info.Dimensionality());
+
+      std::string line;
+      ForEachLine(begin + bounds[c], begin + bounds[c + 1],
+          [&](const char* lineBegin, const char* lineEnd, const size_t i)
+          {
+            const size_t dim = firstLine + lines[c] + i;
+            bool canParse;
+            ParseLine(lineBegin, lineEnd, line,
+                [&](std::string& str, const size_t field)
+                {
+                  chunkInfo.template MapFirstPass<T>(str,
+                      transpose ? field : dim);
+                }, canParse);
+            return true;
+          });
+
+      types[c].resize(info.Dimensionality());
+      for (size_t d = 0; d < types[c].size(); ++d)
+        types[c][d] = chunkInfo.Type(d);
+    }
+
+    // A dimension is categorical if any chunk found that it is.
+    for (size_t c = 0; c < numChunks; ++c)
+      for (size_t d = 0; d < types[c].size(); ++d)
+        if (types[c][d] == Datatype::categorical)
+          info.Type(d) = Datatype::categorical;
 
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
+    return lines[numChunks];
+  }
 
-    std::string line;
-    while (std::getline(inFile, line))
+  /**
+   * Parse one block of the file into the given matrix.  The chunks of the
+   * block are parsed in parallel, each with its own copy of the DatasetMapper;
+   * then the new mappings of each chunk are added to the DatasetMapper in
+   * order, and the values that the chunks mapped differently are fixed.
+   *
+   * @param begin Start of the block.
+   * @param end End of the block.
+   * @param firstLine Index of the first line of the block in the file.
+   * @param firstIndex Index in the matrix of the first line of the block.
+   * @param matrix Matrix to load into; it must already have the right size.
+   * @param info DatasetMapper object to load with.
+   * @param transpose If true, each line is a point.
+   * @return The number of lines in the block.
+   */
+  template<typename T, typename PolicyType>
+  size_t ParseBlock(const char* begin,
+                    const char* end,
+                    const size_t firstLine,
+                    const size_t firstIndex,
+                    arma::Mat<T>& matrix,
+                    DatasetMapper<PolicyType>& info,
+                    const bool transpose)
+  {
+    std::vector<size_t> bounds, lines;
+    SplitChunks(begin, end, bounds, lines);
+    const size_t numChunks = bounds.size() - 1;
+    const size_t fields = transpose ? matrix.n_rows : matrix.n_cols;
+    const char* function = transpose ? "LoadCSV::TransposeParse()" :
+        "LoadCSV::NonTransposeParse()";
+
+    // The mappings that each chunk created: dimension, string, and value.
+    typedef std::tuple<size_t, std::string, T> MappingType;
+    std::vector<std::vector<MappingType>> newMappings(numChunks);
+    std::vector<std::string> errors(numChunks);
+
+    // Exceptions can't leave the parallel region, so they are turned into
+    // errors too.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
     {
-      ++cols;
-      // Remove whitespace from either side.
-      boost::trim(line);
+      try
+      {
+        PolicyType policy(info.Policy());
+        DatasetMapper<PolicyType> chunkInfo(policy, info.Dimensionality());
+        for (size_t d = 0; d < info.Dimensionality(); ++d)
+          chunkInfo.Type(d) = info.Type(d);
+
+        std::string line;
+        ForEachLine(begin + bounds[c], begin + bounds[c + 1],
+            [&](const char* lineBegin, const char* lineEnd, const size_t i)
+            {
+              const size_t lineIndex = firstLine + lines[c] + i;
+              const size_t index = firstIndex + lines[c] + i;
+
+              bool canParse;
+              const size_t found = ParseLine(lineBegin, lineEnd, line,
+                  [&](std::string& str, const size_t field)
+                  {
+                    if (field >= fields)
+                      return;
+
+                    const size_t dim = transpose ? field : lineIndex;
+                    const size_t numMappings = chunkInfo.NumMappings(dim);
+                    const T value = chunkInfo.template MapString<T>(str, dim);
+                    if (chunkInfo.NumMappings(dim) != numMappings)
+                      newMappings[c].push_back(MappingType(dim, str, value));
+
+                    if (transpose)
+                      matrix(field, index) = value;
+                    else
+                      matrix(index, field) = value;
+                  }, canParse);
+
+              // Make sure we got the right number of fields.
+              if (found == fields && canParse)
+                return true;
+
+              std::ostringstream oss;
+              if (found != fields)
+              {
+                oss << function << ": wrong number of dimensions (" << found
+                    << ") on line " << lineIndex << "; should be " << fields
+                    << " dimensions.";
+              }
+              else
+              {
+                oss << function << ": parsing error on line " << lineIndex
+                    << "!";
+              }
+
+              errors[c] = oss.str();
+              return false;
+            });
+      }
+      catch (std::exception& e)
+      {
+        errors[c] = e.what();
+      }
+    }
+
+    // Report the first error in the file, if there was one.
+    for (size_t c = 0; c < numChunks; ++c)
+      if (!errors[c].empty())
+        throw std::runtime_error(errors[c]);
 
-      if (cols == 1)
+    // Now add the mappings of each chunk, in order, and find the values that
+    // the chunk mapped differently.
+    std::vector<std::unordered_map<size_t, std::unordered_map<T, T>>>
+        remap(numChunks);
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      for (size_t m = 0; m < newMappings[c].size(); ++m)
       {
-        // Extract the number of dimensions.
-        auto findRowSize = [&rows](iter_type) { ++rows; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findRowSize] % delimiterRule);
+        const size_t dim = std::get<0>(newMappings[c][m]);
+        const T value = std::get<2>(newMappings[c][m]);
+        const T infoValue = info.template MapString<T>(
+            std::get<1>(newMappings[c][m]), dim);
 
-        // Now that we know the dimensionality, initialize the DatasetMapper.
-        info.SetDimensionality(rows);
+        if (value != infoValue && !(isnanSafe(value) && isnanSafe(infoValue)))
+          remap[c][dim][value] = infoValue;
       }
+    }
 
-      // If we need to do a first pass for the DatasetMapper, do it.
-      if (MapPolicy::NeedsFirstPass)
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+    {
+      if (remap[c].empty())
+        continue;
+
+      auto remapValue = [](T& value, const std::unordered_map<T, T>& values)
       {
-        size_t dim = 0;
+        const auto it = values.find(value);
+        if (it != values.end())
+          value = it->second;
+      };
 
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
+      for (size_t i = lines[c]; i < lines[c + 1]; ++i)
+      {
+        const size_t index = firstIndex + i;
+        if (transpose)
         {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), dim++);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
+          for (auto& dim : remap[c])
+            remapValue(matrix(dim.first, index), dim.second);
+        }
+        else
+        {
+          // In the non-transposed case, the line is a single dimension.
+          const auto dim = remap[c].find(firstLine + i);
+          if (dim == remap[c].end())
+            continue;
+
+          for (size_t field = 0; field < fields; ++field)
+            remapValue(matrix(index, field), dim->second);
+        }
       }
     }
-  }
 
- private:
-  using iter_type = boost::iterator_range<std::string::iterator>;
+    return lines[numChunks];
+  }
 
   /**
-   * Check whether or not the file has successfully opened; throw an exception
-   * if not.
+   * Parse the whole file into the given matrix, which must already have the
+   * right size.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper object to load with.
+   * @param transpose If true, each line is a point.
    */
-  void CheckOpen();
+  template<typename T, typename PolicyType>
+  void Parse(arma::Mat<T>& inout,
+             DatasetMapper<PolicyType>& infoSet,
+             const bool transpose)
+  {
+    Reset();
+    size_t line = 0;
+    std::string block;
+    while (ReadBlock(block))
+    {
+      line += ParseBlock(block.data(), block.data() + block.size(), line, line,
+          inout, infoSet, transpose);
+    }
+  }
 
   /**
    * Parse a non-transposed matrix.
@@ -223,64 +631,13 @@ class LoadCSV
   void NonTransposeParse(arma::Mat<T>& inout,
                          DatasetMapper<PolicyType>& infoSet)
   {
-    using namespace boost::spirit;
-
     // Get the size of the matrix.
     size_t rows, cols;
     GetMatrixSize<T>(rows, cols, infoSet);
 
     // Set up output matrix.
     inout.set_size(rows, cols);
-    size_t row = 0;
-    size_t col = 0;
-
-    // Reset file position.
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    auto setCharClass = [&](iter_type const &iter)
-    {
-      std::string str(iter.begin(), iter.end());
-      if (str == "\t")
-      {
-        str.clear();
-      }
-      boost::trim(str);
-
-      inout(row, col++) = infoSet.template MapString<T>(std::move(str), row);
-    };
-
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Parse the numbers from a line (ex: 1,2,3,4); if the parser finds a
-      // number it will execute the setNum function.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[setCharClass] % delimiterRule);
-
-      // Make sure we got the right number of rows.
-      if (col != cols)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): wrong number of dimensions ("
-            << col << ") on line " << row << "; should be " << cols
-            << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
-
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
-
-      ++row; col = 0;
-    }
+    Parse(inout, infoSet, false);
   }
 
   /**
@@ -292,69 +649,13 @@ class LoadCSV
   template<typename T, typename PolicyType>
   void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet)
   {
-    using namespace boost::spirit;
-
     // Get matrix size.  This also initializes infoSet correctly.
     size_t rows, cols;
     GetTransposeMatrixSize<T>(rows, cols, infoSet);
 
     // Set the matrix size.
     inout.set_size(rows, cols);
-
-    // Initialize auxiliary variables.
-    size_t row = 0;
-    size_t col = 0;
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    /**
-     * This is the parse rule for strings.  When we get a string we have to pass
-     * it to the DatasetMapper.
-     */
-    auto parseString = [&](iter_type const &iter)
-    {
-      // All parsed values must be mapped.
-      std::string str(iter.begin(), iter.end());
-      boost::trim(str);
-
-      inout(row, col) = infoSet.template MapString<T>(std::move(str), row);
-      ++row;
-    };
-
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Reset the row we are looking at.  (Remember this is transposed.)
-      row = 0;
-
-      // Now use boost::spirit to parse the characters of the line;
-      // parseString() will be called when a token is detected.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[parseString] % delimiterRule);
-
-      // Make sure we got the right number of rows.
-      if (row != rows)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): wrong number of dimensions (" << row
-            << ") on line " << col << "; should be " << rows << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
-
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
-
-      // Increment the column index.
-      ++col;
-    }
+    Parse(inout, infoSet, true);
   }
 
   //! Spirit rule for parsing.
@@ -368,6 +669,18 @@ class LoadCSV
   std::string filename;
   //! Opened stream for reading.
   std::ifstream inFile;
+
+  //! Number of bytes read from the file at a time.
+  size_t blockSize;
+  //! The start of a line that did not fit in the last block that was read.
+  std::string carry;
+
+  //! If true, NextBatch() has already taken the first pass.
+  bool streaming;
+  //! Lines read by NextBatch() that were not returned yet.
+  std::string pending;
+  //! Number of lines returned by NextBatch() so far.
+  size_t streamedLines;
 };
 
 } // namespace data
@@ -0,0 +1,267 @@
+/**
+ * @file core/data/mapped_file.cpp
+ *
+ * Implementation of the MappedFile class and of the non-templated load
+ * function for mapped files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_file.hpp"
+
+#include <limits>
+#include <sstream>
+
+#ifdef _WIN32
+  #include <fstream>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+MappedFile::MappedFile(const std::string& filename) :
+    filename(filename),
+    data(NULL),
+    size(0),
+    mapped(false)
+{
+#ifdef _WIN32
+  // There is no mmap(), so read the whole file.  It is read into 64-bit words
+  // so that the sections of the file are aligned.
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("MappedFile: cannot open file '" + filename +
+        "'!");
+  }
+
+  stream.seekg(0, std::ios::end);
+  size = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  char* memory = (char*) new uint64_t[(size + 7) / 8];
+  data = memory;
+  stream.read(memory, size);
+  if (stream.fail())
+  {
+    delete[] (uint64_t*) data;
+    throw std::runtime_error("MappedFile: cannot read file '" + filename +
+        "'!");
+  }
+#else
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error("MappedFile: cannot open file '" + filename +
+        "'!");
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("MappedFile: cannot get size of file '" +
+        filename + "'!");
+  }
+  size = (size_t) info.st_size;
+
+  // The mapping is read-only, and its pages are shared with every other
+  // process that maps the file.
+  void* memory = MAP_FAILED;
+  if (size > 0)
+    memory = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (memory == MAP_FAILED)
+  {
+    throw std::runtime_error("MappedFile: cannot map file '" + filename +
+        "'!");
+  }
+
+  data = (const char*) memory;
+  mapped = true;
+#endif
+
+  try
+  {
+    CheckHeader();
+    if (Header().numNodes > 0)
+      CheckTree();
+  }
+  catch (...)
+  {
+#ifdef _WIN32
+    delete[] (const uint64_t*) data;
+#else
+    munmap((void*) data, size);
+#endif
+    throw;
+  }
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+  delete[] (const uint64_t*) data;
+#else
+  if (mapped)
+    munmap((void*) data, size);
+#endif
+}
+
+/**
+ * Return true if a section of numElements elements of elemSize bytes each,
+ * starting at the given offset and aligned like a double, lies within a file
+ * of the given size.  Sizes that overflow are never valid.
+ */
+static bool SectionFits(const uint64_t offset,
+                        const uint64_t numElements,
+                        const uint64_t elemSize,
+                        const uint64_t fileSize)
+{
+  if (offset % sizeof(double) != 0 || offset > fileSize)
+    return false;
+
+  return (elemSize == 0) || (numElements <= (fileSize - offset) / elemSize);
+}
+
+/**
+ * Multiply a and b into product, and return false if the product overflows.
+ */
+static bool SafeMultiply(const uint64_t a, const uint64_t b, uint64_t& product)
+{
+  if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a)
+    return false;
+
+  product = a * b;
+  return true;
+}
+
+void MappedFile::CheckHeader() const
+{
+  if (size < sizeof(MappedHeader) ||
+      std::memcmp(Header().magic, "MLPACKMM", 8) != 0)
+  {
+    throw std::runtime_error("MappedFile: '" + filename + "' is not a mapped "
+        "matrix or tree file!");
+  }
+
+  const MappedHeader& header = Header();
+  if (header.version != 1)
+  {
+    std::ostringstream oss;
+    oss << "MappedFile: '" << filename << "' has unknown version "
+        << header.version << "!";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Make sure that every section lies within the file, without overflowing
+  // while computing the sizes of the sections.
+  uint64_t numElements = 0;
+  bool valid = SafeMultiply(header.nRows, header.nCols, numElements) &&
+      SectionFits(header.dataOffset, numElements, header.elemSize, size);
+  if (header.numNodes > 0)
+  {
+    uint64_t numBounds = 0;
+    valid = valid &&
+        SectionFits(header.nodeOffset, header.numNodes, sizeof(MappedNode),
+            size) &&
+        SafeMultiply(header.numNodes, header.nRows, numBounds) &&
+        SectionFits(header.boundOffset, numBounds, 2 * sizeof(double), size);
+  }
+  if (header.oldFromNewOffset > 0)
+  {
+    valid = valid && SectionFits(header.oldFromNewOffset, header.nCols,
+        sizeof(uint64_t), size);
+  }
+
+  if (!valid)
+  {
+    throw std::runtime_error("MappedFile: '" + filename + "' is truncated or "
+        "corrupt!");
+  }
+}
+
+void MappedFile::CheckTree() const
+{
+  const MappedHeader& header = Header();
+  const MappedNode* nodes = (const MappedNode*) (data + header.nodeOffset);
+  const uint64_t numNodes = header.numNodes;
+
+  // Every node but the root must be the child of exactly one node before it,
+  // so that the nodes form a tree, and the two children of a node must split
+  // its points in two.  Then a tree can be rebuilt from the nodes without
+  // reading outside of the file.
+  std::vector<bool> isChild(numNodes, false);
+  for (uint64_t i = 0; i < numNodes; ++i)
+  {
+    const MappedNode& node = nodes[i];
+    bool valid = (i == 0) ? (node.begin == 0 && node.count == header.nCols) :
+        isChild[i];
+
+    if ((node.left == 0) != (node.right == 0))
+    {
+      valid = false;
+    }
+    else if (valid && node.left != 0)
+    {
+      valid = (node.left > i) && (node.left < numNodes) &&
+          (node.right > i) && (node.right < numNodes) &&
+          (node.left != node.right) && !isChild[node.left] &&
+          !isChild[node.right];
+      if (valid)
+      {
+        isChild[node.left] = true;
+        isChild[node.right] = true;
+
+        const MappedNode& left = nodes[node.left];
+        const MappedNode& right = nodes[node.right];
+        valid = (left.begin == node.begin) && (left.count <= node.count) &&
+            (right.begin == node.begin + left.count) &&
+            (right.count == node.count - left.count);
+      }
+    }
+
+    if (!valid)
+    {
+      std::ostringstream oss;
+      oss << "MappedFile: node " << i << " of the tree in '" << filename
+          << "' is invalid!";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
+bool LoadMapped(const MappedFile& file,
+                std::vector<size_t>& oldFromNew,
+                const bool fatal)
+{
+  const MappedHeader& header = file.Header();
+  if (header.oldFromNewOffset == 0)
+  {
+    if (fatal)
+      Log::Fatal << "'" << file.Filename() << "' does not hold a mapping of "
+          << "point indices!" << std::endl;
+    else
+      Log::Warn << "'" << file.Filename() << "' does not hold a mapping of "
+          << "point indices; load failed." << std::endl;
+
+    return false;
+  }
+
+  const uint64_t* mapping = (const uint64_t*) (file.Data() +
+      header.oldFromNewOffset);
+  oldFromNew.assign(mapping, mapping + header.nCols);
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,224 @@
+/**
+ * @file core/data/mapped_file.hpp
+ *
+ * Memory-mapped matrix and tree files.  A mapped file holds a raw column-major
+ * matrix, and optionally the nodes of a tree built on that matrix, so that it
+ * can be opened without any parsing and without copying the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/log.hpp>
+#include <cstdint>
+#include <string>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header at the start of a memory-mapped file.  All offsets are in bytes
+ * from the start of the file, and each section starts on a 64-byte boundary.
+ *
+ *  - The matrix is stored in column-major order at dataOffset.
+ *  - If numNodes is not 0, the file holds a tree: numNodes MappedNode objects
+ *    are stored at nodeOffset (the root is node 0), and the bounds of the
+ *    nodes are stored at boundOffset as 2 * nRows doubles per node (the lower
+ *    and upper bound in each dimension).
+ *  - If oldFromNewOffset is not 0, nCols 64-bit integers are stored there,
+ *    giving the index of each point in the matrix before the tree was built.
+ *
+ * The file is in the byte order of the machine that wrote it.
+ */
+struct MappedHeader
+{
+  //! Always "MLPACKMM".
+  char magic[8];
+  //! Version of the file format.
+  uint64_t version;
+  //! Size of each element of the matrix, in bytes.
+  uint64_t elemSize;
+  //! Number of rows of the matrix.
+  uint64_t nRows;
+  //! Number of columns of the matrix.
+  uint64_t nCols;
+  //! Offset of the matrix.
+  uint64_t dataOffset;
+  //! Number of tree nodes (0 if there is no tree).
+  uint64_t numNodes;
+  //! Offset of the tree nodes.
+  uint64_t nodeOffset;
+  //! Offset of the bounds of the tree nodes.
+  uint64_t boundOffset;
+  //! Offset of the mapping of point indices (0 if there is none).
+  uint64_t oldFromNewOffset;
+};
+
+/**
+ * One node of a tree in a memory-mapped file.  Children are given as indices
+ * into the node array; since the root is node 0, an index of 0 means that
+ * there is no child.
+ */
+struct MappedNode
+{
+  //! Index of the first point held by the node.
+  uint64_t begin;
+  //! Number of points held by the node.
+  uint64_t count;
+  //! Index of the left child, or 0.
+  uint64_t left;
+  //! Index of the right child, or 0.
+  uint64_t right;
+  //! Distance from the center of the node to the center of its parent.
+  double parentDistance;
+  //! Furthest distance from the center of the node to a descendant point.
+  double furthestDescendantDistance;
+  //! Minimum distance from the center of the node to the edge of its bound.
+  double minimumBoundDistance;
+  //! Minimum width of the bound of the node.
+  double minWidth;
+};
+
+/**
+ * A MappedFile maps a file written by data::SaveMapped() into memory,
+ * read-only.  The pages of the file are shared by every process that maps it,
+ * and nothing is read until it is used.  Matrices and trees loaded from the
+ * file with Matrix() or the mapped-file constructor of BinarySpaceTree point
+ * directly into the mapped memory, so the MappedFile must outlive them.
+ *
+ * The mapped memory can't be written to, so the matrices and datasets of trees
+ * that point into the file must not be modified.  On platforms without mmap(),
+ * the file is read into memory instead.
+ *
+ * When the file is opened, its header and (if it holds a tree) its node array
+ * are checked, so that a corrupt or truncated file gives an error instead of
+ * reads outside of the file.
+ *
+ * @code
+ * data::MappedFile file("reference.mm");
+ * KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+ *     arma::mat> tree(file);
+ * KNN knn(std::move(tree));
+ * @endcode
+ */
+class MappedFile
+{
+ public:
+  /**
+   * Map the given file.  A std::runtime_error is thrown if the file cannot be
+   * opened or if it is not a valid mapped file.
+   *
+   * @param filename Name of file to map.
+   */
+  MappedFile(const std::string& filename);
+
+  //! Unmap the file.
+  ~MappedFile();
+
+  //! Copying a mapped file is not allowed.
+  MappedFile(const MappedFile& other) = delete;
+  //! Copying a mapped file is not allowed.
+  MappedFile& operator=(const MappedFile& other) = delete;
+
+  //! Get the name of the mapped file.
+  const std::string& Filename() const { return filename; }
+  //! Get the header of the file.
+  const MappedHeader& Header() const
+  { return *reinterpret_cast<const MappedHeader*>(data); }
+  //! Get the contents of the file.
+  const char* Data() const { return data; }
+  //! Get the size of the file, in bytes.
+  size_t Size() const { return size; }
+
+  /**
+   * Return the matrix stored in the file.  The matrix is a strict alias of the
+   * mapped memory: no data is copied, and the matrix can't be resized.  It
+   * must not be modified, and the MappedFile must outlive it.  A
+   * std::invalid_argument is thrown if the element type does not match the
+   * file.
+   *
+   * @code
+   * data::MappedFile file("reference.mm");
+   * const arma::mat reference = file.Matrix<double>();
+   * @endcode
+   *
+   * @tparam eT Element type of the matrix.
+   */
+  template<typename eT>
+  arma::Mat<eT> Matrix() const;
+
+ private:
+  //! Check the header of the file, and throw if it is invalid.
+  void CheckHeader() const;
+  //! Check the node array of the file, and throw if it is not a valid tree.
+  void CheckTree() const;
+
+  //! The name of the file.
+  std::string filename;
+  //! The contents of the file.
+  const char* data;
+  //! The size of the file.
+  size_t size;
+  //! If true, data was mapped with mmap(); otherwise, it was allocated.
+  bool mapped;
+};
+
+/**
+ * Save a matrix to a memory-mapped file, which can be opened with MappedFile
+ * and loaded without a copy with MappedFile::Matrix().  The matrix is not
+ * transposed.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Matrix to save.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal = false);
+
+/**
+ * Save a tree and its dataset to a memory-mapped file.  The tree can then be
+ * loaded without a copy of the dataset with the mapped-file constructor of
+ * the tree.  Currently this is only supported for BinarySpaceTrees with an
+ * HRectBound (such as the KDTree).
+ *
+ * @param filename Name of file to save to.
+ * @param tree Root of the tree to save.
+ * @param oldFromNew Mapping from the points of the tree to the original
+ *     indices of the points, as returned by the tree constructor; this may be
+ *     empty.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename TreeType>
+bool SaveMapped(const std::string& filename,
+                const TreeType& tree,
+                const std::vector<size_t>& oldFromNew,
+                const bool fatal = false);
+
+/**
+ * Load the mapping from the points of a saved tree to their original indices.
+ *
+ * @param file Mapped file to load from.
+ * @param oldFromNew Vector to load the mapping into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+bool LoadMapped(const MappedFile& file,
+                std::vector<size_t>& oldFromNew,
+                const bool fatal = false);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_file_impl.hpp"
+
+#endif
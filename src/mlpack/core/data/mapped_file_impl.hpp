@@ -0,0 +1,231 @@
+/**
+ * @file core/data/mapped_file_impl.hpp
+ *
+ * Implementation of the templated functions to save and load memory-mapped
+ * files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "mapped_file.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace mlpack {
+namespace data {
+
+//! Round the given offset up to the alignment of sections in a mapped file.
+inline uint64_t MappedAlign(const uint64_t offset)
+{
+  return (offset + 63) / 64 * 64;
+}
+
+//! Write zeros to the given stream until it is at the given offset.
+inline void MappedPad(std::ostream& stream, const uint64_t offset)
+{
+  const uint64_t position = (uint64_t) stream.tellp();
+  const std::vector<char> zeros(offset - position, 0);
+  stream.write(zeros.data(), zeros.size());
+}
+
+//! Fill a header for a matrix with the given size.
+template<typename eT>
+MappedHeader MappedMatrixHeader(const size_t nRows, const size_t nCols)
+{
+  MappedHeader header;
+  std::memset(&header, 0, sizeof(MappedHeader));
+  std::memcpy(header.magic, "MLPACKMM", 8);
+  header.version = 1;
+  header.elemSize = sizeof(eT);
+  header.nRows = nRows;
+  header.nCols = nCols;
+  header.dataOffset = MappedAlign(sizeof(MappedHeader));
+
+  return header;
+}
+
+//! Open the given file for writing a mapped file.
+inline bool OpenMapped(const std::string& filename,
+                       std::ofstream& stream,
+                       const bool fatal)
+{
+  stream.open(filename.c_str(), std::ofstream::out | std::ofstream::binary);
+  if (!stream.is_open())
+  {
+    if (fatal)
+      Log::Fatal << "Cannot open file '" << filename << "' for writing. "
+          << "Save failed." << std::endl;
+    else
+      Log::Warn << "Cannot open file '" << filename << "' for writing; save "
+          << "failed." << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+//! Report whether writing the given stream was successful.
+inline bool CloseMapped(const std::string& filename,
+                        std::ofstream& stream,
+                        const bool fatal)
+{
+  stream.close();
+  if (stream.fail())
+  {
+    if (fatal)
+      Log::Fatal << "Writing to '" << filename << "' failed." << std::endl;
+    else
+      Log::Warn << "Writing to '" << filename << "' failed." << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal)
+{
+  std::ofstream stream;
+  if (!OpenMapped(filename, stream, fatal))
+    return false;
+
+  const MappedHeader header = MappedMatrixHeader<eT>(matrix.n_rows,
+      matrix.n_cols);
+  stream.write((const char*) &header, sizeof(MappedHeader));
+  MappedPad(stream, header.dataOffset);
+  stream.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+
+  return CloseMapped(filename, stream, fatal);
+}
+
+template<typename TreeType>
+bool SaveMapped(const std::string& filename,
+                const TreeType& tree,
+                const std::vector<size_t>& oldFromNew,
+                const bool fatal)
+{
+  typedef typename TreeType::ElemType ElemType;
+  const typename TreeType::Mat& dataset = tree.Dataset();
+
+  if (!oldFromNew.empty() && oldFromNew.size() != dataset.n_cols)
+  {
+    if (fatal)
+      Log::Fatal << "SaveMapped(): size of oldFromNew (" << oldFromNew.size()
+          << ") does not match the number of points (" << dataset.n_cols
+          << ")!" << std::endl;
+    else
+      Log::Warn << "SaveMapped(): size of oldFromNew (" << oldFromNew.size()
+          << ") does not match the number of points (" << dataset.n_cols
+          << "); save failed." << std::endl;
+
+    return false;
+  }
+
+  // Flatten the tree in breadth-first order, so that the index of each child
+  // is known when its parent is written.
+  std::vector<const TreeType*> nodes(1, &tree);
+  std::vector<MappedNode> mappedNodes;
+  std::vector<double> bounds;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const TreeType& node = *nodes[i];
+
+    MappedNode mappedNode;
+    mappedNode.begin = node.Begin();
+    mappedNode.count = node.Count();
+    mappedNode.left = 0;
+    mappedNode.right = 0;
+    if (node.Left())
+    {
+      mappedNode.left = nodes.size();
+      nodes.push_back(node.Left());
+    }
+    if (node.Right())
+    {
+      mappedNode.right = nodes.size();
+      nodes.push_back(node.Right());
+    }
+    mappedNode.parentDistance = node.ParentDistance();
+    mappedNode.furthestDescendantDistance = node.FurthestDescendantDistance();
+    mappedNode.minimumBoundDistance = node.MinimumBoundDistance();
+    mappedNode.minWidth = node.Bound().MinWidth();
+    mappedNodes.push_back(mappedNode);
+
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+    {
+      bounds.push_back(node.Bound()[d].Lo());
+      bounds.push_back(node.Bound()[d].Hi());
+    }
+  }
+
+  MappedHeader header = MappedMatrixHeader<ElemType>(dataset.n_rows,
+      dataset.n_cols);
+  header.numNodes = mappedNodes.size();
+  header.nodeOffset = MappedAlign(header.dataOffset +
+      dataset.n_elem * sizeof(ElemType));
+  header.boundOffset = MappedAlign(header.nodeOffset +
+      mappedNodes.size() * sizeof(MappedNode));
+  if (!oldFromNew.empty())
+  {
+    header.oldFromNewOffset = MappedAlign(header.boundOffset +
+        bounds.size() * sizeof(double));
+  }
+
+  std::ofstream stream;
+  if (!OpenMapped(filename, stream, fatal))
+    return false;
+
+  stream.write((const char*) &header, sizeof(MappedHeader));
+  MappedPad(stream, header.dataOffset);
+  stream.write((const char*) dataset.memptr(),
+      dataset.n_elem * sizeof(ElemType));
+  MappedPad(stream, header.nodeOffset);
+  stream.write((const char*) mappedNodes.data(),
+      mappedNodes.size() * sizeof(MappedNode));
+  MappedPad(stream, header.boundOffset);
+  stream.write((const char*) bounds.data(), bounds.size() * sizeof(double));
+  if (!oldFromNew.empty())
+  {
+    const std::vector<uint64_t> mapping(oldFromNew.begin(), oldFromNew.end());
+    MappedPad(stream, header.oldFromNewOffset);
+    stream.write((const char*) mapping.data(),
+        mapping.size() * sizeof(uint64_t));
+  }
+
+  return CloseMapped(filename, stream, fatal);
+}
+
+template<typename eT>
+arma::Mat<eT> MappedFile::Matrix() const
+{
+  const MappedHeader& header = Header();
+  if (header.elemSize != sizeof(eT))
+  {
+    std::ostringstream oss;
+    oss << "MappedFile::Matrix(): the elements of the matrix in '" << filename
+        << "' have size " << header.elemSize << ", not " << sizeof(eT) << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The matrix is a strict alias of the mapped memory, so it can never be
+  // resized or reallocated.  Returning it moves the alias, without a copy.
+  eT* memory = (eT*) (data + header.dataOffset);
+  return arma::Mat<eT>(memory, header.nRows, header.nCols, false, true);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -110,17 +110,13 @@ class GaussianDistribution
     // Column i of 'diffs' is the difference between x.col(i) and the mean.
     arma::mat diffs = x;
     diffs.each_col() -= mean;
-    // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1
-    // * diffs).  We just don't need any of the other elements.  We can
-    // calculate the right hand part of the equation (instead of the left side)
-    // so that later we are referencing columns, not rows -- that is faster.
-    const arma::mat rhs = -0.5 * invCov * diffs;
-    arma::vec logExponents(diffs.n_cols); // We will now fill this.
-    for (size_t i = 0; i < diffs.n_cols; ++i)
-      logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
-
-    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov +
-      logExponents;
+    // The Mahalanobis distance of each column is the squared norm of
+    // L^-1 * diffs, where L is the Cholesky factor of the covariance.  One
+    // triangular solve for all of the columns is cheaper than multiplying by
+    // the inverse covariance.
+    const arma::mat whitened = arma::solve(arma::trimatl(covLower), diffs);
+    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov -
+        0.5 * arma::sum(arma::square(whitened), 0).t();
   }
 
   /**
@@ -13,8 +13,11 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/core/data/mapped_file.hpp>
 #include "../statistic.hpp"
+#include "../node_arena.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -32,6 +35,12 @@ namespace tree /** Trees and tree-building procedures. */ {
  * This tree does take one runtime parameter in the constructor, which is the
  * max leaf size to be used.
  *
+ * When the tree is built from a dataset, all of its nodes are allocated from a
+ * NodeArena owned by the root, so that the nodes lie in (usually) one
+ * contiguous block of memory.  If OpenMP is available, the children of large
+ * nodes are built in parallel, unless the SplitTraits of the SplitType say that
+ * this is not possible.
+ *
  * @tparam MetricType The metric used for tree-building.  The BoundType may
  *     place restrictions on the metrics that can be used.
  * @tparam StatisticType Extra data contained in the node.  See statistic.hpp
@@ -88,6 +97,17 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! The arena that the descendants of this node are allocated from, or NULL
+  //! if they are allocated individually.
+  NodeArena<BinarySpaceTree>* arena;
+  //! If true, this node owns the arena and must delete it.
+  bool ownsArena;
+  //! If true, this node was allocated from an arena (so it must not be freed
+  //! with delete).
+  bool inArena;
+
+  //! Nodes with at least this many points build their children in parallel.
+  static const size_t ParallelBuildCutoff = 10000;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -196,6 +216,20 @@ class BinarySpaceTree
                   std::vector<size_t>& newFromOld,
                   const size_t maxLeafSize = 20);
 
+  /**
+   * Construct this as the root node of a binary space tree that was saved to a
+   * memory-mapped file with data::SaveMapped().  The dataset of the tree uses
+   * the memory of the file, so it is not copied, and the file must stay mapped
+   * while the tree is used.  The nodes are rebuilt from the node array of the
+   * file without any splitting.  Only trees with an HRectBound can be loaded
+   * this way.  The mapped memory is read-only, so the dataset of the tree must
+   * not be modified.  The mapping of point indices can be loaded with
+   * data::LoadMapped().
+   *
+   * @param file Mapped file holding the tree.
+   */
+  BinarySpaceTree(const data::MappedFile& file);
+
   /**
    * Construct this node as a child of the given parent, starting at column
    * begin and using count points.  The ordering of that subset of points in the
@@ -508,6 +542,46 @@ class BinarySpaceTree
   void Center(arma::vec& center) const { bound.Center(center); }
 
  private:
+  /**
+   * Build the tree below this root node.  This allocates the node arena, and
+   * then splits the node recursively (in parallel, if OpenMP is available).
+   *
+   * @param oldFromNew Vector holding permuted indices, or NULL if the mapping
+   *     is not needed.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   */
+  void BuildTree(std::vector<size_t>* oldFromNew, const size_t maxLeafSize);
+
+  /**
+   * Create a new child node, in the arena if there is one.  The arguments are
+   * passed to the constructor of the child.
+   */
+  template<typename... Args>
+  BinarySpaceTree* NewChild(Args&&... args);
+
+  /**
+   * Free the children of this node (and the arena, if this node owns it).
+   */
+  void DeleteChildren();
+
+  /**
+   * Construct this node as a child of the given parent from the given node of
+   * a memory-mapped tree file.
+   *
+   * @param parent Parent of this node.
+   * @param file Mapped file holding the tree.
+   * @param index Index of this node in the node array of the file.
+   */
+  BinarySpaceTree(BinarySpaceTree* parent,
+                  const data::MappedFile& file,
+                  const size_t index);
+
+  /**
+   * Fill this node and (recursively) its children from the given node of a
+   * memory-mapped tree file.
+   */
+  void LoadMappedNode(const data::MappedFile& file, const size_t index);
+
   /**
    * Splits the current node, assigning its left and right children recursively.
    *
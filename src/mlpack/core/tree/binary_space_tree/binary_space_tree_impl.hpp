@@ -39,11 +39,13 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(NULL),
+    ownsArena(false),
+    inArena(false)
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  BuildTree(NULL, maxLeafSize);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -67,7 +69,10 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(NULL),
+    ownsArena(false),
+    inArena(false)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -75,8 +80,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  BuildTree(&oldFromNew, maxLeafSize);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -101,7 +105,10 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    arena(NULL),
+    ownsArena(false),
+    inArena(false)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -109,8 +116,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  BuildTree(&oldFromNew, maxLeafSize);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -136,11 +142,13 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(NULL),
+    ownsArena(false),
+    inArena(false)
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  BuildTree(NULL, maxLeafSize);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -164,7 +172,10 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(NULL),
+    ownsArena(false),
+    inArena(false)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -172,8 +183,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  BuildTree(&oldFromNew, maxLeafSize);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -198,7 +208,10 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    arena(NULL),
+    ownsArena(false),
+    inArena(false)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -206,8 +219,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  BuildTree(&oldFromNew, maxLeafSize);
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -237,7 +249,10 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    arena(parent->arena), // Use the parent's arena for our children.
+    ownsArena(false),
+    inArena(false)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -266,7 +281,10 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    arena(parent->arena),
+    ownsArena(false),
+    inArena(false)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -300,7 +318,10 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    arena(parent->arena),
+    ownsArena(false),
+    inArena(false)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -318,6 +339,115 @@ BinarySpaceTree(
     newFromOld[oldFromNew[i]] = i;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(const data::MappedFile& file) :
+    left(NULL),
+    right(NULL),
+    parent(NULL),
+    begin(0),
+    count(0),
+    bound(file.Header().nRows),
+    dataset(NULL),
+    arena(NULL),
+    ownsArena(false),
+    inArena(false)
+{
+  const data::MappedHeader& header = file.Header();
+  if (header.numNodes == 0)
+  {
+    throw std::invalid_argument("BinarySpaceTree::BinarySpaceTree(): '" +
+        file.Filename() + "' does not hold a tree!");
+  }
+  if (header.elemSize != sizeof(ElemType))
+  {
+    throw std::invalid_argument("BinarySpaceTree::BinarySpaceTree(): the "
+        "element type of the dataset in '" + file.Filename() + "' does not "
+        "match the element type of the tree!");
+  }
+
+  // The dataset is a strict alias of the mapped memory, which is read-only.
+  ElemType* memory = (ElemType*) (file.Data() + header.dataOffset);
+  dataset = new MatType(memory, header.nRows, header.nCols, false, true);
+
+  // MappedFile checked when it was opened that the nodes form a tree whose
+  // point ranges lie within the dataset, with children after their parents, so
+  // exactly numNodes - 1 children are built here.
+  if (header.numNodes > 1)
+  {
+    arena = new NodeArena<BinarySpaceTree>(header.numNodes - 1);
+    ownsArena = true;
+  }
+
+  LoadMappedNode(file, 0);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    BinarySpaceTree* parent,
+    const data::MappedFile& file,
+    const size_t index) :
+    left(NULL),
+    right(NULL),
+    parent(parent),
+    begin(0),
+    count(0),
+    bound(parent->Dataset().n_rows),
+    dataset(&parent->Dataset()),
+    arena(parent->arena),
+    ownsArena(false),
+    inArena(false)
+{
+  LoadMappedNode(file, index);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+LoadMappedNode(const data::MappedFile& file, const size_t index)
+{
+  const data::MappedHeader& header = file.Header();
+  const data::MappedNode& node = ((const data::MappedNode*)
+      (file.Data() + header.nodeOffset))[index];
+  const double* nodeBounds = ((const double*) (file.Data() +
+      header.boundOffset)) + 2 * header.nRows * index;
+
+  begin = node.begin;
+  count = node.count;
+  parentDistance = node.parentDistance;
+  furthestDescendantDistance = node.furthestDescendantDistance;
+  minimumBoundDistance = node.minimumBoundDistance;
+  for (size_t d = 0; d < header.nRows; ++d)
+  {
+    bound[d].Lo() = nodeBounds[2 * d];
+    bound[d].Hi() = nodeBounds[2 * d + 1];
+  }
+  bound.MinWidth() = node.minWidth;
+
+  if (node.left != 0)
+    left = NewChild(this, file, (size_t) node.left);
+  if (node.right != 0)
+    right = NewChild(this, file, (size_t) node.right);
+
+  // The statistic is built after the children, as in the other constructors.
+  stat = StatisticType(*this);
+}
+
 /**
  * Create a binary space tree by copying the other tree.  Be careful!  This can
  * take a long time and use a lot of memory.
@@ -342,7 +472,10 @@ BinarySpaceTree(
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    arena(NULL), // The copied children are allocated individually.
+    ownsArena(false),
+    inArena(false)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -398,11 +531,8 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
-  left = NULL;
-  right = NULL;
   parent = other.Parent();
   begin = other.Begin();
   count = other.Count();
@@ -470,12 +600,13 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  DeleteChildren();
 
   parent = other.Parent();
   left = other.Left();
   right = other.Right();
+  arena = other.arena;
+  ownsArena = other.ownsArena;
   begin = other.Begin();
   count = other.Count();
   bound = std::move(other.bound);
@@ -494,6 +625,8 @@ operator=(BinarySpaceTree&& other)
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.arena = NULL;
+  other.ownsArena = false;
 
   return *this;
 }
@@ -520,7 +653,10 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    arena(other.arena),
+    ownsArena(other.ownsArena),
+    inArena(false)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -533,6 +669,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.arena = NULL;
+  other.ownsArena = false;
 
   // Set new parent.
   if (left)
@@ -576,8 +714,7 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
@@ -858,6 +995,92 @@ inline size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   return (begin + index);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildTree(std::vector<size_t>* oldFromNew, const size_t maxLeafSize)
+{
+  // A leaf needs no arena.  Otherwise, there are at most 2 * count - 1 nodes,
+  // but usually about 2 * (count / maxLeafSize) (more if leaves are not full).
+  // If the estimate is too small, the arena allocates more blocks.
+  if (count > maxLeafSize)
+  {
+    const size_t estimate = 4 * (count / std::max(maxLeafSize, (size_t) 1) + 1);
+    arena = new NodeArena<BinarySpaceTree>(std::min(2 * count, estimate));
+    ownsArena = true;
+  }
+
+  Split splitter;
+
+  // The recursion is started by a single thread; SplitNode() then creates tasks
+  // for the children of large nodes, which the other threads pick up.
+  #pragma omp parallel if (count >= ParallelBuildCutoff)
+  {
+    #pragma omp single
+    {
+      if (oldFromNew)
+        SplitNode(*oldFromNew, maxLeafSize, splitter);
+      else
+        SplitNode(maxLeafSize, splitter);
+    }
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename... Args>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>*
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+NewChild(Args&&... args)
+{
+  if (!arena)
+    return new BinarySpaceTree(std::forward<Args>(args)...);
+
+  BinarySpaceTree* node = new (arena->Allocate())
+      BinarySpaceTree(std::forward<Args>(args)...);
+  node->inArena = true;
+  return node;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+DeleteChildren()
+{
+  BinarySpaceTree* children[2] = { left, right };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    if (!children[i])
+      continue;
+
+    // Nodes in the arena are only destructed; the arena frees the memory.
+    if (children[i]->inArena)
+      children[i]->~BinarySpaceTree();
+    else
+      delete children[i];
+  }
+
+  left = NULL;
+  right = NULL;
+
+  if (ownsArena)
+    delete arena;
+  arena = NULL;
+  ownsArena = false;
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -903,11 +1126,30 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   assert(splitCol < begin + count);
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  // by calling their constructors (which perform this splitting process).  For
+  // large nodes, the left child is built in a separate task while this thread
+  // builds the right child; the two children hold disjoint sets of points.
+  if (SplitTraits<Split>::SupportsParallelBuild &&
+      count >= ParallelBuildCutoff)
+  {
+    Split* splitterPtr = &splitter;
+    #pragma omp task firstprivate(splitterPtr, splitCol)
+    {
+      left = NewChild(this, begin, splitCol - begin, *splitterPtr,
+          maxLeafSize);
+    }
+
+    right = NewChild(this, splitCol, begin + count - splitCol, splitter,
+        maxLeafSize);
+
+    #pragma omp taskwait
+  }
+  else
+  {
+    left = NewChild(this, begin, splitCol - begin, splitter, maxLeafSize);
+    right = NewChild(this, splitCol, begin + count - splitCol, splitter,
+        maxLeafSize);
+  }
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -971,11 +1213,33 @@ SplitNode(std::vector<size_t>& oldFromNew,
   assert(splitCol < begin + count);
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  // by calling their constructors (which perform this splitting process).  For
+  // large nodes, the left child is built in a separate task while this thread
+  // builds the right child; the two children only touch their own ranges of the
+  // dataset and of oldFromNew.
+  if (SplitTraits<Split>::SupportsParallelBuild &&
+      count >= ParallelBuildCutoff)
+  {
+    Split* splitterPtr = &splitter;
+    std::vector<size_t>* oldFromNewPtr = &oldFromNew;
+    #pragma omp task firstprivate(splitterPtr, oldFromNewPtr, splitCol)
+    {
+      left = NewChild(this, begin, splitCol - begin, *oldFromNewPtr,
+          *splitterPtr, maxLeafSize);
+    }
+
+    right = NewChild(this, splitCol, begin + count - splitCol, oldFromNew,
+        splitter, maxLeafSize);
+
+    #pragma omp taskwait
+  }
+  else
+  {
+    left = NewChild(this, begin, splitCol - begin, oldFromNew, splitter,
+        maxLeafSize);
+    right = NewChild(this, splitCol, begin + count - splitCol, oldFromNew,
+        splitter, maxLeafSize);
+  }
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -1049,7 +1313,10 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    arena(NULL),
+    ownsArena(false),
+    inArena(false)
 {
   // Nothing to do.
 }
@@ -1070,16 +1337,11 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
     parent = NULL;
-    left = NULL;
-    right = NULL;
   }
 
   ar & BOOST_SERIALIZATION_NVP(begin);
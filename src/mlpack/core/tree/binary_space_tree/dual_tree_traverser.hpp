@@ -16,12 +16,17 @@
 #define MLPACK_CORE_TREE_BINARY_SPACE_TREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 #include "binary_space_tree.hpp"
 
 namespace mlpack {
 namespace tree {
 
+//! This gives us a HasLeafBaseCaseCheck object that tells whether a rule type
+//! can evaluate all base cases between two leaves at once.
+HAS_MEM_FUNC(LeafBaseCase, HasLeafBaseCaseCheck);
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -86,6 +91,28 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! This is true if RuleType has the function
+  //! size_t LeafBaseCase(BinarySpaceTree& queryNode,
+  //!                     BinarySpaceTree& referenceNode).
+  static const bool HasLeafBaseCase = HasLeafBaseCaseCheck<RuleType,
+      size_t(RuleType::*)(BinarySpaceTree&, BinarySpaceTree&)>::value;
+
+  /**
+   * Evaluate the base cases between two leaves with the rules' LeafBaseCase()
+   * function.
+   */
+  void LeafBaseCases(BinarySpaceTree& queryNode,
+                     BinarySpaceTree& referenceNode,
+                     const std::true_type /* hasLeafBaseCase */);
+
+  /**
+   * Evaluate the base cases between two leaves one at a time, after scoring
+   * each query point.
+   */
+  void LeafBaseCases(BinarySpaceTree& queryNode,
+                     BinarySpaceTree& referenceNode,
+                     const std::false_type /* hasLeafBaseCase */);
 };
 
 } // namespace tree
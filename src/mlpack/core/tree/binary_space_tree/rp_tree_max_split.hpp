@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/perform_split.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -137,6 +138,18 @@ class RPTreeMaxSplit
                           ElemType& splitVal);
 };
 
+/**
+ * The RPTreeMaxSplit draws its random direction and split value from the
+ * shared random number generator, so the children of a node are not built in
+ * parallel; this keeps the tree reproducible with math::RandomSeed().
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<RPTreeMaxSplit<BoundType, MatType>>
+{
+ public:
+  static const bool SupportsParallelBuild = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
@@ -17,6 +17,7 @@
 #include "rp_tree_max_split.hpp"
 #include <mlpack/core/tree/perform_split.hpp>
 #include <mlpack/core/math/lin_alg.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -168,6 +169,17 @@ class RPTreeMeanSplit
                             ElemType& splitVal);
 };
 
+/**
+ * The RPTreeMeanSplit draws random samples from the shared random number
+ * generator, so the children of a node are not built in parallel.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<RPTreeMeanSplit<BoundType, MatType>>
+{
+ public:
+  static const bool SupportsParallelBuild = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
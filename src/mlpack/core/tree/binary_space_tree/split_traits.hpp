@@ -0,0 +1,42 @@
+/**
+ * @file core/tree/binary_space_tree/split_traits.hpp
+ *
+ * This file defines the SplitTraits class, which describes properties of the
+ * split types used by BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class describes properties of a split type that the
+ * BinarySpaceTree needs to know when it is built.  By default, a split type is
+ * assumed to hold no state that is shared between nodes.  A split type that
+ * does, or that draws from the shared random number generator, should
+ * specialize this class.
+ *
+ * @tparam SplitType The split type (i.e. SplitType<BoundType, MatType>).
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if SplitNode() and PerformSplit() can be called for two
+   * disjoint nodes from different threads at the same time.  If so, the
+   * children of large nodes are built in parallel.
+   */
+  static const bool SupportsParallelBuild = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "../address.hpp"
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -111,6 +112,18 @@ class UBTreeSplit
   }
 };
 
+/**
+ * The UBTreeSplit holds the addresses of all points, and SplitNode() modifies
+ * the addresses at the boundaries of neighboring nodes, so the children of a
+ * node cannot be built in parallel.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<UBTreeSplit<BoundType, MatType>>
+{
+ public:
+  static const bool SupportsParallelBuild = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
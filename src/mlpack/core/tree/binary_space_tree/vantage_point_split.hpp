@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/perform_split.hpp>
 #include <mlpack/core/math/random.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -166,6 +167,17 @@ class VantagePointSplit
                                  ElemType& mu);
 };
 
+/**
+ * The VantagePointSplit draws random samples from the shared random number
+ * generator, so the children of a node are not built in parallel.
+ */
+template<typename BoundType, typename MatType, size_t MaxNumSamples>
+class SplitTraits<VantagePointSplit<BoundType, MatType, MaxNumSamples>>
+{
+ public:
+  static const bool SupportsParallelBuild = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,104 @@
+/**
+ * @file core/tree/node_arena.hpp
+ *
+ * A simple arena that hands out memory for tree nodes from large contiguous
+ * blocks, so that a tree can be built without one heap allocation per node.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_NODE_ARENA_HPP
+#define MLPACK_CORE_TREE_NODE_ARENA_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The NodeArena class holds memory for tree nodes in contiguous blocks.  The
+ * first block is given the capacity passed to the constructor; if that runs
+ * out, further blocks of the same size are allocated.  So, if the capacity
+ * estimate is good, all nodes of a tree end up in one contiguous block.
+ *
+ * The arena only manages memory: nodes must be constructed in the memory
+ * returned by Allocate() with placement new, and they must be destructed
+ * explicitly (not with delete) before the arena is destroyed.  Allocate() may
+ * be called from several OpenMP threads at once.
+ *
+ * @tparam NodeType Type of node to hold.
+ */
+template<typename NodeType>
+class NodeArena
+{
+ public:
+  /**
+   * Create the arena, without allocating any memory yet.
+   *
+   * @param blockSize Number of nodes to hold in each block.
+   */
+  NodeArena(const size_t blockSize) :
+      blockSize(std::max(blockSize, (size_t) 1)),
+      used(0),
+      size(0)
+  { /* Nothing to do. */ }
+
+  //! Free all memory held by the arena.  This does not call any destructors.
+  ~NodeArena()
+  {
+    for (size_t i = 0; i < blocks.size(); ++i)
+      ::operator delete(blocks[i]);
+  }
+
+  //! Copying an arena is not allowed.
+  NodeArena(const NodeArena& other) = delete;
+  //! Copying an arena is not allowed.
+  NodeArena& operator=(const NodeArena& other) = delete;
+
+  /**
+   * Get uninitialized memory for one node.  This is safe to call from several
+   * threads at once.
+   */
+  void* Allocate()
+  {
+    void* memory;
+    #pragma omp critical(NodeArenaAllocate)
+    {
+      if (blocks.empty() || used == blockSize)
+      {
+        blocks.push_back(::operator new(blockSize * sizeof(NodeType)));
+        used = 0;
+      }
+
+      memory = static_cast<char*>(blocks.back()) + used * sizeof(NodeType);
+      ++used;
+      ++size;
+    }
+
+    return memory;
+  }
+
+  //! Get the number of nodes that have been allocated.
+  size_t Size() const { return size; }
+  //! Get the number of blocks that have been allocated.
+  size_t NumBlocks() const { return blocks.size(); }
+  //! Get the number of nodes held by each block.
+  size_t BlockSize() const { return blockSize; }
+
+ private:
+  //! The number of nodes held by each block.
+  size_t blockSize;
+  //! The blocks of memory.
+  std::vector<void*> blocks;
+  //! The number of nodes used in the last block.
+  size_t used;
+  //! The total number of nodes allocated.
+  size_t size;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
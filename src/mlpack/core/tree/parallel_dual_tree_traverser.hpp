@@ -0,0 +1,118 @@
+/**
+ * @file core/tree/parallel_dual_tree_traverser.hpp
+ *
+ * A task-parallel dual-tree traverser.  The query tree is split into a
+ * frontier of disjoint subtrees, and each of those subtrees is traversed
+ * against the reference tree as an independent OpenMP task, using the tree's
+ * own dual-tree traverser.  This works for any tree type that provides a
+ * DualTreeTraverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "tree_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The ParallelDualTreeTraverser splits the query tree into a set of disjoint
+ * query subtrees (the "frontier"), and then traverses each of those subtrees
+ * against the full reference tree in parallel with the given
+ * DualTreeTraversalType.  Because the results for a query point only depend on
+ * the query point itself, the results are the same as with a serial
+ * traversal.
+ *
+ * Each task gets its own copy of the rules, made with the copy constructor of
+ * RuleType.  So, RuleType must satisfy the following requirements, in addition
+ * to the usual requirements for a dual-tree traversal:
+ *
+ *  - A copy of a RuleType object must share the results it computes (for
+ *    instance, the candidate neighbor lists) with the original object, but
+ *    must hold its own traversal information.
+ *  - It must be safe for two copies to work on disjoint sets of query points at
+ *    the same time.
+ *  - RuleType must provide the modifiable accessors BaseCases() and Scores(),
+ *    which are used to collect the statistics of each task.
+ *
+ * If the subtrees of the frontier are not disjoint (this can happen with
+ * overlapping spill trees), or if mlpack was compiled without OpenMP, then the
+ * traversal is done serially.
+ *
+ * @tparam RuleType Type of rules to use for the traversal.
+ * @tparam DualTreeTraversalType Type of dual-tree traverser to use for each
+ *     task (usually TreeType::DualTreeTraverser).
+ */
+template<typename RuleType,
+         template<typename> class DualTreeTraversalType>
+class ParallelDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the parallel dual-tree traverser with the given rule set.
+   *
+   * @param rule Rules to use for traversal.
+   * @param tasksPerThread Number of query subtrees to create for each thread;
+   *     more tasks give better load balancing at the cost of less pruning.
+   */
+  ParallelDualTreeTraverser(RuleType& rule, const size_t tasksPerThread = 16);
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  template<typename TreeType>
+  void Traverse(TreeType& queryNode, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of query subtrees used for the last traversal.
+  size_t NumTasks() const { return numTasks; }
+
+  //! Get the number of query subtrees created for each thread.
+  size_t TasksPerThread() const { return tasksPerThread; }
+  //! Modify the number of query subtrees created for each thread.
+  size_t& TasksPerThread() { return tasksPerThread; }
+
+ private:
+  /**
+   * Split the given query node into at least the given number of disjoint
+   * subtrees (if possible) by repeatedly expanding the subtree with the most
+   * descendants.  The frontier is returned sorted by decreasing size.
+   */
+  template<typename TreeType>
+  void BuildFrontier(TreeType& queryNode,
+                     const size_t minTasks,
+                     std::vector<TreeType*>& frontier) const;
+
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The number of query subtrees to create for each thread.
+  size_t tasksPerThread;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! The number of query subtrees used for the last traversal.
+  size_t numTasks;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_dual_tree_traverser_impl.hpp"
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file core/tree/parallel_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the task-parallel dual-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_PARALLEL_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename RuleType,
+         template<typename> class DualTreeTraversalType>
+ParallelDualTreeTraverser<RuleType, DualTreeTraversalType>::
+ParallelDualTreeTraverser(RuleType& rule, const size_t tasksPerThread) :
+    rule(rule),
+    tasksPerThread(tasksPerThread),
+    numPrunes(0),
+    numTasks(0)
+{ /* Nothing to do. */ }
+
+template<typename RuleType,
+         template<typename> class DualTreeTraversalType>
+template<typename TreeType>
+void ParallelDualTreeTraverser<RuleType, DualTreeTraversalType>::Traverse(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  std::vector<TreeType*> frontier;
+  if (numThreads > 1)
+  {
+    BuildFrontier(queryNode, std::max(tasksPerThread, (size_t) 1) * numThreads,
+        frontier);
+  }
+
+  // If a point can be held in more than one node (as with overlapping spill
+  // trees), then two tasks could modify the results of the same query point.
+  // The frontier subtrees are disjoint exactly when their sizes sum to the size
+  // of the query tree.  If they are not disjoint, or if there is nothing to
+  // split, we must traverse serially.
+  bool disjoint = true;
+  if (!TreeTraits<TreeType>::UniqueNumDescendants)
+  {
+    size_t frontierSize = 0;
+    for (size_t i = 0; i < frontier.size(); ++i)
+      frontierSize += frontier[i]->NumDescendants();
+    disjoint = (frontierSize == queryNode.NumDescendants());
+  }
+
+  if (frontier.size() <= 1 || !disjoint)
+  {
+    DualTreeTraversalType<RuleType> traverser(rule);
+    traverser.Traverse(queryNode, referenceNode);
+    numPrunes += traverser.NumPrunes();
+    numTasks = 1;
+    return;
+  }
+
+  numTasks = frontier.size();
+
+  size_t baseCases = 0;
+  size_t scores = 0;
+  size_t prunes = 0;
+
+  // The frontier is sorted by decreasing size, so dynamic scheduling will start
+  // the largest tasks first.
+  #pragma omp parallel for schedule(dynamic, 1) \
+      reduction(+:baseCases, scores, prunes)
+  for (omp_size_t i = 0; i < (omp_size_t) frontier.size(); ++i)
+  {
+    // Each task gets its own rules; they share the results with the original
+    // rules, but the traversal information is independent.
+    RuleType taskRule(rule);
+    taskRule.BaseCases() = 0;
+    taskRule.Scores() = 0;
+
+    DualTreeTraversalType<RuleType> traverser(taskRule);
+    traverser.Traverse(*frontier[i], referenceNode);
+
+    baseCases += taskRule.BaseCases();
+    scores += taskRule.Scores();
+    prunes += traverser.NumPrunes();
+  }
+
+  rule.BaseCases() += baseCases;
+  rule.Scores() += scores;
+  numPrunes += prunes;
+}
+
+template<typename RuleType,
+         template<typename> class DualTreeTraversalType>
+template<typename TreeType>
+void ParallelDualTreeTraverser<RuleType, DualTreeTraversalType>::BuildFrontier(
+    TreeType& queryNode,
+    const size_t minTasks,
+    std::vector<TreeType*>& frontier) const
+{
+  frontier.clear();
+  frontier.push_back(&queryNode);
+
+  while (frontier.size() < minTasks)
+  {
+    // Find the largest subtree that can still be split.
+    size_t largest = frontier.size();
+    size_t largestSize = 0;
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      if (!frontier[i]->IsLeaf() &&
+          frontier[i]->NumDescendants() > largestSize)
+      {
+        largest = i;
+        largestSize = frontier[i]->NumDescendants();
+      }
+    }
+
+    // Stop if everything in the frontier is a leaf.
+    if (largest == frontier.size())
+      break;
+
+    // Replace the node with its children.  Any points held directly by the
+    // node are also held by its children, so the frontier still covers every
+    // query point.
+    TreeType* node = frontier[largest];
+    frontier[largest] = &node->Child(0);
+    for (size_t i = 1; i < node->NumChildren(); ++i)
+      frontier.push_back(&node->Child(i));
+  }
+
+  std::stable_sort(frontier.begin(), frontier.end(),
+      [](const TreeType* a, const TreeType* b)
+      {
+        return a->NumDescendants() > b->NumDescendants();
+      });
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
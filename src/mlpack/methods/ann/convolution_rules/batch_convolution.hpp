@@ -0,0 +1,147 @@
+/**
+ * @file methods/ann/convolution_rules/batch_convolution.hpp
+ *
+ * Convolution of a whole batch of multi-channel inputs, as needed by the
+ * convolution layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_BATCH_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_BATCH_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The BatchConvolution class computes all of the two-dimensional convolutions
+ * between a batch of multi-channel inputs and a set of filters that a
+ * convolution layer needs, and sums them over the input channels (for the
+ * forward and backward pass) or over the batch (for the gradient).
+ *
+ * The input cube holds the maps of each point of the batch one after the
+ * other, i.e. slice (b * inMaps + i) is input map i of point b, as in the
+ * layers.  This generic version calls ConvolutionRule::Convolution() once for
+ * each pair of maps; a convolution rule that can do better (such as
+ * Im2ColConvolution) specializes this class.
+ *
+ * @tparam ConvolutionRule Convolution rule to use (e.g. NaiveConvolution).
+ */
+template<typename ConvolutionRule>
+class BatchConvolution
+{
+ public:
+  /**
+   * Convolve each input map of each point with the filters of each output map,
+   * and sum over the input maps:
+   *
+   *   output.slice(b * outMaps + o) = sum_i conv(input.slice(b * inMaps + i),
+   *                                              filter.slice(o * inMaps + i))
+   *
+   * where outMaps = filter.n_slices / inMaps.
+   *
+   * @param input Input maps of each point of the batch.
+   * @param filter Filters, inMaps for each output map.
+   * @param output Output maps of each point of the batch.
+   * @param inMaps Number of input maps of each point.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t inMaps,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    const size_t batchSize = input.n_slices / inMaps;
+    const size_t outMaps = filter.n_slices / inMaps;
+
+    arma::Mat<eT> convOutput;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      for (size_t o = 0; o < outMaps; ++o)
+      {
+        for (size_t i = 0; i < inMaps; ++i)
+        {
+          ConvolutionRule::Convolution(input.slice(b * inMaps + i),
+              filter.slice(o * inMaps + i), convOutput, dW, dH, dilationW,
+              dilationH);
+
+          if (b == 0 && o == 0 && i == 0)
+            output.zeros(convOutput.n_rows, convOutput.n_cols,
+                outMaps * batchSize);
+
+          output.slice(b * outMaps + o) += convOutput;
+        }
+      }
+    }
+  }
+
+  /**
+   * Convolve each input map of each point with each filter of the same point,
+   * and sum over the batch:
+   *
+   *   output.slice(o * inMaps + i) = sum_b conv(input.slice(b * inMaps + i),
+   *                                             filter.slice(b * outMaps + o))
+   *
+   * where outMaps = filter.n_slices / batchSize.  This is what the gradient of
+   * a convolution layer with respect to its weights needs.
+   *
+   * @param input Input maps of each point of the batch.
+   * @param filter Filters (i.e. errors), outMaps for each point of the batch.
+   * @param output Output maps, inMaps for each filter of a point.
+   * @param inMaps Number of input maps of each point.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void GradientConvolution(const arma::Cube<eT>& input,
+                                  const arma::Cube<eT>& filter,
+                                  arma::Cube<eT>& output,
+                                  const size_t inMaps,
+                                  const size_t dW = 1,
+                                  const size_t dH = 1,
+                                  const size_t dilationW = 1,
+                                  const size_t dilationH = 1)
+  {
+    const size_t batchSize = input.n_slices / inMaps;
+    const size_t outMaps = filter.n_slices / batchSize;
+
+    arma::Mat<eT> convOutput;
+    for (size_t b = 0; b < batchSize; ++b)
+    {
+      for (size_t o = 0; o < outMaps; ++o)
+      {
+        for (size_t i = 0; i < inMaps; ++i)
+        {
+          ConvolutionRule::Convolution(input.slice(b * inMaps + i),
+              filter.slice(b * outMaps + o), convOutput, dW, dH, dilationW,
+              dilationH);
+
+          if (b == 0 && o == 0 && i == 0)
+            output.zeros(convOutput.n_rows, convOutput.n_cols,
+                outMaps * inMaps);
+
+          output.slice(o * inMaps + i) += convOutput;
+        }
+      }
+    }
+  }
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
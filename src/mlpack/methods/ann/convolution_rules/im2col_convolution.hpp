@@ -0,0 +1,487 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution as a matrix product (im2col + GEMM).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+#include "batch_convolution.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution;
+
+/**
+ * Batch convolution with Im2ColConvolution.  The input maps are unfolded into
+ * a matrix that holds, for each output position, the input values under each
+ * element of the filter ("im2col"); then all of the convolutions of the whole
+ * batch are a single matrix product, which is computed by BLAS.  If the
+ * unfolded matrix of a large batch would be too big, the batch is split into
+ * groups, and each group is one matrix product.
+ *
+ * The results are the same as with NaiveConvolution, up to rounding, except
+ * that the stride and dilation in the x direction always apply to the rows of
+ * the input and those in the y direction to the columns.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ *     ValidConvolution).
+ */
+template<typename BorderMode>
+class BatchConvolution<Im2ColConvolution<BorderMode>>
+{
+ public:
+  /**
+   * Convolve each input map of each point with the filters of each output map,
+   * and sum over the input maps.  See BatchConvolution::Convolution().
+   *
+   * @param input Input maps of each point of the batch.
+   * @param filter Filters, inMaps for each output map.
+   * @param output Output maps of each point of the batch.
+   * @param inMaps Number of input maps of each point.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t inMaps,
+                          size_t dW = 1,
+                          size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Cube<eT> inputPadded;
+    const arma::Cube<eT>& in = PadInput(input, filter.n_rows, filter.n_cols,
+        dW, dH, dilationW, dilationH, inputPadded);
+
+    const size_t batchSize = in.n_slices / inMaps;
+    const size_t outMaps = filter.n_slices / inMaps;
+    const size_t rows = OutputSize(in.n_rows, filter.n_rows, dW, dilationW);
+    const size_t cols = OutputSize(in.n_cols, filter.n_cols, dH, dilationH);
+    const size_t points = rows * cols;
+    const size_t kernel = filter.n_rows * filter.n_cols;
+
+    output.set_size(rows, cols, outMaps * batchSize);
+    if (output.n_elem == 0)
+      return;
+
+    // Each column of this matrix holds the filters of one output map.
+    const arma::Mat<eT> filterMatrix(const_cast<eT*>(filter.memptr()),
+        kernel * inMaps, outMaps, false, true);
+
+    arma::Mat<eT> unfolded, result;
+    const size_t groupSize = GroupSize(points * kernel * inMaps, batchSize);
+    for (size_t begin = 0; begin < batchSize; begin += groupSize)
+    {
+      const size_t count = std::min(groupSize, batchSize - begin);
+
+      // Row (p + points * b) of the unfolded matrix holds the input values at
+      // output position p of point b, for each filter element and input map.
+      unfolded.set_size(points * count, kernel * inMaps);
+      Unfold(in, inMaps, begin, count, rows, cols, filter.n_rows,
+          filter.n_cols, dW, dH, dilationW, dilationH, unfolded, false);
+
+      result = unfolded * filterMatrix;
+
+      // Now column o of the result holds output map o of each point.
+      #pragma omp parallel for
+      for (omp_size_t s = 0; s < (omp_size_t) (count * outMaps); ++s)
+      {
+        const size_t b = s / outMaps;
+        const size_t o = s % outMaps;
+        const eT* resultPtr = result.colptr(o) + b * points;
+        std::copy(resultPtr, resultPtr + points,
+            output.slice_memptr((begin + b) * outMaps + o));
+      }
+    }
+  }
+
+  /**
+   * Convolve each input map of each point with each filter of the same point,
+   * and sum over the batch.  See BatchConvolution::GradientConvolution().
+   *
+   * @param input Input maps of each point of the batch.
+   * @param filter Filters (i.e. errors), outMaps for each point of the batch.
+   * @param output Output maps, inMaps for each filter of a point.
+   * @param inMaps Number of input maps of each point.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void GradientConvolution(const arma::Cube<eT>& input,
+                                  const arma::Cube<eT>& filter,
+                                  arma::Cube<eT>& output,
+                                  const size_t inMaps,
+                                  size_t dW = 1,
+                                  size_t dH = 1,
+                                  const size_t dilationW = 1,
+                                  const size_t dilationH = 1)
+  {
+    arma::Cube<eT> inputPadded;
+    const arma::Cube<eT>& in = PadInput(input, filter.n_rows, filter.n_cols,
+        dW, dH, dilationW, dilationH, inputPadded);
+
+    const size_t batchSize = in.n_slices / inMaps;
+    const size_t outMaps = (batchSize == 0) ? 0 : filter.n_slices / batchSize;
+    const size_t rows = OutputSize(in.n_rows, filter.n_rows, dW, dilationW);
+    const size_t cols = OutputSize(in.n_cols, filter.n_cols, dH, dilationH);
+    const size_t points = rows * cols;
+    const size_t kernel = filter.n_rows * filter.n_cols;
+
+    output.zeros(rows, cols, outMaps * inMaps);
+    if (output.n_elem == 0)
+      return;
+
+    // The output is one matrix, where column o holds the output maps of
+    // filter o for each input map.
+    arma::Mat<eT> result(output.memptr(), points * inMaps, outMaps, false,
+        true);
+
+    arma::Mat<eT> unfolded, filterMatrix;
+    const size_t groupSize = GroupSize(points * kernel * inMaps, batchSize);
+    for (size_t begin = 0; begin < batchSize; begin += groupSize)
+    {
+      const size_t count = std::min(groupSize, batchSize - begin);
+
+      // Column (p + points * i) of the unfolded matrix holds the values of
+      // input map i at output position p, for each filter element and point.
+      unfolded.set_size(kernel * count, points * inMaps);
+      Unfold(in, inMaps, begin, count, rows, cols, filter.n_rows,
+          filter.n_cols, dW, dH, dilationW, dilationH, unfolded, true);
+
+      // Column o of this matrix holds filter o of each point.
+      filterMatrix.set_size(kernel * count, outMaps);
+      #pragma omp parallel for
+      for (omp_size_t s = 0; s < (omp_size_t) (count * outMaps); ++s)
+      {
+        const size_t b = s / outMaps;
+        const size_t o = s % outMaps;
+        const eT* filterPtr = filter.slice_memptr((begin + b) * outMaps + o);
+        std::copy(filterPtr, filterPtr + kernel,
+            filterMatrix.colptr(o) + b * kernel);
+      }
+
+      result += unfolded.t() * filterMatrix;
+    }
+  }
+
+ private:
+  /**
+   * Get the size of the output of a valid convolution in one direction.
+   *
+   * @param size Size of the input.
+   * @param k Size of the filter.
+   * @param s Stride of the filter.
+   * @param d Dilation of the filter.
+   */
+  static size_t OutputSize(const size_t size,
+                           const size_t k,
+                           const size_t s,
+                           const size_t d)
+  {
+    if (size < (k - 1) * d + 1)
+      return 0;
+
+    return (size - (k - 1) * d - 1) / s + 1;
+  }
+
+  /**
+   * Get the number of points of the batch that are unfolded at once, so that
+   * the unfolded matrix does not hold more than about 2^24 elements (unless a
+   * single point needs more than that).
+   *
+   * @param pointSize Number of elements of the unfolded matrix for one point.
+   * @param batchSize Number of points in the batch.
+   */
+  static size_t GroupSize(const size_t pointSize, const size_t batchSize)
+  {
+    const size_t maxElements = 16777216;
+    return std::max(std::min(maxElements / std::max(pointSize, (size_t) 1),
+        batchSize), (size_t) 1);
+  }
+
+  /**
+   * For a full convolution, pad the input with zeros so that a valid
+   * convolution of the padded input is the full convolution, in the same way
+   * as NaiveConvolution.  The strides are then set to 1.  For a valid
+   * convolution, the input is returned as it is.
+   */
+  template<typename eT>
+  static const arma::Cube<eT>& PadInput(const arma::Cube<eT>& input,
+                                        const size_t filterRows,
+                                        const size_t filterCols,
+                                        size_t& dW,
+                                        size_t& dH,
+                                        const size_t dilationW,
+                                        const size_t dilationH,
+                                        arma::Cube<eT>& inputPadded)
+  {
+    if (!std::is_same<BorderMode, FullConvolution>::value)
+      return input;
+
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filterRows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filterCols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; ++i)
+    {
+      if (((((i + outputRows - 2 * (filterRows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; ++i)
+    {
+      if (((((i + outputCols - 2 * (filterCols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    inputPadded.zeros(outputRows, outputCols, input.n_slices);
+    inputPadded.subcube((filterRows - 1) * dilationW,
+        (filterCols - 1) * dilationH, 0,
+        (filterRows - 1) * dilationW + input.n_rows - 1,
+        (filterCols - 1) * dilationH + input.n_cols - 1,
+        input.n_slices - 1) = input;
+
+    dW = 1;
+    dH = 1;
+    return inputPadded;
+  }
+
+  /**
+   * Unfold the input maps of the given points.  If transposed is false, the
+   * value of input map i of point b at output position p under filter element
+   * k is stored at (p + points * b, k + kernel * i); otherwise, it is stored at
+   * (k + kernel * b, p + points * i).  Here b is relative to the first point.
+   */
+  template<typename eT>
+  static void Unfold(const arma::Cube<eT>& input,
+                     const size_t inMaps,
+                     const size_t begin,
+                     const size_t count,
+                     const size_t rows,
+                     const size_t cols,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     arma::Mat<eT>& unfolded,
+                     const bool transposed)
+  {
+    const size_t points = rows * cols;
+    const size_t kernel = filterRows * filterCols;
+
+    #pragma omp parallel for
+    for (omp_size_t s = 0; s < (omp_size_t) (count * inMaps); ++s)
+    {
+      const size_t b = s / inMaps;
+      const size_t i = s % inMaps;
+      const arma::Mat<eT>& map = input.slice((begin + b) * inMaps + i);
+
+      for (size_t kc = 0; kc < filterCols; ++kc)
+      {
+        for (size_t kr = 0; kr < filterRows; ++kr)
+        {
+          const size_t k = kr + filterRows * kc;
+          for (size_t c = 0; c < cols; ++c)
+          {
+            const eT* inputPtr = map.colptr(c * dH + kc * dilationH) +
+                kr * dilationW;
+            if (!transposed)
+            {
+              eT* outputPtr = unfolded.colptr(k + kernel * i) +
+                  points * b + rows * c;
+              for (size_t r = 0; r < rows; ++r)
+                outputPtr[r] = inputPtr[r * dW];
+            }
+            else
+            {
+              for (size_t r = 0; r < rows; ++r)
+              {
+                unfolded.at(k + kernel * b, r + rows * c + points * i) =
+                    inputPtr[r * dW];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+/**
+ * Computes the two-dimensional convolution as a matrix product: the input is
+ * unfolded so that each row holds the input values under the filter at one
+ * output position ("im2col"), and the convolution is the product of that
+ * matrix with the filter, which is computed by BLAS.  The real advantage comes
+ * when many maps are convolved at once, as the convolution layers do through
+ * BatchConvolution<Im2ColConvolution>: then all of the convolutions of a batch
+ * are a single matrix product.
+ *
+ * As with NaiveConvolution, the border type can be specified:
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Mat<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+    const arma::Cube<eT> filterCube(const_cast<eT*>(filter.memptr()),
+        filter.n_rows, filter.n_cols, 1, false, true);
+
+    arma::Cube<eT> outputCube;
+    BatchConvolution<Im2ColConvolution<BorderMode>>::Convolution(inputCube,
+        filterCube, outputCube, 1, dW, dH, dilationW, dilationH);
+    output = outputCube.slice(0);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.  All of the filters are applied with one matrix
+   * product.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    BatchConvolution<Im2ColConvolution<BorderMode>>::Convolution(inputCube,
+        filter, output, 1, dW, dH, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.  All of the input maps are convolved with one
+   * matrix product.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    const arma::Cube<eT> filterCube(const_cast<eT*>(filter.memptr()),
+        filter.n_rows, filter.n_cols, 1, false, true);
+
+    // Each slice is a point of a batch with a single input map.
+    BatchConvolution<Im2ColConvolution<BorderMode>>::Convolution(input,
+        filterCube, output, 1, dW, dH, dilationW, dilationH);
+  }
+};  // class Im2ColConvolution
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,239 @@
+/**
+ * @file methods/ann/execution_plan.hpp
+ *
+ * Definition of the ExecutionPlan class, which holds a network that was frozen
+ * into a flat list of Forward() calls for fast inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_EXECUTION_PLAN_HPP
+#define MLPACK_METHODS_ANN_EXECUTION_PLAN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <memory>
+#include <mutex>
+
+#include "visitor/forward_step_visitor.hpp"
+#include "visitor/cast_layer_visitor.hpp"
+#include "visitor/activation_function_visitor.hpp"
+#include "layer_fusion.hpp"
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The buffers that hold the activations of the layers during one call of
+ * ExecutionPlan::Predict().  A workspace is cheap to create, and it keeps its
+ * memory from one call to the next; each thread that predicts with a shared
+ * network should use its own workspace.
+ *
+ * @tparam MatType Matrix type of the plan the workspace is used with.
+ */
+template<typename MatType = arma::mat>
+class InferenceWorkspace
+{
+ public:
+  //! Get the output of each layer from the last call.
+  const std::vector<MatType>& Activations() const { return activations; }
+  //! Modify the output of each layer.
+  std::vector<MatType>& Activations() { return activations; }
+
+  //! Get the input of the first layer from the last call.
+  const MatType& Input() const { return input; }
+  //! Modify the input of the first layer.
+  MatType& Input() { return input; }
+
+ private:
+  //! The output of each layer.
+  std::vector<MatType> activations;
+
+  //! The input points, converted to MatType (unused if MatType is arma::mat).
+  MatType input;
+};
+
+/**
+ * An execution plan is a network that was compiled for inference: the
+ * Forward() function of each layer is resolved once, when the plan is
+ * compiled, instead of visiting the layer on every pass, and the activations
+ * of the layers are written to buffers that are owned by the plan and reused
+ * from one call of Predict() to the next.  For small networks this removes
+ * most of the overhead besides the actual math.
+ *
+ * Unless disabled, consecutive layers are also fused when the plan is
+ * compiled: a BatchNorm layer in deterministic mode is folded into the
+ * weights of a Linear, LinearNoBias or Convolution layer before it, and an
+ * element-wise activation layer (a BaseLayer, e.g. ReLULayer) is applied in
+ * place to the output of the layer before it.  So a Linear - BatchNorm -
+ * ReLULayer block is one matrix product followed by one pass over its output.
+ * The folded layers are copies made at compile time (see FoldBatchNorm()).
+ *
+ * The plan holds pointers to the layers of the network, so it has to be
+ * compiled again whenever layers are added to or removed from the network,
+ * and, if layers were folded or copied, whenever the parameters of the network
+ * change.
+ *
+ * @code
+ * FFN<> model;
+ * // ... build and train the model ...
+ * model.Compile();
+ * model.Predict(data, predictions); // Uses the plan.
+ * @endcode
+ *
+ * The const Predict() overload takes the buffers from an InferenceWorkspace
+ * instead, so several threads can share one plan (and the weights of the
+ * network), each with its own workspace.  Layers whose Forward() function
+ * modifies the layer (see IsReentrantLayer) are only run by one
+ * thread at a time.
+ *
+ * If MatType is not arma::mat (e.g. arma::fmat), the plan holds copies of the
+ * layers that work on MatType instead of pointers to the layers of the
+ * network, and the input points are converted to MatType batch by batch.  The
+ * parameters of the network stay in double precision; the copies only see
+ * changes of the parameters when the plan is compiled again.  This kind of plan
+ * can only be compiled for networks that CastLayerVisitor can copy.
+ *
+ * @tparam MatType Matrix type used for the activations of the layers.
+ */
+template<typename MatType = arma::mat>
+class ExecutionPlan
+{
+ public:
+  /**
+   * Create an empty execution plan.
+   */
+  ExecutionPlan();
+
+  /**
+   * Compile the given network into the plan.  The network must already be
+   * initialized, and its layers must already know the size of their input
+   * (i.e. it must have been used for a forward pass before).  Layers that
+   * can't be converted to MatType cause std::invalid_argument to be thrown.
+   *
+   * If the size of the input points is given, the buffers of the plan are
+   * allocated for batchSize points here (see Allocate()), so that Predict()
+   * doesn't allocate memory; otherwise they get their size on the first call
+   * of Predict().
+   *
+   * @param network Layers of the network, in order.
+   * @param batchSize Number of points passed through the network at once.
+   * @param inputSize Number of rows of the input points (0 if unknown).
+   * @param fuse Whether to fuse consecutive layers where possible.
+   */
+  template<typename... CustomLayers>
+  void Compile(std::vector<LayerTypes<CustomLayers...> >& network,
+               const size_t batchSize,
+               const size_t inputSize = 0,
+               const bool fuse = true);
+
+  /**
+   * Allocate the buffers of the given workspace for a batch of BatchSize()
+   * points, by passing a batch of zeros through the plan.  Calls of Predict()
+   * with this workspace then only allocate memory for a last batch that is
+   * smaller than BatchSize().  The plan must have been compiled with the size
+   * of the input points.
+   *
+   * @param workspace Buffers to allocate.
+   */
+  void Allocate(InferenceWorkspace<MatType>& workspace) const;
+
+  /**
+   * Remove all of the steps and buffers from the plan.
+   */
+  void Clear();
+
+  /**
+   * Pass the given points through the network, BatchSize() points at a time,
+   * and store the output of the last layer.  If MatType is not arma::mat, the
+   * points are converted to MatType, and the output is converted back to
+   * double precision.  The results are only resized
+   * when their size changes, so that no memory is allocated if the number of
+   * points is the same as in the last call.
+   *
+   * @param predictors Input points, one per column.
+   * @param results Output of the network for each point.
+   */
+  void Predict(const arma::mat& predictors, arma::mat& results);
+
+  /**
+   * Pass the given points through the network like Predict() above, but use
+   * the buffers of the given workspace.  This can be called from several
+   * threads at once, as long as each thread uses its own workspace and the
+   * network is not changed in the meantime.
+   *
+   * @param predictors Input points, one per column.
+   * @param results Output of the network for each point.
+   * @param workspace Buffers for the activations of the layers.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               InferenceWorkspace<MatType>& workspace) const;
+
+  //! Return whether the plan is empty (i.e. not compiled).
+  bool Empty() const { return steps.empty(); }
+
+  //! Get the number of steps (layers) of the plan.
+  size_t NumSteps() const { return steps.size(); }
+
+  //! Get the number of points passed through the network at once.
+  size_t BatchSize() const { return batchSize; }
+
+  //! Get the number of rows of the input points (0 if unknown).
+  size_t InputSize() const { return inputSize; }
+
+ private:
+  //! Return the Forward() call of the layer itself.
+  template<typename... CustomLayers>
+  ForwardStep<MatType> Step(LayerTypes<CustomLayers...>& layer,
+                            std::true_type /* sameType */);
+
+  //! Return the Forward() call of a copy of the layer that uses MatType.
+  template<typename... CustomLayers>
+  ForwardStep<MatType> Step(LayerTypes<CustomLayers...>& layer,
+                            std::false_type /* sameType */);
+
+  //! Pass one batch of points through the steps, without a copy.
+  void Forward(const arma::mat& batch,
+               InferenceWorkspace<MatType>& workspace,
+               std::true_type /* sameType */) const;
+
+  //! Convert one batch of points to MatType and pass it through the steps.
+  void Forward(const arma::mat& batch,
+               InferenceWorkspace<MatType>& workspace,
+               std::false_type /* sameType */) const;
+
+  //! Pass the given input through the steps.
+  void Run(const MatType& input, std::vector<MatType>& activations) const;
+
+  //! The number of points passed through the network at once.
+  size_t batchSize;
+
+  //! The number of rows of the input points, or 0 if unknown.
+  size_t inputSize;
+
+  //! The resolved Forward() call of each layer.
+  std::vector<ForwardStep<MatType> > steps;
+
+  //! The copies of the layers (folded layers, fused steps, and all layers if
+  //! MatType is not arma::mat).
+  std::vector<std::shared_ptr<void> > layers;
+
+  //! A lock for each step whose layer is not reentrant.
+  std::vector<std::unique_ptr<std::mutex> > locks;
+
+  //! The workspace used by the non-const Predict().
+  InferenceWorkspace<MatType> workspace;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "execution_plan_impl.hpp"
+
+#endif
@@ -0,0 +1,234 @@
+/**
+ * @file methods/ann/execution_plan_impl.hpp
+ *
+ * Implementation of the ExecutionPlan class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_EXECUTION_PLAN_IMPL_HPP
+#define MLPACK_METHODS_ANN_EXECUTION_PLAN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "execution_plan.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename MatType>
+ExecutionPlan<MatType>::ExecutionPlan() : batchSize(0), inputSize(0)
+{
+  /* Nothing to do here. */
+}
+
+template<typename MatType>
+template<typename... CustomLayers>
+void ExecutionPlan<MatType>::Compile(
+    std::vector<LayerTypes<CustomLayers...> >& network,
+    const size_t batchSize,
+    const size_t inputSize,
+    const bool fuse)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("ExecutionPlan::Compile(): the batch size must "
+        "be positive!");
+  }
+
+  Clear();
+  try
+  {
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      LayerTypes<CustomLayers...> layer = network[i];
+      if (fuse && i + 1 < network.size() &&
+          FoldBatchNorm(layer, network[i + 1], layers))
+      {
+        ++i;
+      }
+
+      ForwardStep<MatType> step = Step(layer,
+          std::is_same<MatType, arma::mat>());
+
+      typename ActivationFunctionVisitor<MatType>::FunctionType activation =
+          NULL;
+      if (fuse && i + 1 < network.size())
+      {
+        activation = boost::apply_visitor(ActivationFunctionVisitor<MatType>(),
+            network[i + 1]);
+      }
+
+      if (activation)
+      {
+        FusedStep<MatType>* fused = new FusedStep<MatType>();
+        layers.push_back(std::shared_ptr<void>(fused));
+        fused->step = step;
+        fused->activation = activation;
+
+        step.function = &FusedStep<MatType>::Call;
+        step.layer = fused;
+        ++i;
+      }
+
+      steps.push_back(step);
+      locks.emplace_back(step.reentrant ? NULL : new std::mutex());
+    }
+  }
+  catch (...)
+  {
+    // Don't leave a partial plan behind.
+    Clear();
+    throw;
+  }
+
+  this->batchSize = batchSize;
+  this->inputSize = inputSize;
+
+  // Without the size of the input, the buffers get their size on the first
+  // pass.
+  if (inputSize != 0)
+    Allocate(workspace);
+}
+
+template<typename MatType>
+void ExecutionPlan<MatType>::Allocate(
+    InferenceWorkspace<MatType>& workspace) const
+{
+  if (steps.empty() || inputSize == 0)
+  {
+    throw std::logic_error("ExecutionPlan::Allocate(): the plan was not "
+        "compiled with the size of the input points!");
+  }
+
+  std::vector<MatType>& activations = workspace.Activations();
+  if (activations.size() != steps.size())
+    activations.resize(steps.size());
+
+  const arma::mat batch(inputSize, batchSize, arma::fill::zeros);
+  Forward(batch, workspace, std::is_same<MatType, arma::mat>());
+}
+
+template<typename MatType>
+template<typename... CustomLayers>
+ForwardStep<MatType> ExecutionPlan<MatType>::Step(
+    LayerTypes<CustomLayers...>& layer,
+    std::true_type /* sameType */)
+{
+  return boost::apply_visitor(ForwardStepVisitor(), layer);
+}
+
+template<typename MatType>
+template<typename... CustomLayers>
+ForwardStep<MatType> ExecutionPlan<MatType>::Step(
+    LayerTypes<CustomLayers...>& layer,
+    std::false_type /* sameType */)
+{
+  return boost::apply_visitor(CastLayerVisitor<MatType>(layers), layer);
+}
+
+template<typename MatType>
+void ExecutionPlan<MatType>::Clear()
+{
+  batchSize = 0;
+  inputSize = 0;
+  steps.clear();
+  locks.clear();
+  layers.clear();
+  workspace.Activations().clear();
+}
+
+template<typename MatType>
+void ExecutionPlan<MatType>::Predict(const arma::mat& predictors,
+                                     arma::mat& results)
+{
+  Predict(predictors, results, workspace);
+}
+
+template<typename MatType>
+void ExecutionPlan<MatType>::Predict(
+    const arma::mat& predictors,
+    arma::mat& results,
+    InferenceWorkspace<MatType>& workspace) const
+{
+  if (steps.empty())
+  {
+    throw std::logic_error("ExecutionPlan::Predict(): the plan is empty; call "
+        "Compile() first!");
+  }
+
+  std::vector<MatType>& activations = workspace.Activations();
+  if (activations.size() != steps.size())
+    activations.resize(steps.size());
+
+  // Without any points, pass a single point through the plan to get the size
+  // of the output, so that results doesn't keep its previous contents.
+  if (predictors.n_cols == 0)
+  {
+    Forward(arma::mat(predictors.n_rows, 1, arma::fill::zeros), workspace,
+        std::is_same<MatType, arma::mat>());
+    results.set_size(activations.back().n_rows, 0);
+    return;
+  }
+
+  for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
+  {
+    const size_t count = std::min(batchSize, predictors.n_cols - begin);
+    const arma::mat batch(const_cast<double*>(predictors.colptr(begin)),
+        predictors.n_rows, count, false, true);
+
+    Forward(batch, workspace, std::is_same<MatType, arma::mat>());
+
+    const MatType& output = activations.back();
+    if (begin == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    // This also converts the output back to double precision.
+    std::copy(output.begin(), output.end(), results.colptr(begin));
+  }
+}
+
+template<typename MatType>
+void ExecutionPlan<MatType>::Forward(const arma::mat& batch,
+                                     InferenceWorkspace<MatType>& workspace,
+                                     std::true_type /* sameType */) const
+{
+  Run(batch, workspace.Activations());
+}
+
+template<typename MatType>
+void ExecutionPlan<MatType>::Forward(const arma::mat& batch,
+                                     InferenceWorkspace<MatType>& workspace,
+                                     std::false_type /* sameType */) const
+{
+  MatType& input = workspace.Input();
+  input.set_size(batch.n_rows, batch.n_cols);
+  std::copy(batch.begin(), batch.end(), input.begin());
+
+  Run(input, workspace.Activations());
+}
+
+template<typename MatType>
+void ExecutionPlan<MatType>::Run(const MatType& input,
+                                 std::vector<MatType>& activations) const
+{
+  for (size_t i = 0; i < steps.size(); ++i)
+  {
+    const MatType& stepInput = (i == 0) ? input : activations[i - 1];
+    if (steps[i].reentrant)
+    {
+      steps[i].function(steps[i].layer, stepInput, activations[i]);
+    }
+    else
+    {
+      std::lock_guard<std::mutex> lock(*locks[i]);
+      steps[i].function(steps[i].layer, stepInput, activations[i]);
+    }
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -26,6 +26,8 @@
 #include "visitor/loss_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "execution_plan.hpp"
+#include "mixed_precision_network.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -120,6 +122,10 @@ class FFN
    * optimization. If this is not what you want, then you should access the
    * parameters vector directly with Parameters() and modify it as desired.
    *
+   * If MixedPrecision() is set, the forward and backward passes are computed
+   * in single precision, while the optimizer updates the double-precision
+   * parameters (see MixedPrecisionNetwork).
+   *
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
@@ -176,6 +182,90 @@ class FFN
    */
   void Predict(arma::mat predictors, arma::mat& results);
 
+  /**
+   * Freeze the network into an execution plan that is used by Predict() from
+   * then on: the Forward() function of each layer is resolved once instead of
+   * on every pass, the activations are kept in buffers that are reused across
+   * calls, and the predictors are passed through the network batchSize points
+   * at a time instead of one by one.  The network is initialized if it was
+   * not already.  BatchNorm layers are folded into the Linear, LinearNoBias or
+   * Convolution layer before them, and element-wise activation layers are
+   * applied in place to the output of the layer before them (see
+   * ExecutionPlan).  Convolution layers are only folded once the network was
+   * used for a forward pass.
+   *
+   * The buffers of the plan are allocated here for batchSize points if the
+   * size of the input points is known: either it is given as inputSize, or it
+   * is taken from the training data.  If the network was not used for a
+   * forward pass yet, the layers then also infer the size of their input here.
+   * Otherwise the buffers are allocated on the first call of Predict().
+   *
+   * If singlePrecision is true, the plan works on copies of the layers that
+   * compute in single precision (arma::fmat), which roughly halves the memory
+   * traffic of inference; the parameters of the network itself stay in double
+   * precision.  The predictions are converted back to double precision.  Not
+   * all layers can be copied (see CastLayerVisitor); for the others
+   * std::invalid_argument is thrown.  If the input sizes of the layers are
+   * inferred, the network must have been used for a forward pass before.
+   *
+   * The plan has to be compiled again after layers are added through
+   * Model(); Add() discards it.  Changes of the parameters don't invalidate
+   * it: training, evaluation by an optimizer, ResetParameters() and the
+   * non-const Parameters() and Model() accessors mark the plan as outdated,
+   * and Predict() compiles it again, so that folded and single-precision
+   * copies of layers are refreshed.
+   *
+   * @param batchSize Number of points passed through the network at once.
+   * @param singlePrecision Whether to compute the predictions in single
+   *     precision.
+   * @param inputSize Number of rows of the predictors (0 to use the training
+   *     data, if any).
+   */
+  void Compile(const size_t batchSize = 64,
+               const bool singlePrecision = false,
+               const size_t inputSize = 0);
+
+  /**
+   * Predict the responses to a given set of predictors with the compiled
+   * execution plan, using the buffers of the given workspace.  This does not
+   * modify the network, so several threads can predict with one network at
+   * once, sharing its parameters, as long as each thread has its own
+   * workspace.  The network must have been compiled with Compile() after the
+   * last change of its parameters (see Compile()), or by the non-const
+   * Predict(); otherwise std::logic_error is thrown.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param workspace Buffers for the activations of the layers.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               InferenceWorkspace<>& workspace) const;
+
+  /**
+   * Predict the responses to a given set of predictors like the const
+   * Predict() above, with the single-precision plan of a network that was
+   * compiled with singlePrecision set to true.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param workspace Single-precision buffers for the activations.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               InferenceWorkspace<arma::fmat>& workspace) const;
+
+  //! Return whether the network is compiled into an execution plan.
+  bool Compiled() const { return !plan.Empty() || !floatPlan.Empty(); }
+
+  //! Get whether the network is trained in single precision.
+  bool MixedPrecision() const { return mixedPrecision; }
+  //! Modify whether the network is trained in single precision, with the
+  //! double-precision parameters as master weights.  Not all layers can be
+  //! trained in single precision (see CastLayerVisitor); for the others Train()
+  //! throws std::invalid_argument.
+  bool& MixedPrecision() { return mixedPrecision; }
+
   /**
    * Evaluate the feedforward network with the given predictors and responses.
    * This functions is usually used to monitor progress while training.
@@ -287,14 +377,24 @@ class FFN
    * @param args The layer parameter.
    */
   template <class LayerType, class... Args>
-  void Add(Args... args) { network.push_back(new LayerType(args...)); }
+  void Add(Args... args)
+  {
+    network.push_back(new LayerType(args...));
+    plan.Clear();
+    floatPlan.Clear();
+  }
 
   /*
    * Add a new module to the model.
    *
    * @param layer The Layer to be added to the model.
    */
-  void Add(LayerTypes<CustomLayers...> layer) { network.push_back(layer); }
+  void Add(LayerTypes<CustomLayers...> layer)
+  {
+    network.push_back(layer);
+    plan.Clear();
+    floatPlan.Clear();
+  }
 
   //! Get the network model.
   const std::vector<LayerTypes<CustomLayers...> >& Model() const
@@ -304,7 +404,11 @@ class FFN
   //! Modify the network model.  Be careful!  If you change the structure of the
   //! network or parameters for layers, its state may become invalid, so be sure
   //! to call ResetParameters() afterwards.
-  std::vector<LayerTypes<CustomLayers...> >& Model() { return network; }
+  std::vector<LayerTypes<CustomLayers...> >& Model()
+  {
+    planOutdated = true;
+    return network;
+  }
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
@@ -312,7 +416,11 @@ class FFN
   //! Return the initial point for the optimization.
   const arma::mat& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
-  arma::mat& Parameters() { return parameter; }
+  arma::mat& Parameters()
+  {
+    planOutdated = true;
+    return parameter;
+  }
 
   //! Get the matrix of responses to the input data points.
   const arma::mat& Responses() const { return responses; }
@@ -494,6 +602,10 @@ class FFN
   //! The current evaluation mode (training or testing).
   bool deterministic;
 
+  //! Whether the parameters or the layers may have changed since the
+  //! execution plan was compiled.
+  bool planOutdated;
+
   //! Locally-stored delta object.
   arma::mat delta;
 
@@ -509,6 +621,19 @@ class FFN
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
+  //! The execution plan used by Predict(), if the network was compiled.
+  ExecutionPlan<> plan;
+
+  //! The single-precision execution plan, if the network was compiled so.
+  ExecutionPlan<arma::fmat> floatPlan;
+
+  //! Whether the network is trained in single precision.
+  bool mixedPrecision;
+
+  //! The single-precision copies of the layers used during training, if the
+  //! network is trained in single precision.
+  MixedPrecisionNetwork<arma::fmat> floatNetwork;
+
   // The GAN class should have access to internal members.
   template<
     typename Model,
@@ -39,7 +39,9 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(false)
+    deterministic(false),
+    planOutdated(false),
+    mixedPrecision(false)
 {
   /* Nothing to do here. */
 }
@@ -62,9 +64,29 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
   this->responses = std::move(responses);
   this->deterministic = false;
   ResetDeterministic();
+  planOutdated = true;
 
   if (!reset)
     ResetParameters();
+
+  floatNetwork.Clear();
+  if (mixedPrecision)
+  {
+    // The copies of the layers need the size of the input of each layer,
+    // which the layers only learn in their first forward pass.
+    if (!reset)
+    {
+      deterministic = true;
+      ResetDeterministic();
+      Forward(arma::mat(this->predictors.colptr(0), this->predictors.n_rows,
+          1, false, true));
+      deterministic = false;
+      ResetDeterministic();
+    }
+
+    floatNetwork.Build(network, parameter.n_elem);
+    floatNetwork.Deterministic(deterministic);
+  }
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -119,6 +141,15 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   Timer::Start("ffn_optimization");
   const double out = optimizer.Optimize(*this, parameter, callbacks...);
   Timer::Stop("ffn_optimization");
+  planOutdated = true;
+
+  // The single-precision copies of the layers hand the statistics they
+  // collected back to the layers of the network.
+  if (!floatNetwork.Empty())
+  {
+    floatNetwork.Store();
+    floatNetwork.Clear();
+  }
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
@@ -143,6 +174,15 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   Timer::Start("ffn_optimization");
   const double out = optimizer.Optimize(*this, parameter, callbacks...);
   Timer::Stop("ffn_optimization");
+  planOutdated = true;
+
+  // The single-precision copies of the layers hand the statistics they
+  // collected back to the layers of the network.
+  if (!floatNetwork.Empty())
+  {
+    floatNetwork.Store();
+    floatNetwork.Clear();
+  }
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
@@ -158,6 +198,10 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
   if (parameter.is_empty())
     ResetParameters();
 
+  // Outside of deterministic mode, the pass can change the state of layers.
+  if (!deterministic)
+    planOutdated = true;
+
   Forward(inputs);
   results = boost::apply_visitor(outputParameterVisitor, network.back());
 }
@@ -228,6 +272,33 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
+  // The folded and single-precision copies of the layers are out of date
+  // after the parameters changed.
+  if (planOutdated)
+  {
+    if (!plan.Empty())
+      plan.Compile(network, plan.BatchSize(), plan.InputSize());
+    if (!floatPlan.Empty())
+      floatPlan.Compile(network, floatPlan.BatchSize(), floatPlan.InputSize());
+    planOutdated = false;
+  }
+
+  if (!plan.Empty() || !floatPlan.Empty())
+  {
+    // The first pass through the network sets the input size of each layer.
+    if (!reset)
+    {
+      Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false,
+          true));
+    }
+
+    if (!plan.Empty())
+      plan.Predict(predictors, results);
+    else
+      floatPlan.Predict(predictors, results);
+    return;
+  }
+
   arma::mat resultsTemp;
   Forward(arma::mat(predictors.colptr(0), predictors.n_rows, 1, false, true));
   resultsTemp = boost::apply_visitor(outputParameterVisitor,
@@ -246,6 +317,85 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    const arma::mat& predictors,
+    arma::mat& results,
+    InferenceWorkspace<>& workspace) const
+{
+  if (plan.Empty())
+  {
+    throw std::logic_error("FFN::Predict(): the network is not compiled; call "
+        "Compile() first!");
+  }
+
+  if (planOutdated || !deterministic)
+  {
+    throw std::logic_error("FFN::Predict(): the parameters of the network "
+        "changed after it was compiled; call Compile() again!");
+  }
+
+  plan.Predict(predictors, results, workspace);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    const arma::mat& predictors,
+    arma::mat& results,
+    InferenceWorkspace<arma::fmat>& workspace) const
+{
+  if (floatPlan.Empty())
+  {
+    throw std::logic_error("FFN::Predict(): the network is not compiled in "
+        "single precision; call Compile() first!");
+  }
+
+  if (planOutdated || !deterministic)
+  {
+    throw std::logic_error("FFN::Predict(): the parameters of the network "
+        "changed after it was compiled; call Compile() again!");
+  }
+
+  floatPlan.Predict(predictors, results, workspace);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Compile(
+    const size_t batchSize,
+    const bool singlePrecision,
+    const size_t inputSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  const size_t rows = (inputSize != 0) ? inputSize : predictors.n_rows;
+
+  // The first pass through the network sets the input size of each layer.
+  if (!reset && rows != 0)
+    Forward(arma::mat(rows, 1, arma::fill::zeros));
+
+  if (singlePrecision)
+  {
+    plan.Clear();
+    floatPlan.Compile(network, batchSize, rows);
+  }
+  else
+  {
+    floatPlan.Clear();
+    plan.Compile(network, batchSize, rows);
+  }
+  planOutdated = false;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename PredictorsType, typename ResponsesType>
@@ -297,12 +447,23 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
   if (parameter.is_empty())
     ResetParameters();
 
+  // This is called by the optimizer, which changes the parameters.
+  planOutdated = true;
+
   if (deterministic != this->deterministic)
   {
     this->deterministic = deterministic;
     ResetDeterministic();
   }
 
+  if (!floatNetwork.Empty())
+  {
+    return floatNetwork.Evaluate(parameter, arma::mat(predictors.colptr(begin),
+        predictors.n_rows, batchSize, false, true),
+        arma::mat(responses.colptr(begin), responses.n_rows, batchSize, false,
+        true), outputLayer);
+  }
+
   Forward(predictors.cols(begin, begin + batchSize - 1));
   double res = outputLayer.Forward(
       boost::apply_visitor(outputParameterVisitor, network.back()),
@@ -358,12 +519,23 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     gradient.zeros();
   }
 
+  // This is called by the optimizer, which changes the parameters.
+  planOutdated = true;
+
   if (this->deterministic)
   {
     this->deterministic = false;
     ResetDeterministic();
   }
 
+  if (!floatNetwork.Empty())
+  {
+    return floatNetwork.EvaluateWithGradient(parameter,
+        arma::mat(predictors.colptr(begin), predictors.n_rows, batchSize,
+        false, true), arma::mat(responses.colptr(begin), responses.n_rows,
+        batchSize, false, true), outputLayer, gradient);
+  }
+
   Forward(predictors.cols(begin, begin + batchSize - 1));
   double res = outputLayer.Forward(
       boost::apply_visitor(outputParameterVisitor, network.back()),
@@ -410,6 +582,7 @@ void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetParameters()
 {
   ResetDeterministic();
+  planOutdated = true;
 
   // Reset the network parameter with the given initialization rule.
   NetworkInitialization<InitializationRuleType,
@@ -425,6 +598,8 @@ void FFN<OutputLayerType, InitializationRuleType,
   DeterministicSetVisitor deterministicSetVisitor(deterministic);
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deterministicSetVisitor));
+
+  floatNetwork.Deterministic(deterministic);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -567,6 +742,8 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
+    plan.Clear();
+    floatPlan.Clear();
   }
 
   ar & BOOST_SERIALIZATION_NVP(network);
@@ -610,10 +787,14 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(numFunctions, network.numFunctions);
   std::swap(error, network.error);
   std::swap(deterministic, network.deterministic);
+  std::swap(planOutdated, network.planOutdated);
+  std::swap(mixedPrecision, network.mixedPrecision);
   std::swap(delta, network.delta);
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(plan, network.plan);
+  std::swap(floatPlan, network.floatPlan);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -631,10 +812,12 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     numFunctions(network.numFunctions),
     error(network.error),
     deterministic(network.deterministic),
+    planOutdated(false),
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    mixedPrecision(network.mixedPrecision)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -659,12 +842,18 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     numFunctions(network.numFunctions),
     error(std::move(network.error)),
     deterministic(network.deterministic),
+    planOutdated(network.planOutdated),
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    plan(std::move(network.plan)),
+    floatPlan(std::move(network.floatPlan)),
+    mixedPrecision(network.mixedPrecision)
 {
   this->network = std::move(network.network);
+  network.plan.Clear();
+  network.floatPlan.Clear();
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
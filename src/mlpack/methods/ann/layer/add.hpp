@@ -123,6 +123,15 @@ class Add
   OutputDataType outputParameter;
 }; // class Add
 
+/**
+ * The Forward() function of the Add layer only reads the layer.
+ */
+template<typename InputDataType, typename OutputDataType>
+struct IsReentrantLayer<Add<InputDataType, OutputDataType> >
+{
+  const static bool value = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
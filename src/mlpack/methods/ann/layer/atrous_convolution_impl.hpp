@@ -211,40 +211,24 @@ void AtrousConvolution<
   output.set_size(wConv * hConv * outSize, batchSize);
   outputTemp = arma::Cube<eT>(output.memptr(), wConv, hConv,
       outSize * batchSize, false, false);
-  outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  // All of the convolutions of the batch are computed at once.
+  if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+      padding.PadHTop() != 0 || padding.PadHBottom() != 0)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> convOutput;
-
-      if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
-          padding.PadHTop() != 0 || padding.PadHBottom() != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight, dilationWidth, dilationHeight);
-      }
-      else
-      {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight, dilationWidth, dilationHeight);
-      }
-
-      outputTemp.slice(outMap) += convOutput;
-    }
+    BatchConvolution<ForwardConvolutionRule>::Convolution(inputPaddedTemp,
+        weight, outputTemp, inSize, strideWidth, strideHeight, dilationWidth,
+        dilationHeight);
+  }
+  else
+  {
+    BatchConvolution<ForwardConvolutionRule>::Convolution(inputTemp, weight,
+        outputTemp, inSize, strideWidth, strideHeight, dilationWidth,
+        dilationHeight);
+  }
 
+  for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
     outputTemp.slice(outMap) += bias(outMap % outSize);
-  }
 
   outputWidth = outputTemp.n_rows;
   outputHeight = outputTemp.n_cols;
@@ -273,39 +257,37 @@ void AtrousConvolution<
   g.set_size(inputWidth * inputHeight * inSize, batchSize);
   gTemp = arma::Cube<eT>(g.memptr(), inputWidth, inputHeight,
       inSize * batchSize, false, false);
-  gTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  // The filters of the backward pass are the rotated weights, with the input
+  // and output maps swapped.
+  arma::Cube<eT> rotatedFilters(weight.n_rows, weight.n_cols,
+      weight.n_slices);
+  for (size_t outMap = 0; outMap < outSize; outMap++)
   {
-    if (outMap != 0 && outMap % outSize == 0)
+    for (size_t inMap = 0; inMap < inSize; inMap++)
     {
-      batchCount++;
-      outMapIdx = 0;
+      Rotate180(weight.slice(outMap * inSize + inMap),
+          rotatedFilters.slice(inMap * outSize + outMap));
     }
+  }
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> output, rotatedFilter;
-      Rotate180(weight.slice(outMapIdx), rotatedFilter);
-
-      BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
-          rotatedFilter, output, strideWidth, strideHeight, dilationWidth,
-          dilationHeight);
-
-      if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
-          padding.PadHTop() != 0 || padding.PadHBottom() != 0)
-      {
-        gTemp.slice(inMap + batchCount * inSize) +=
-            output.submat(padding.PadWLeft(), padding.PadHTop(),
-                          padding.PadWLeft() + gTemp.n_rows - 1,
-                          padding.PadHTop() + gTemp.n_cols - 1);
-      }
-      else
-      {
-        gTemp.slice(inMap + batchCount * inSize) += output;
-      }
-    }
+  if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+      padding.PadHTop() != 0 || padding.PadHBottom() != 0)
+  {
+    arma::Cube<eT> output;
+    BatchConvolution<BackwardConvolutionRule>::Convolution(mappedError,
+        rotatedFilters, output, outSize, strideWidth, strideHeight,
+        dilationWidth, dilationHeight);
+
+    gTemp = output.subcube(padding.PadWLeft(), padding.PadHTop(), 0,
+        padding.PadWLeft() + gTemp.n_rows - 1,
+        padding.PadHTop() + gTemp.n_cols - 1, output.n_slices - 1);
+  }
+  else
+  {
+    BatchConvolution<BackwardConvolutionRule>::Convolution(mappedError,
+        rotatedFilters, gTemp, outSize, strideWidth, strideHeight,
+        dilationWidth, dilationHeight);
   }
 }
 
@@ -338,67 +320,47 @@ void AtrousConvolution<
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  arma::Cube<eT> output;
+  if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
+      padding.PadHTop() != 0 || padding.PadHBottom() != 0)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
+    BatchConvolution<GradientConvolutionRule>::GradientConvolution(
+        inputPaddedTemp, mappedError, output, inSize, strideWidth,
+        strideHeight, 1, 1);
+  }
+  else
+  {
+    BatchConvolution<GradientConvolutionRule>::GradientConvolution(inputTemp,
+        mappedError, output, inSize, strideWidth, strideHeight, 1, 1);
+  }
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> inputSlice;
-      if (padding.PadWLeft() != 0 || padding.PadWRight() != 0 ||
-          padding.PadHTop() != 0 || padding.PadHBottom() != 0)
-      {
-        inputSlice = inputPaddedTemp.slice(inMap + batchCount * inSize);
-      }
-      else
-      {
-        inputSlice = inputTemp.slice(inMap + batchCount * inSize);
-      }
-
-      arma::Mat<eT> deltaSlice = mappedError.slice(outMap);
-
-      arma::Mat<eT> output;
-      GradientConvolutionRule::Convolution(inputSlice, deltaSlice,
-          output, strideWidth, strideHeight, 1, 1);
-
-      if (dilationHeight > 1)
-      {
-        for (size_t i = 1; i < output.n_cols; ++i){
-          output.shed_cols(i, i + dilationHeight - 2);
-        }
-      }
-      if (dilationWidth > 1)
-      {
-        for (size_t i = 1; i < output.n_rows; ++i){
-          output.shed_rows(i, i + dilationWidth - 2);
-        }
-      }
-
-      if (gradientTemp.n_rows < output.n_rows ||
-          gradientTemp.n_cols < output.n_cols)
-      {
-        gradientTemp.slice(outMapIdx) += output.submat(0, 0,
-            gradientTemp.n_rows - 1, gradientTemp.n_cols - 1);
-      }
-      else if (gradientTemp.n_rows > output.n_rows ||
-          gradientTemp.n_cols > output.n_cols)
-      {
-        gradientTemp.slice(outMapIdx).submat(0, 0, output.n_rows - 1,
-            output.n_cols - 1) += output;
-      }
-      else
-      {
-        gradientTemp.slice(outMapIdx) += output;
-      }
+  if (dilationHeight > 1)
+  {
+    for (size_t i = 1; i < output.n_cols; ++i){
+      output.shed_cols(i, i + dilationHeight - 2);
+    }
+  }
+  if (dilationWidth > 1)
+  {
+    for (size_t i = 1; i < output.n_rows; ++i){
+      output.shed_rows(i, i + dilationWidth - 2);
     }
+  }
+
+  const size_t rows = std::min(gradientTemp.n_rows, output.n_rows);
+  const size_t cols = std::min(gradientTemp.n_cols, output.n_cols);
+  gradientTemp.subcube(0, 0, 0, rows - 1, cols - 1, gradientTemp.n_slices - 1)
+      = output.subcube(0, 0, 0, rows - 1, cols - 1, output.n_slices - 1);
+
+  // The gradient of the bias is summed over the batch, like the gradient of
+  // the weights.
+  for (size_t outMap = 0; outMap < outSize; outMap++)
+  {
+    eT biasGradient = 0;
+    for (size_t b = 0; b < batchSize; b++)
+      biasGradient += arma::accu(mappedError.slice(b * outSize + outMap));
 
-    gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
-        (outMap % outSize), 0) = arma::accu(mappedError.slice(outMap));
+    gradient(weight.n_elem + outMap) = biasGradient;
   }
 }
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_BASE_LAYER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 #include <mlpack/methods/ann/activation_functions/logistic_function.hpp>
 #include <mlpack/methods/ann/activation_functions/identity_function.hpp>
 #include <mlpack/methods/ann/activation_functions/rectifier_function.hpp>
@@ -132,6 +133,18 @@ class BaseLayer
   OutputDataType outputParameter;
 }; // class BaseLayer
 
+/**
+ * The Forward() function of a BaseLayer only applies the activation function.
+ */
+template<typename ActivationFunction,
+         typename InputDataType,
+         typename OutputDataType>
+struct IsReentrantLayer<
+    BaseLayer<ActivationFunction, InputDataType, OutputDataType> >
+{
+  const static bool value = true;
+};
+
 // Convenience typedefs.
 
 /**
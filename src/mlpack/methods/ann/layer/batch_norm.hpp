@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_BATCHNORM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -227,12 +228,22 @@ class BatchNorm
   OutputDataType outputParameter;
 
   //! Locally-stored normalized input.
-  arma::cube normalized;
+  arma::Cube<typename OutputDataType::elem_type> normalized;
 
   //! Locally-stored zero mean input.
-  arma::cube inputMean;
+  arma::Cube<typename OutputDataType::elem_type> inputMean;
 }; // class BatchNorm
 
+/**
+ * In deterministic mode, the Forward() function of the BatchNorm layer only
+ * reads the running mean and variance.
+ */
+template<typename InputDataType, typename OutputDataType>
+struct IsReentrantLayer<BatchNorm<InputDataType, OutputDataType> >
+{
+  const static bool value = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
@@ -59,9 +59,9 @@ template<typename InputDataType, typename OutputDataType>
 void BatchNorm<InputDataType, OutputDataType>::Reset()
 {
   // Gamma acts as the scaling parameters for the normalized output.
-  gamma = arma::mat(weights.memptr(), size, 1, false, false);
+  gamma = OutputDataType(weights.memptr(), size, 1, false, false);
   // Beta acts as the shifting parameters for the normalized output.
-  beta = arma::mat(weights.memptr() + gamma.n_elem, size, 1, false, false);
+  beta = OutputDataType(weights.memptr() + gamma.n_elem, size, 1, false, false);
 
   if (!loading)
   {
@@ -101,11 +101,11 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
 
     // Input corresponds to output from convolution layer.
     // Use a cube for simplicity.
-    arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
+    arma::Cube<eT> inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
         inputSize, size, batchSize, false, false);
 
     // Initialize output to same size and values for convenience.
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
+    arma::Cube<eT> outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
         inputSize, size, batchSize, false, false);
     outputTemp = inputTemp;
 
@@ -152,7 +152,7 @@ void BatchNorm<InputDataType, OutputDataType>::Forward(
   {
     // Normalize the input and scale and shift the output.
     output = input;
-    arma::cube outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
+    arma::Cube<eT> outputTemp(const_cast<arma::Mat<eT>&>(output).memptr(),
         input.n_rows / size, size, batchSize, false, false);
 
     outputTemp.each_slice() -= arma::repmat(runningMean.t(),
@@ -173,21 +173,21 @@ void BatchNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>& gy,
     arma::Mat<eT>& g)
 {
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
+  const arma::Mat<eT> stdInv = 1.0 / arma::sqrt(variance + eps);
 
   g.set_size(arma::size(input));
-  arma::cube gyTemp(const_cast<arma::Mat<eT>&>(gy).memptr(),
+  arma::Cube<eT> gyTemp(const_cast<arma::Mat<eT>&>(gy).memptr(),
       input.n_rows / size, size, input.n_cols, false, false);
-  arma::cube gTemp(const_cast<arma::Mat<eT>&>(g).memptr(),
+  arma::Cube<eT> gTemp(const_cast<arma::Mat<eT>&>(g).memptr(),
       input.n_rows / size, size, input.n_cols, false, false);
 
   // Step 1: dl / dxhat.
-  arma::cube norm = gyTemp.each_slice() % arma::repmat(gamma.t(),
+  arma::Cube<eT> norm = gyTemp.each_slice() % arma::repmat(gamma.t(),
       input.n_rows / size, 1);
 
   // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  arma::mat temp = arma::sum(norm % inputMean, 2);
-  arma::mat vars = temp % arma::repmat(arma::pow(stdInv, 3),
+  arma::Mat<eT> temp = arma::sum(norm % inputMean, 2);
+  arma::Mat<eT> vars = temp % arma::repmat(arma::pow(stdInv, 3),
       input.n_rows / size, 1) * -0.5;
 
   // Step 3: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
@@ -198,7 +198,7 @@ void BatchNorm<InputDataType, OutputDataType>::Backward(
 
   // Step 4: sum (dl / dxhat * -1 / stdInv) + variance *
   // (sum -2 * (x - mu)) / m.
-  arma::mat normTemp = arma::sum(norm.each_slice() %
+  arma::Mat<eT> normTemp = arma::sum(norm.each_slice() %
       arma::repmat(-stdInv, input.n_rows / size, 1) , 2) /
       input.n_cols;
   gTemp.each_slice() += normTemp;
@@ -212,11 +212,11 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>& gradient)
 {
   gradient.set_size(size + size, 1);
-  arma::cube errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
+  arma::Cube<eT> errorTemp(const_cast<arma::Mat<eT>&>(error).memptr(),
       error.n_rows / size, size, error.n_cols, false, false);
 
   // Step 5: dl / dy * xhat.
-  arma::mat temp = arma::sum(arma::sum(normalized % errorTemp, 0), 2);
+  arma::Mat<eT> temp = arma::sum(arma::sum(normalized % errorTemp, 0), 2);
   gradient.submat(0, 0, gamma.n_elem - 1, 0) = temp.t();
 
   // Step 6: dl / dy.
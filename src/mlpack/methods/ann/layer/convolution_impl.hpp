@@ -136,7 +136,8 @@ Convolution<
     InitializeSamePadding();
   }
 
-  padding = ann::Padding<>(padWLeft, padWRight, padHTop, padHBottom);
+  padding = ann::Padding<InputDataType, OutputDataType>(padWLeft, padWRight,
+      padHTop, padHBottom);
 }
 
 template<
@@ -154,9 +155,9 @@ void Convolution<
     OutputDataType
 >::Reset()
 {
-    weight = arma::cube(weights.memptr(), kernelWidth, kernelHeight,
+    weight = arma::Cube<ElemType>(weights.memptr(), kernelWidth, kernelHeight,
         outSize * inSize, false, false);
-    bias = arma::mat(weights.memptr() + weight.n_elem,
+    bias = OutputDataType(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
 }
 
@@ -177,7 +178,7 @@ void Convolution<
 >::Forward(const arma::Mat<eT>& input, arma::Mat<eT>& output)
 {
   batchSize = input.n_cols;
-  arma::cube inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
+  arma::Cube<eT> inputTemp(const_cast<arma::Mat<eT>&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
 
   if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
@@ -199,39 +200,21 @@ void Convolution<
   output.set_size(wConv * hConv * outSize, batchSize);
   outputTemp = arma::Cube<eT>(output.memptr(), wConv, hConv,
       outSize * batchSize, false, false);
-  outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  // All of the convolutions of the batch are computed at once.
+  if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> convOutput;
-
-      if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight);
-      }
-      else
-      {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput,
-            strideWidth, strideHeight);
-      }
-
-      outputTemp.slice(outMap) += convOutput;
-    }
+    BatchConvolution<ForwardConvolutionRule>::Convolution(inputPaddedTemp,
+        weight, outputTemp, inSize, strideWidth, strideHeight);
+  }
+  else
+  {
+    BatchConvolution<ForwardConvolutionRule>::Convolution(inputTemp, weight,
+        outputTemp, inSize, strideWidth, strideHeight);
+  }
 
+  for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
     outputTemp.slice(outMap) += bias(outMap % outSize);
-  }
 
   outputWidth = outputTemp.n_rows;
   outputHeight = outputTemp.n_cols;
@@ -254,41 +237,39 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>& /* input */, const arma::Mat<eT>& gy, arma::Mat<eT>& g)
 {
-  arma::cube mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
+  arma::Cube<eT> mappedError(((arma::Mat<eT>&) gy).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
 
   g.set_size(inputWidth * inputHeight * inSize, batchSize);
   gTemp = arma::Cube<eT>(g.memptr(), inputWidth, inputHeight,
       inSize * batchSize, false, false);
-  gTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  // The filters of the backward pass are the rotated weights, with the input
+  // and output maps swapped.
+  arma::Cube<eT> rotatedFilters(weight.n_rows, weight.n_cols,
+      weight.n_slices);
+  for (size_t outMap = 0; outMap < outSize; outMap++)
   {
-    if (outMap != 0 && outMap % outSize == 0)
+    for (size_t inMap = 0; inMap < inSize; inMap++)
     {
-      batchCount++;
-      outMapIdx = 0;
+      Rotate180(weight.slice(outMap * inSize + inMap),
+          rotatedFilters.slice(inMap * outSize + outMap));
     }
+  }
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> output, rotatedFilter;
-      Rotate180(weight.slice(outMapIdx), rotatedFilter);
-
-      BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
-          rotatedFilter, output, strideWidth, strideHeight);
-
-      if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
-      {
-        gTemp.slice(inMap + batchCount * inSize) += output.submat(padWLeft,
-            padHTop, padWLeft + gTemp.n_rows - 1, padHTop + gTemp.n_cols - 1);
-      }
-      else
-      {
-        gTemp.slice(inMap + batchCount * inSize) += output;
-      }
-    }
+  if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
+  {
+    arma::Cube<eT> output;
+    BatchConvolution<BackwardConvolutionRule>::Convolution(mappedError,
+        rotatedFilters, output, outSize, strideWidth, strideHeight);
+
+    gTemp = output.subcube(padWLeft, padHTop, 0, padWLeft + gTemp.n_rows - 1,
+        padHTop + gTemp.n_cols - 1, output.n_slices - 1);
+  }
+  else
+  {
+    BatchConvolution<BackwardConvolutionRule>::Convolution(mappedError,
+        rotatedFilters, gTemp, outSize, strideWidth, strideHeight);
   }
 }
 
@@ -311,9 +292,9 @@ void Convolution<
     const arma::Mat<eT>& error,
     arma::Mat<eT>& gradient)
 {
-  arma::cube mappedError(((arma::Mat<eT>&) error).memptr(), outputWidth,
+  arma::Cube<eT> mappedError(((arma::Mat<eT>&) error).memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
-  arma::cube inputTemp(((arma::Mat<eT>&) input).memptr(), inputWidth,
+  arma::Cube<eT> inputTemp(((arma::Mat<eT>&) input).memptr(), inputWidth,
       inputHeight, inSize * batchSize, false, false);
 
   gradient.set_size(weights.n_elem, 1);
@@ -321,53 +302,33 @@ void Convolution<
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  arma::Cube<eT> output;
+  if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
+    BatchConvolution<GradientConvolutionRule>::GradientConvolution(
+        inputPaddedTemp, mappedError, output, inSize, strideWidth,
+        strideHeight);
+  }
+  else
+  {
+    BatchConvolution<GradientConvolutionRule>::GradientConvolution(inputTemp,
+        mappedError, output, inSize, strideWidth, strideHeight);
+  }
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> inputSlice;
-      if (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0)
-      {
-        inputSlice = inputPaddedTemp.slice(inMap + batchCount * inSize);
-      }
-      else
-      {
-        inputSlice = inputTemp.slice(inMap + batchCount * inSize);
-      }
-
-      arma::Mat<eT> deltaSlice = mappedError.slice(outMap);
-
-      arma::Mat<eT> output;
-      GradientConvolutionRule::Convolution(inputSlice, deltaSlice,
-          output, strideWidth, strideHeight);
-
-      if (gradientTemp.n_rows < output.n_rows ||
-          gradientTemp.n_cols < output.n_cols)
-      {
-        gradientTemp.slice(outMapIdx) += output.submat(0, 0,
-            gradientTemp.n_rows - 1, gradientTemp.n_cols - 1);
-      }
-      else if (gradientTemp.n_rows > output.n_rows ||
-          gradientTemp.n_cols > output.n_cols)
-      {
-        gradientTemp.slice(outMapIdx).submat(0, 0, output.n_rows - 1,
-            output.n_cols - 1) += output;
-      }
-      else
-      {
-        gradientTemp.slice(outMapIdx) += output;
-      }
-    }
+  const size_t rows = std::min(gradientTemp.n_rows, output.n_rows);
+  const size_t cols = std::min(gradientTemp.n_cols, output.n_cols);
+  gradientTemp.subcube(0, 0, 0, rows - 1, cols - 1, gradientTemp.n_slices - 1)
+      = output.subcube(0, 0, 0, rows - 1, cols - 1, output.n_slices - 1);
+
+  // The gradient of the bias is summed over the batch, like the gradient of
+  // the weights.
+  for (size_t outMap = 0; outMap < outSize; outMap++)
+  {
+    eT biasGradient = 0;
+    for (size_t b = 0; b < batchSize; b++)
+      biasGradient += arma::accu(mappedError.slice(b * outSize + outMap));
 
-    gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
-        (outMap % outSize), 0) = arma::accu(mappedError.slice(outMap));
+    gradient(weight.n_elem + outMap) = biasGradient;
   }
 }
 
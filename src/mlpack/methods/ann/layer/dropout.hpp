@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_DROPOUT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -132,6 +133,16 @@ class Dropout
   bool deterministic;
 }; // class Dropout
 
+/**
+ * In deterministic mode, the Forward() function of the Dropout layer only
+ * copies its input.
+ */
+template<typename InputDataType, typename OutputDataType>
+struct IsReentrantLayer<Dropout<InputDataType, OutputDataType> >
+{
+  const static bool value = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
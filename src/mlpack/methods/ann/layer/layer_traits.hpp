@@ -55,6 +55,18 @@ class LayerTraits
   static const bool IsConnection = false;
 };
 
+/**
+ * This is true if the Forward() function of the layer (in deterministic mode)
+ * does not modify the layer, so that several threads can call it on the same
+ * layer at once.  By default a layer is assumed to modify itself; layers that
+ * don't should specialize this class.
+ */
+template<typename LayerType>
+struct IsReentrantLayer
+{
+  const static bool value = false;
+};
+
 // This gives us a HasGradientCheck<T, U> type (where U is a function pointer)
 // we can use with SFINAE to catch when a type has a Gradient(...) function.
 HAS_MEM_FUNC(Gradient, HasGradientCheck);
@@ -55,6 +55,8 @@
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/batch_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 // Regularizers.
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
@@ -217,7 +219,19 @@ using MoreTypes = boost::variant<
         VRClassReward<arma::mat, arma::mat>*,
         VirtualBatchNorm<arma::mat, arma::mat>*,
         RBF<arma::mat, arma::mat, GaussianFunction>*,
-        BaseLayer<GaussianFunction, arma::mat, arma::mat>*
+        BaseLayer<GaussianFunction, arma::mat, arma::mat>*,
+        AtrousConvolution<NaiveConvolution<ValidConvolution>,
+                          NaiveConvolution<FullConvolution>,
+                          NaiveConvolution<ValidConvolution>,
+                          arma::mat, arma::mat>*,
+        Convolution<NaiveConvolution<ValidConvolution>,
+                    NaiveConvolution<FullConvolution>,
+                    NaiveConvolution<ValidConvolution>,
+                    arma::mat, arma::mat>*,
+        TransposedConvolution<NaiveConvolution<ValidConvolution>,
+                              NaiveConvolution<ValidConvolution>,
+                              NaiveConvolution<ValidConvolution>,
+                              arma::mat, arma::mat>*
 >;
 
 template <typename... CustomLayers>
@@ -227,9 +241,9 @@ using LayerTypes = boost::variant<
     Add<arma::mat, arma::mat>*,
     AddMerge<arma::mat, arma::mat>*,
     AlphaDropout<arma::mat, arma::mat>*,
-    AtrousConvolution<NaiveConvolution<ValidConvolution>,
-                      NaiveConvolution<FullConvolution>,
-                      NaiveConvolution<ValidConvolution>,
+    AtrousConvolution<Im2ColConvolution<ValidConvolution>,
+                      Im2ColConvolution<FullConvolution>,
+                      Im2ColConvolution<ValidConvolution>,
                       arma::mat, arma::mat>*,
     BaseLayer<LogisticFunction, arma::mat, arma::mat>*,
     BaseLayer<IdentityFunction, arma::mat, arma::mat>*,
@@ -244,9 +258,9 @@ using LayerTypes = boost::variant<
     ConcatPerformance<NegativeLogLikelihood<arma::mat, arma::mat>,
                       arma::mat, arma::mat>*,
     Constant<arma::mat, arma::mat>*,
-    Convolution<NaiveConvolution<ValidConvolution>,
-                NaiveConvolution<FullConvolution>,
-                NaiveConvolution<ValidConvolution>, arma::mat, arma::mat>*,
+    Convolution<Im2ColConvolution<ValidConvolution>,
+                Im2ColConvolution<FullConvolution>,
+                Im2ColConvolution<ValidConvolution>, arma::mat, arma::mat>*,
     CReLU<arma::mat, arma::mat>*,
     DropConnect<arma::mat, arma::mat>*,
     Dropout<arma::mat, arma::mat>*,
@@ -273,9 +287,9 @@ using LayerTypes = boost::variant<
     Padding<arma::mat, arma::mat>*,
     PReLU<arma::mat, arma::mat>*,
     Softmax<arma::mat, arma::mat>*,
-    TransposedConvolution<NaiveConvolution<ValidConvolution>,
-            NaiveConvolution<ValidConvolution>,
-            NaiveConvolution<ValidConvolution>, arma::mat, arma::mat>*,
+    TransposedConvolution<Im2ColConvolution<ValidConvolution>,
+            Im2ColConvolution<ValidConvolution>,
+            Im2ColConvolution<ValidConvolution>, arma::mat, arma::mat>*,
     WeightNorm<arma::mat, arma::mat>*,
     MoreTypes,
     CustomLayers*...
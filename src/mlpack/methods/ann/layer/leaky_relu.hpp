@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LEAKYRELU_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -107,6 +108,15 @@ class LeakyReLU
   double alpha;
 }; // class LeakyReLU
 
+/**
+ * The Forward() function of the LeakyReLU layer only reads the layer.
+ */
+template<typename InputDataType, typename OutputDataType>
+struct IsReentrantLayer<LeakyReLU<InputDataType, OutputDataType> >
+{
+  const static bool value = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
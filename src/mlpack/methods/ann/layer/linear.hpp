@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LINEAR_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
 
 #include "layer_types.hpp"
@@ -125,7 +126,7 @@ class Linear
   OutputDataType& Gradient() { return gradient; }
 
   //! Modify the bias weights of the layer.
-  arma::mat& Bias() { return bias; }
+  OutputDataType& Bias() { return bias; }
 
   /**
    * Serialize the layer
@@ -165,6 +166,17 @@ class Linear
   RegularizerType regularizer;
 }; // class Linear
 
+/**
+ * The Forward() function of the Linear layer only reads the layer.
+ */
+template<typename InputDataType,
+         typename OutputDataType,
+         typename RegularizerType>
+struct IsReentrantLayer<Linear<InputDataType, OutputDataType, RegularizerType> >
+{
+  const static bool value = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LINEAR_NO_BIAS_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 #include <mlpack/methods/ann/regularizer/no_regularizer.hpp>
 
 #include "layer_types.hpp"
@@ -158,6 +159,18 @@ class LinearNoBias
   RegularizerType regularizer;
 }; // class LinearNoBias
 
+/**
+ * The Forward() function of the LinearNoBias layer only reads the layer.
+ */
+template<typename InputDataType,
+         typename OutputDataType,
+         typename RegularizerType>
+struct IsReentrantLayer<
+    LinearNoBias<InputDataType, OutputDataType, RegularizerType> >
+{
+  const static bool value = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
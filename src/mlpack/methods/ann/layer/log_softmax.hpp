@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_LAYER_LOG_SOFTMAX_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -89,6 +90,15 @@ class LogSoftMax
   OutputDataType outputParameter;
 }; // class LogSoftmax
 
+/**
+ * The Forward() function of the LogSoftMax layer only reads its input.
+ */
+template<typename InputDataType, typename OutputDataType>
+struct IsReentrantLayer<LogSoftMax<InputDataType, OutputDataType> >
+{
+  const static bool value = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
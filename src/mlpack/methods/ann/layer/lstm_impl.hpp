@@ -78,7 +78,7 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
 
     if (cell.is_empty())
     {
-      cell = arma::zeros(outSize, size * batchSize);
+      cell = arma::zeros<OutputDataType>(outSize, size * batchSize);
       outParameter = arma::zeros<OutputDataType>(
           outSize, (size + 1) * batchSize);
     }
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_ANN_LAYER_SOFTMAX_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -91,6 +92,15 @@ class Softmax
   OutputDataType outputParameter;
 }; // class Softmax
 
+/**
+ * The Forward() function of the Softmax layer only reads its input.
+ */
+template<typename InputDataType, typename OutputDataType>
+struct IsReentrantLayer<Softmax<InputDataType, OutputDataType> >
+{
+  const static bool value = true;
+};
+
 } // namespace ann
 } // namespace mlpack
 
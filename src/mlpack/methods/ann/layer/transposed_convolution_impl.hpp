@@ -257,43 +257,29 @@ void TransposedConvolution<
   output.set_size(outputWidth * outputHeight * outSize, batchSize);
   outputTemp = arma::Cube<eT>(output.memptr(), outputWidth, outputHeight,
       outSize * batchSize, false, false);
-  outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
-  {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
+  arma::Cube<eT> rotatedFilters;
+  Rotate180(weight, rotatedFilters);
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> convOutput, rotatedFilter;
-      Rotate180(weight.slice(outMapIdx), rotatedFilter);
-
-      if (strideWidth > 1 ||
-          strideHeight > 1 ||
-          paddingForward.PadWLeft() != 0 ||
-          paddingForward.PadWRight() != 0 ||
-          paddingForward.PadHTop() != 0 ||
-          paddingForward.PadHBottom() != 0)
-      {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), rotatedFilter, convOutput, 1, 1);
-      }
-      else
-      {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), rotatedFilter, convOutput, 1, 1);
-      }
-
-      outputTemp.slice(outMap) += convOutput;
-    }
+  // All of the convolutions of the batch are computed at once.
+  if (strideWidth > 1 ||
+      strideHeight > 1 ||
+      paddingForward.PadWLeft() != 0 ||
+      paddingForward.PadWRight() != 0 ||
+      paddingForward.PadHTop() != 0 ||
+      paddingForward.PadHBottom() != 0)
+  {
+    BatchConvolution<ForwardConvolutionRule>::Convolution(inputPaddedTemp,
+        rotatedFilters, outputTemp, inSize, 1, 1);
+  }
+  else
+  {
+    BatchConvolution<ForwardConvolutionRule>::Convolution(inputTemp,
+        rotatedFilters, outputTemp, inSize, 1, 1);
+  }
 
+  for (size_t outMap = 0; outMap < outSize * batchSize; outMap++)
     outputTemp.slice(outMap) += bias(outMap % outSize);
-  }
 }
 
 template<
@@ -334,35 +320,28 @@ void TransposedConvolution<
   gTemp = arma::Cube<eT>(g.memptr(), inputWidth, inputHeight, inSize *
       batchSize, false, false);
 
-  gTemp.zeros();
-
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  // The filters of the backward pass are the weights with the input and
+  // output maps swapped.
+  arma::Cube<eT> filters(weight.n_rows, weight.n_cols, weight.n_slices);
+  for (size_t outMap = 0; outMap < outSize; outMap++)
   {
-    if (outMap != 0 && outMap % outSize == 0)
+    for (size_t inMap = 0; inMap < inSize; inMap++)
     {
-      batchCount++;
-      outMapIdx = 0;
+      filters.slice(inMap * outSize + outMap) =
+          weight.slice(outMap * inSize + inMap);
     }
+  }
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      arma::Mat<eT> output;
-
-      if (paddingBackward.PadWLeft() != 0 || paddingBackward.PadWRight() != 0 ||
-          paddingBackward.PadHTop() != 0 || paddingBackward.PadHBottom() != 0)
-      {
-        BackwardConvolutionRule::Convolution(mappedErrorPadded.slice(outMap),
-            weight.slice(outMapIdx), output, strideWidth, strideHeight);
-      }
-      else
-      {
-        BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
-            weight.slice(outMapIdx), output, strideWidth, strideHeight);
-      }
-
-      gTemp.slice(inMap + batchCount * inSize) += output;
-    }
+  if (paddingBackward.PadWLeft() != 0 || paddingBackward.PadWRight() != 0 ||
+      paddingBackward.PadHTop() != 0 || paddingBackward.PadHBottom() != 0)
+  {
+    BatchConvolution<BackwardConvolutionRule>::Convolution(mappedErrorPadded,
+        filters, gTemp, outSize, strideWidth, strideHeight);
+  }
+  else
+  {
+    BatchConvolution<BackwardConvolutionRule>::Convolution(mappedError,
+        filters, gTemp, outSize, strideWidth, strideHeight);
   }
 }
 
@@ -393,45 +372,36 @@ void TransposedConvolution<
   gradient.set_size(weights.n_elem, 1);
   gradientTemp = arma::Cube<eT>(gradient.memptr(), weight.n_rows,
       weight.n_cols, weight.n_slices, false, false);
-  gradientTemp.zeros();
-
-  arma::Mat<eT> inputSlice, output, deltaSlice, rotatedOutput;
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  arma::Cube<eT> output;
+  if (strideWidth > 1 ||
+      strideHeight > 1 ||
+      paddingForward.PadWLeft() != 0 ||
+      paddingForward.PadWRight() != 0 ||
+      paddingForward.PadHTop() != 0 ||
+      paddingForward.PadHBottom() != 0)
   {
-    if (outMap != 0 && outMap % outSize == 0)
-    {
-      batchCount++;
-      outMapIdx = 0;
-    }
+    BatchConvolution<GradientConvolutionRule>::GradientConvolution(
+        inputPaddedTemp, mappedError, output, inSize, 1, 1);
+  }
+  else
+  {
+    BatchConvolution<GradientConvolutionRule>::GradientConvolution(inputTemp,
+        mappedError, output, inSize, 1, 1);
+  }
 
-    deltaSlice = mappedError.slice(outMap);
+  for (size_t i = 0; i < output.n_slices; ++i)
+    Rotate180(output.slice(i), gradientTemp.slice(i));
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
-    {
-      if (strideWidth > 1 ||
-          strideHeight > 1 ||
-          paddingForward.PadWLeft() != 0 ||
-          paddingForward.PadWRight() != 0 ||
-          paddingForward.PadHTop() != 0 ||
-          paddingForward.PadHBottom() != 0)
-      {
-        inputSlice = inputPaddedTemp.slice(inMap + batchCount * inSize);
-      }
-      else
-      {
-        inputSlice = inputTemp.slice(inMap + batchCount * inSize);
-      }
-
-      GradientConvolutionRule::Convolution(inputSlice, deltaSlice,
-          output, 1, 1);
-      Rotate180(output, rotatedOutput);
-      gradientTemp.slice(outMapIdx) += rotatedOutput;
-    }
+  // The gradient of the bias is summed over the batch, like the gradient of
+  // the weights.
+  for (size_t outMap = 0; outMap < outSize; outMap++)
+  {
+    eT biasGradient = 0;
+    for (size_t b = 0; b < batchSize; b++)
+      biasGradient += arma::accu(mappedError.slice(b * outSize + outMap));
 
-    gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
-        (outMap % outSize), 0) = arma::accu(mappedError.slices(outMap, outMap));
+    gradient(weight.n_elem + outMap) = biasGradient;
   }
 }
 
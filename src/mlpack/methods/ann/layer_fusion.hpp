@@ -0,0 +1,81 @@
+/**
+ * @file methods/ann/layer_fusion.hpp
+ *
+ * Functions that fuse consecutive layers of a network for inference: a
+ * BatchNorm layer is folded into the weights of the Linear, LinearNoBias or
+ * Convolution layer before it, and an element-wise activation layer is applied
+ * in place to the output of the layer before it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSION_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <memory>
+
+#include "visitor/forward_step_visitor.hpp"
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * A ForwardStep followed by an element-wise activation function that is
+ * applied in place to the output of the step, so that the activation needs
+ * neither its own output matrix nor its own pass over a cold buffer.
+ *
+ * @tparam MatType Type of the input and output of the step.
+ */
+template<typename MatType = arma::mat>
+struct FusedStep
+{
+  //! The step whose output the activation function is applied to.
+  ForwardStep<MatType> step;
+
+  //! The function that applies the activation function in place.
+  void (*activation)(MatType& x);
+
+  //! Execute the step and the activation function.
+  static void Call(void* fused, const MatType& input, MatType& output)
+  {
+    const FusedStep* f = static_cast<const FusedStep*>(fused);
+    f->step.function(f->step.layer, input, output);
+    f->activation(output);
+  }
+};
+
+/**
+ * If the given layer is a Linear, LinearNoBias or Convolution layer and the
+ * next layer is a BatchNorm layer in deterministic mode, replace the given
+ * layer by a copy whose weights and bias include the normalization of the
+ * BatchNorm layer.  For a BatchNorm layer with running mean mu, running
+ * variance sigma^2, scale gamma and shift beta, the weights of each output
+ * channel are multiplied by gamma / sqrt(sigma^2 + eps), and the bias becomes
+ * (b - mu) * gamma / sqrt(sigma^2 + eps) + beta.
+ *
+ * The copy is owned by the given list.  The copy holds the parameters at the
+ * time of the call; it doesn't see later changes of the original layers.
+ *
+ * @param layer The layer to fold the BatchNorm layer into.
+ * @param next The layer after the given layer.
+ * @param owned The list that takes ownership of the copy.
+ * @return Whether the BatchNorm layer was folded into the layer.
+ */
+template<typename... CustomLayers>
+bool FoldBatchNorm(LayerTypes<CustomLayers...>& layer,
+                   const LayerTypes<CustomLayers...>& next,
+                   std::vector<std::shared_ptr<void> >& owned);
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "layer_fusion_impl.hpp"
+
+#endif
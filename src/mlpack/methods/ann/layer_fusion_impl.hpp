@@ -0,0 +1,128 @@
+/**
+ * @file methods/ann/layer_fusion_impl.hpp
+ *
+ * Implementation of the layer fusion functions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_fusion.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename... CustomLayers>
+bool FoldBatchNorm(LayerTypes<CustomLayers...>& layer,
+                   const LayerTypes<CustomLayers...>& next,
+                   std::vector<std::shared_ptr<void> >& owned)
+{
+  BatchNorm<>* const* batchNormPtr = boost::get<BatchNorm<>*>(&next);
+  if (!batchNormPtr || !(*batchNormPtr)->Deterministic())
+    return false;
+
+  // The normalization of each channel is an affine map x * scale + shift.
+  const BatchNorm<>& batchNorm = **batchNormPtr;
+  const size_t channels = batchNorm.InputSize();
+  const arma::vec scale = batchNorm.Parameters().rows(0, channels - 1) /
+      arma::sqrt(batchNorm.TrainingVariance() + batchNorm.Epsilon());
+  const arma::vec shift = batchNorm.Parameters().rows(channels,
+      2 * channels - 1) - batchNorm.TrainingMean() % scale;
+
+  if (Linear<>* const* linearPtr = boost::get<Linear<>*>(&layer))
+  {
+    const Linear<>& linear = **linearPtr;
+    const size_t outSize = linear.OutputSize();
+    if (outSize % channels != 0)
+      return false;
+
+    Linear<>* folded = new Linear<>(linear.InputSize(), outSize);
+    owned.push_back(std::shared_ptr<void>(folded));
+    folded->Parameters() = linear.Parameters();
+    folded->Reset();
+
+    // Each channel of the BatchNorm layer covers outSize / channels outputs.
+    arma::mat weight(folded->Parameters().memptr(), outSize,
+        linear.InputSize(), false, true);
+    arma::vec rowScale = arma::vectorise(arma::repmat(scale.t(),
+        outSize / channels, 1));
+    arma::vec rowShift = arma::vectorise(arma::repmat(shift.t(),
+        outSize / channels, 1));
+    weight.each_col() %= rowScale;
+    folded->Bias() = folded->Bias() % rowScale + rowShift;
+
+    layer = folded;
+    return true;
+  }
+
+  if (LinearNoBias<>* const* linearPtr = boost::get<LinearNoBias<>*>(&layer))
+  {
+    // The shift needs a bias, so the copy is a Linear layer.
+    const LinearNoBias<>& linear = **linearPtr;
+    const size_t outSize = linear.OutputSize();
+    if (outSize % channels != 0)
+      return false;
+
+    Linear<>* folded = new Linear<>(linear.InputSize(), outSize);
+    owned.push_back(std::shared_ptr<void>(folded));
+    folded->Reset();
+
+    arma::mat weight(folded->Parameters().memptr(), outSize,
+        linear.InputSize(), false, true);
+    arma::vec rowScale = arma::vectorise(arma::repmat(scale.t(),
+        outSize / channels, 1));
+    weight = arma::reshape(linear.Parameters(), outSize, linear.InputSize());
+    weight.each_col() %= rowScale;
+    folded->Bias() = arma::vectorise(arma::repmat(shift.t(),
+        outSize / channels, 1));
+
+    layer = folded;
+    return true;
+  }
+
+  if (Convolution<>* const* convolutionPtr =
+      boost::get<Convolution<>*>(&layer))
+  {
+    // The copy needs to know the size of the input, which the layer only
+    // learns in its first forward pass.
+    const Convolution<>& convolution = **convolutionPtr;
+    if (convolution.OutputSize() != channels || convolution.InputWidth() == 0)
+      return false;
+
+    Convolution<>* folded = new Convolution<>(convolution.InputSize(),
+        convolution.OutputSize(), convolution.KernelWidth(),
+        convolution.KernelHeight(), convolution.StrideWidth(),
+        convolution.StrideHeight(),
+        std::tuple<size_t, size_t>(convolution.PadWLeft(),
+            convolution.PadWRight()),
+        std::tuple<size_t, size_t>(convolution.PadHTop(),
+            convolution.PadHBottom()),
+        convolution.InputWidth(), convolution.InputHeight());
+    owned.push_back(std::shared_ptr<void>(folded));
+    folded->Parameters() = convolution.Parameters();
+    folded->Reset();
+
+    // The filters of each output map are stored one after another.
+    const size_t filterSize = convolution.KernelWidth() *
+        convolution.KernelHeight() * convolution.InputSize();
+    arma::mat weight(folded->Parameters().memptr(), filterSize, channels,
+        false, true);
+    weight.each_row() %= scale.t();
+    folded->Bias() = folded->Bias() % scale + shift;
+
+    layer = folded;
+    return true;
+  }
+
+  return false;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
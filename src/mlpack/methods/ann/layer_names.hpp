@@ -58,7 +58,11 @@ class LayerNameVisitor : public boost::static_visitor<std::string>
    * @param * Given layer of type AtrousConvolution.
    * @return The string representation of the layer.
    */
-  std::string LayerString(AtrousConvolution<>* /*layer*/) const
+  template<typename ForwardConvolutionRule,
+           typename BackwardConvolutionRule,
+           typename GradientConvolutionRule>
+  std::string LayerString(AtrousConvolution<ForwardConvolutionRule,
+      BackwardConvolutionRule, GradientConvolutionRule>* /*layer*/) const
   {
     return "atrousconvolution";
   }
@@ -102,7 +106,11 @@ class LayerNameVisitor : public boost::static_visitor<std::string>
    * @param * Given layer of type Convolution.
    * @return The string representation of the layer.
    */
-  std::string LayerString(Convolution<>* /*layer*/) const
+  template<typename ForwardConvolutionRule,
+           typename BackwardConvolutionRule,
+           typename GradientConvolutionRule>
+  std::string LayerString(Convolution<ForwardConvolutionRule,
+      BackwardConvolutionRule, GradientConvolutionRule>* /*layer*/) const
   {
     return "convolution";
   }
@@ -235,7 +243,11 @@ class LayerNameVisitor : public boost::static_visitor<std::string>
    * @param * Given layer of type TransposedConvolution.
    * @return The string representation of the layer.
    */
-  std::string LayerString(TransposedConvolution<>* /*layer*/) const
+  template<typename ForwardConvolutionRule,
+           typename BackwardConvolutionRule,
+           typename GradientConvolutionRule>
+  std::string LayerString(TransposedConvolution<ForwardConvolutionRule,
+      BackwardConvolutionRule, GradientConvolutionRule>* /*layer*/) const
   {
     return "transposedconvolution";
   }
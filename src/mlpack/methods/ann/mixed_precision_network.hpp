@@ -0,0 +1,344 @@
+/**
+ * @file methods/ann/mixed_precision_network.hpp
+ *
+ * Definition of the MixedPrecisionNetwork class, which trains a network in
+ * single precision while the double-precision parameters of the network stay
+ * the master copy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MIXED_PRECISION_NETWORK_HPP
+#define MLPACK_METHODS_ANN_MIXED_PRECISION_NETWORK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <memory>
+
+#include "visitor/cast_layer_visitor.hpp"
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The resolved Forward(), Backward() and Gradient() calls of a copy of a layer
+ * that is trained in MatType, together with the functions that connect the
+ * copy to the parameters and the mode of the network.  Calling forward(layer,
+ * input, output) is the same as applying a ForwardVisitor to the layer, and
+ * likewise for the other functions.
+ *
+ * @tparam MatType Type of the input and output of the layer.
+ */
+template<typename MatType = arma::fmat>
+struct TrainingStep
+{
+  //! The type of the function that calls Forward() on the layer.
+  typedef void (*ForwardType)(void* layer,
+                              const MatType& input,
+                              MatType& output);
+
+  //! The type of the function that calls Backward() on the layer.
+  typedef void (*BackwardType)(void* layer,
+                               const MatType& output,
+                               const MatType& gy,
+                               MatType& g);
+
+  //! The type of the function that calls Gradient() on the layer.
+  typedef void (*GradientType)(void* layer,
+                               const MatType& input,
+                               const MatType& error);
+
+  //! The type of the function that points the parameters and the gradient of
+  //! the layer at the given matrices and returns the number of parameters.
+  typedef size_t (*WeightsType)(void* layer,
+                                MatType& parameters,
+                                MatType& gradient,
+                                const size_t offset);
+
+  //! The type of the function that sets the mode of the layer.
+  typedef void (*DeterministicType)(void* layer, const bool deterministic);
+
+  //! The type of the function that copies the state collected during training
+  //! back to the original layer.
+  typedef void (*StoreType)(const void* layer, void* original);
+
+  //! Return the TrainingStep of the given copy of the given layer.
+  template<typename LayerType, typename OriginalType>
+  static TrainingStep Create(LayerType* layer, OriginalType* original);
+
+  //! The function that calls Forward() on the layer.
+  ForwardType forward;
+
+  //! The function that calls Backward() on the layer.
+  BackwardType backward;
+
+  //! The function that calls Gradient() on the layer (NULL if the layer has
+  //! no parameters).
+  GradientType gradient;
+
+  //! The function that sets the parameters and the gradient of the layer.
+  WeightsType weights;
+
+  //! The function that sets the mode of the layer (NULL if the layer behaves
+  //! the same during training and inference).
+  DeterministicType deterministic;
+
+  //! The function that copies the state of the layer to the original layer.
+  StoreType store;
+
+  //! The copy of the layer.
+  void* layer;
+
+  //! The layer of the network the copy was made from.
+  void* original;
+
+ private:
+  //! Call Forward() on the given layer.
+  template<typename LayerType>
+  static void Forward(void* layer, const MatType& input, MatType& output);
+
+  //! Call Backward() on the given layer.
+  template<typename LayerType>
+  static void Backward(void* layer,
+                       const MatType& output,
+                       const MatType& gy,
+                       MatType& g);
+
+  //! Call Gradient() on the given layer.
+  template<typename LayerType>
+  static void Gradient(void* layer, const MatType& input, const MatType& error);
+
+  //! Point the parameters and the gradient of the given layer at the given
+  //! matrices.
+  template<typename LayerType>
+  static size_t Weights(void* layer,
+                        MatType& parameters,
+                        MatType& gradient,
+                        const size_t offset);
+
+  //! Set the mode of the given layer.
+  template<typename LayerType>
+  static void Deterministic(void* layer, const bool deterministic);
+
+  //! Copy the state of the given layer to the original layer.
+  template<typename LayerType, typename OriginalType>
+  static void Store(const void* layer, void* original);
+
+  //! Return the Gradient() call of a layer with parameters.
+  template<typename LayerType>
+  static typename std::enable_if<
+      HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+      GradientType>::type
+  GradientFunction();
+
+  //! Return NULL for a layer without parameters.
+  template<typename LayerType>
+  static typename std::enable_if<
+      !HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+      GradientType>::type
+  GradientFunction();
+
+  //! Return the function that sets the mode of a layer that has a mode.
+  template<typename LayerType>
+  static typename std::enable_if<
+      HasDeterministicCheck<LayerType, bool&(LayerType::*)(void)>::value,
+      DeterministicType>::type
+  DeterministicFunction();
+
+  //! Return NULL for a layer that has no mode.
+  template<typename LayerType>
+  static typename std::enable_if<
+      !HasDeterministicCheck<LayerType, bool&(LayerType::*)(void)>::value,
+      DeterministicType>::type
+  DeterministicFunction();
+
+  //! Point the parameters and the gradient of a layer with parameters at the
+  //! given matrices.
+  template<typename LayerType>
+  static typename std::enable_if<
+      HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+      size_t>::type
+  LayerWeights(LayerType* layer,
+               MatType& parameters,
+               MatType& gradient,
+               const size_t offset);
+
+  //! Do nothing for a layer without parameters.
+  template<typename LayerType>
+  static typename std::enable_if<
+      !HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+      size_t>::type
+  LayerWeights(LayerType* layer,
+               MatType& parameters,
+               MatType& gradient,
+               const size_t offset);
+
+  //! Reset a layer whose parameters were moved.
+  template<typename LayerType>
+  static typename std::enable_if<
+      HasResetCheck<LayerType, void(LayerType::*)()>::value, void>::type
+  ResetLayer(LayerType* layer);
+
+  //! Do nothing for a layer that has no Reset() function.
+  template<typename LayerType>
+  static typename std::enable_if<
+      !HasResetCheck<LayerType, void(LayerType::*)()>::value, void>::type
+  ResetLayer(LayerType* layer);
+
+  //! Copy the running statistics of a BatchNorm layer to the original layer.
+  static void StoreLayer(const BatchNorm<MatType, MatType>* layer,
+                         BatchNorm<arma::mat, arma::mat>* original);
+
+  //! Do nothing for the layers that only hold parameters.
+  template<typename LayerType, typename OriginalType>
+  static void StoreLayer(const LayerType* layer, OriginalType* original);
+};
+
+/**
+ * A MixedPrecisionNetwork trains a network in single precision (or any other
+ * MatType) with double-precision master weights.  It holds copies of the
+ * layers of the network that compute in MatType (see CastLayerVisitor); the
+ * parameters of the network itself stay in double precision and are the ones
+ * the optimizer updates.  Before each pass the master weights are converted
+ * to MatType, and after the backward pass the gradient is converted back to
+ * double precision, so the optimizer accumulates its updates in double
+ * precision while the forward and backward passes (the bulk of the work)
+ * touch half as much memory and use twice as wide SIMD lanes.
+ *
+ * The copies are made for one call of FFN::Train(): they hold pointers to the
+ * layers of the network, so the network must not change while the copies
+ * exist.  State that the copies collect during training (the running
+ * statistics of BatchNorm layers) is copied back to the layers of the network
+ * by Store().
+ *
+ * @code
+ * FFN<> model;
+ * // ... build the model ...
+ * model.MixedPrecision() = true;
+ * model.Train(data, responses, optimizer);
+ * @endcode
+ *
+ * @tparam MatType Matrix type used for the computations of the layers.
+ */
+template<typename MatType = arma::fmat>
+class MixedPrecisionNetwork
+{
+ public:
+  /**
+   * Create an empty network.
+   */
+  MixedPrecisionNetwork();
+
+  /**
+   * Copy the layers of the given network.  The layers must already know the
+   * size of their input (i.e. the network must have been used for a forward
+   * pass before).  Layers that can't be converted to MatType cause
+   * std::invalid_argument to be thrown.
+   *
+   * @param network Layers of the network, in order.
+   * @param numParameters Number of parameters of the network.
+   */
+  template<typename... CustomLayers>
+  void Build(std::vector<LayerTypes<CustomLayers...> >& network,
+             const size_t numParameters);
+
+  /**
+   * Remove all of the copies of the layers.
+   */
+  void Clear();
+
+  /**
+   * Set the mode of the copies of the layers.
+   *
+   * @param deterministic Whether the copies are used for inference.
+   */
+  void Deterministic(const bool deterministic);
+
+  /**
+   * Evaluate the network with the given master weights on the given points.
+   *
+   * @param parameters Double-precision parameters of the network.
+   * @param predictors Input points, one per column.
+   * @param responses Responses to the input points.
+   * @param outputLayer Output layer (loss function) of the network.
+   * @return The loss of the network on the given points.
+   */
+  template<typename OutputLayerType>
+  double Evaluate(const arma::mat& parameters,
+                  const arma::mat& predictors,
+                  const arma::mat& responses,
+                  OutputLayerType& outputLayer);
+
+  /**
+   * Evaluate the network with the given master weights on the given points
+   * like Evaluate(), and compute the gradient of the loss with respect to the
+   * parameters.
+   *
+   * @param parameters Double-precision parameters of the network.
+   * @param predictors Input points, one per column.
+   * @param responses Responses to the input points.
+   * @param outputLayer Output layer (loss function) of the network.
+   * @param gradient Double-precision gradient, of the size of parameters.
+   * @return The loss of the network on the given points.
+   */
+  template<typename OutputLayerType>
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const arma::mat& predictors,
+                              const arma::mat& responses,
+                              OutputLayerType& outputLayer,
+                              arma::mat& gradient);
+
+  /**
+   * Copy the state that the copies collected during training back to the
+   * layers of the network.
+   */
+  void Store();
+
+  //! Return whether the network is empty.
+  bool Empty() const { return steps.empty(); }
+
+ private:
+  //! Convert the master weights and the given points to MatType and pass the
+  //! points through the copies of the layers.
+  void Forward(const arma::mat& parameters, const arma::mat& predictors);
+
+  //! The steps of the copies of the layers.
+  std::vector<TrainingStep<MatType> > steps;
+
+  //! The copies of the layers.
+  std::vector<std::shared_ptr<void> > layers;
+
+  //! The parameters of the copies, converted from the master weights.
+  MatType parameters;
+
+  //! The gradient of the copies.
+  MatType gradient;
+
+  //! The input points, converted to MatType.
+  MatType input;
+
+  //! The responses, converted to MatType.
+  MatType target;
+
+  //! The error of the output layer.
+  MatType error;
+
+  //! The output of each layer.
+  std::vector<MatType> activations;
+
+  //! The error of each layer.
+  std::vector<MatType> deltas;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "mixed_precision_network_impl.hpp"
+
+#endif
@@ -0,0 +1,361 @@
+/**
+ * @file methods/ann/mixed_precision_network_impl.hpp
+ *
+ * Implementation of the MixedPrecisionNetwork class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MIXED_PRECISION_NETWORK_IMPL_HPP
+#define MLPACK_METHODS_ANN_MIXED_PRECISION_NETWORK_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mixed_precision_network.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename MatType>
+template<typename LayerType, typename OriginalType>
+TrainingStep<MatType> TrainingStep<MatType>::Create(LayerType* layer,
+                                                    OriginalType* original)
+{
+  TrainingStep step;
+  step.forward = &Forward<LayerType>;
+  step.backward = &Backward<LayerType>;
+  step.gradient = GradientFunction<LayerType>();
+  step.weights = &Weights<LayerType>;
+  step.deterministic = DeterministicFunction<LayerType>();
+  step.store = &Store<LayerType, OriginalType>;
+  step.layer = layer;
+  step.original = original;
+  return step;
+}
+
+template<typename MatType>
+template<typename LayerType>
+void TrainingStep<MatType>::Forward(void* layer,
+                                    const MatType& input,
+                                    MatType& output)
+{
+  static_cast<LayerType*>(layer)->Forward(input, output);
+}
+
+template<typename MatType>
+template<typename LayerType>
+void TrainingStep<MatType>::Backward(void* layer,
+                                     const MatType& output,
+                                     const MatType& gy,
+                                     MatType& g)
+{
+  static_cast<LayerType*>(layer)->Backward(output, gy, g);
+}
+
+template<typename MatType>
+template<typename LayerType>
+void TrainingStep<MatType>::Gradient(void* layer,
+                                     const MatType& input,
+                                     const MatType& error)
+{
+  LayerType* l = static_cast<LayerType*>(layer);
+  l->Gradient(input, error, l->Gradient());
+}
+
+template<typename MatType>
+template<typename LayerType>
+size_t TrainingStep<MatType>::Weights(void* layer,
+                                      MatType& parameters,
+                                      MatType& gradient,
+                                      const size_t offset)
+{
+  return LayerWeights(static_cast<LayerType*>(layer), parameters, gradient,
+      offset);
+}
+
+template<typename MatType>
+template<typename LayerType>
+void TrainingStep<MatType>::Deterministic(void* layer,
+                                          const bool deterministic)
+{
+  static_cast<LayerType*>(layer)->Deterministic() = deterministic;
+}
+
+template<typename MatType>
+template<typename LayerType, typename OriginalType>
+void TrainingStep<MatType>::Store(const void* layer, void* original)
+{
+  StoreLayer(static_cast<const LayerType*>(layer),
+      static_cast<OriginalType*>(original));
+}
+
+template<typename MatType>
+template<typename LayerType>
+typename std::enable_if<
+    HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+    typename TrainingStep<MatType>::GradientType>::type
+TrainingStep<MatType>::GradientFunction()
+{
+  return &Gradient<LayerType>;
+}
+
+template<typename MatType>
+template<typename LayerType>
+typename std::enable_if<
+    !HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+    typename TrainingStep<MatType>::GradientType>::type
+TrainingStep<MatType>::GradientFunction()
+{
+  return NULL;
+}
+
+template<typename MatType>
+template<typename LayerType>
+typename std::enable_if<
+    HasDeterministicCheck<LayerType, bool&(LayerType::*)(void)>::value,
+    typename TrainingStep<MatType>::DeterministicType>::type
+TrainingStep<MatType>::DeterministicFunction()
+{
+  return &Deterministic<LayerType>;
+}
+
+template<typename MatType>
+template<typename LayerType>
+typename std::enable_if<
+    !HasDeterministicCheck<LayerType, bool&(LayerType::*)(void)>::value,
+    typename TrainingStep<MatType>::DeterministicType>::type
+TrainingStep<MatType>::DeterministicFunction()
+{
+  return NULL;
+}
+
+template<typename MatType>
+template<typename LayerType>
+typename std::enable_if<
+    HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+    size_t>::type
+TrainingStep<MatType>::LayerWeights(LayerType* layer,
+                                    MatType& parameters,
+                                    MatType& gradient,
+                                    const size_t offset)
+{
+  const size_t rows = layer->Parameters().n_rows;
+  const size_t cols = layer->Parameters().n_cols;
+
+  // This works like WeightSetVisitor and GradientSetVisitor.
+  layer->Parameters() = MatType(parameters.memptr() + offset, rows, cols,
+      false, false);
+  layer->Gradient() = MatType(gradient.memptr() + offset, rows, cols, false,
+      false);
+  ResetLayer(layer);
+
+  return rows * cols;
+}
+
+template<typename MatType>
+template<typename LayerType>
+typename std::enable_if<
+    !HasParametersCheck<LayerType, MatType&(LayerType::*)()>::value,
+    size_t>::type
+TrainingStep<MatType>::LayerWeights(LayerType* /* layer */,
+                                    MatType& /* parameters */,
+                                    MatType& /* gradient */,
+                                    const size_t /* offset */)
+{
+  return 0;
+}
+
+template<typename MatType>
+template<typename LayerType>
+typename std::enable_if<
+    HasResetCheck<LayerType, void(LayerType::*)()>::value, void>::type
+TrainingStep<MatType>::ResetLayer(LayerType* layer)
+{
+  layer->Reset();
+}
+
+template<typename MatType>
+template<typename LayerType>
+typename std::enable_if<
+    !HasResetCheck<LayerType, void(LayerType::*)()>::value, void>::type
+TrainingStep<MatType>::ResetLayer(LayerType* /* layer */)
+{
+  /* Nothing to do here. */
+}
+
+template<typename MatType>
+void TrainingStep<MatType>::StoreLayer(
+    const BatchNorm<MatType, MatType>* layer,
+    BatchNorm<arma::mat, arma::mat>* original)
+{
+  original->TrainingMean() =
+      arma::conv_to<arma::mat>::from(layer->TrainingMean());
+  original->TrainingVariance() =
+      arma::conv_to<arma::mat>::from(layer->TrainingVariance());
+}
+
+template<typename MatType>
+template<typename LayerType, typename OriginalType>
+void TrainingStep<MatType>::StoreLayer(const LayerType* /* layer */,
+                                       OriginalType* /* original */)
+{
+  /* Nothing to do here. */
+}
+
+template<typename MatType>
+MixedPrecisionNetwork<MatType>::MixedPrecisionNetwork()
+{
+  /* Nothing to do here. */
+}
+
+template<typename MatType>
+template<typename... CustomLayers>
+void MixedPrecisionNetwork<MatType>::Build(
+    std::vector<LayerTypes<CustomLayers...> >& network,
+    const size_t numParameters)
+{
+  Clear();
+  try
+  {
+    CastLayerVisitor<MatType, TrainingStep<MatType> > castVisitor(layers,
+        false);
+    for (size_t i = 0; i < network.size(); ++i)
+      steps.push_back(boost::apply_visitor(castVisitor, network[i]));
+  }
+  catch (...)
+  {
+    // Don't leave a partial network behind.
+    Clear();
+    throw;
+  }
+
+  // The parameters of the copies are laid out like the master weights, so
+  // that they can be converted in one pass.
+  parameters.set_size(numParameters, 1);
+  gradient.zeros(numParameters, 1);
+  size_t offset = 0;
+  for (size_t i = 0; i < steps.size(); ++i)
+  {
+    offset += steps[i].weights(steps[i].layer, parameters, gradient,
+        offset);
+  }
+
+  if (offset != numParameters)
+  {
+    Clear();
+    throw std::invalid_argument("MixedPrecisionNetwork::Build(): the number "
+        "of parameters of the layers doesn't match the network!");
+  }
+
+  activations.resize(steps.size());
+  deltas.resize(steps.size());
+}
+
+template<typename MatType>
+void MixedPrecisionNetwork<MatType>::Clear()
+{
+  steps.clear();
+  layers.clear();
+  parameters.reset();
+  gradient.reset();
+  activations.clear();
+  deltas.clear();
+}
+
+template<typename MatType>
+void MixedPrecisionNetwork<MatType>::Deterministic(const bool deterministic)
+{
+  for (size_t i = 0; i < steps.size(); ++i)
+  {
+    if (steps[i].deterministic)
+      steps[i].deterministic(steps[i].layer, deterministic);
+  }
+}
+
+template<typename MatType>
+template<typename OutputLayerType>
+double MixedPrecisionNetwork<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const arma::mat& predictors,
+    const arma::mat& responses,
+    OutputLayerType& outputLayer)
+{
+  Forward(parameters, predictors);
+
+  target.set_size(responses.n_rows, responses.n_cols);
+  std::copy(responses.begin(), responses.end(), target.begin());
+
+  return outputLayer.Forward(activations.back(), target);
+}
+
+template<typename MatType>
+template<typename OutputLayerType>
+double MixedPrecisionNetwork<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const arma::mat& predictors,
+    const arma::mat& responses,
+    OutputLayerType& outputLayer,
+    arma::mat& gradient)
+{
+  const double res = Evaluate(parameters, predictors, responses, outputLayer);
+  outputLayer.Backward(activations.back(), target, error);
+
+  // The first layer doesn't need its error, like in FFN::Backward().
+  const size_t n = steps.size();
+  for (size_t i = n - 1; i > 0; --i)
+  {
+    steps[i].backward(steps[i].layer, activations[i],
+        (i == n - 1) ? error : deltas[i + 1], deltas[i]);
+  }
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (steps[i].gradient)
+    {
+      steps[i].gradient(steps[i].layer, (i == 0) ? input : activations[i - 1],
+          (i == n - 1) ? error : deltas[i + 1]);
+    }
+  }
+
+  // This also converts the gradient to double precision.
+  std::copy(this->gradient.begin(), this->gradient.end(), gradient.begin());
+
+  return res;
+}
+
+template<typename MatType>
+void MixedPrecisionNetwork<MatType>::Store()
+{
+  for (size_t i = 0; i < steps.size(); ++i)
+    steps[i].store(steps[i].layer, steps[i].original);
+}
+
+template<typename MatType>
+void MixedPrecisionNetwork<MatType>::Forward(const arma::mat& parameters,
+                                             const arma::mat& predictors)
+{
+  if (steps.empty())
+  {
+    throw std::logic_error("MixedPrecisionNetwork::Forward(): the network is "
+        "empty; call Build() first!");
+  }
+
+  // The copies of the layers see the current master weights.  The layers
+  // point into the converted parameters, so they are overwritten in place.
+  std::copy(parameters.begin(), parameters.end(), this->parameters.begin());
+
+  input.set_size(predictors.n_rows, predictors.n_cols);
+  std::copy(predictors.begin(), predictors.end(), input.begin());
+
+  for (size_t i = 0; i < steps.size(); ++i)
+  {
+    steps[i].forward(steps[i].layer, (i == 0) ? input : activations[i - 1],
+        activations[i]);
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file methods/ann/visitor/activation_function_visitor.hpp
+ *
+ * This file provides an abstraction that returns a function applying the
+ * element-wise activation function of a layer in place.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_ACTIVATION_FUNCTION_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_ACTIVATION_FUNCTION_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * ActivationFunctionVisitor returns a function that applies the activation
+ * function of the given layer to a matrix in place, if the layer only applies
+ * an element-wise activation function (i.e. it is a BaseLayer), and NULL
+ * otherwise.
+ *
+ * @tparam MatType Type of the matrix the function is applied to.
+ */
+template<typename MatType = arma::mat>
+class ActivationFunctionVisitor :
+    public boost::static_visitor<void (*)(MatType&)>
+{
+ public:
+  //! The type of the function that applies the activation function.
+  typedef void (*FunctionType)(MatType& x);
+
+  //! Return the function of the element-wise activation layer.
+  template<typename ActivationFunction>
+  FunctionType operator()(
+      BaseLayer<ActivationFunction, arma::mat, arma::mat>* layer) const;
+
+  //! Return NULL for all other layers.
+  template<typename LayerType>
+  FunctionType operator()(LayerType* layer) const;
+
+  FunctionType operator()(MoreTypes layer) const;
+
+ private:
+  //! Apply the given activation function to each element of the matrix.
+  template<typename ActivationFunction>
+  static void Apply(MatType& x);
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "activation_function_visitor_impl.hpp"
+
+#endif
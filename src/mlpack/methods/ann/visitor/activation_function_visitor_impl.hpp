@@ -0,0 +1,60 @@
+/**
+ * @file methods/ann/visitor/activation_function_visitor_impl.hpp
+ *
+ * Implementation of the ActivationFunctionVisitor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_ACTIVATION_FUNCTION_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_ACTIVATION_FUNCTION_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "activation_function_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! ActivationFunctionVisitor visitor class.
+template<typename MatType>
+template<typename ActivationFunction>
+inline typename ActivationFunctionVisitor<MatType>::FunctionType
+ActivationFunctionVisitor<MatType>::operator()(
+    BaseLayer<ActivationFunction, arma::mat, arma::mat>* /* layer */) const
+{
+  return &ActivationFunctionVisitor::Apply<ActivationFunction>;
+}
+
+template<typename MatType>
+template<typename LayerType>
+inline typename ActivationFunctionVisitor<MatType>::FunctionType
+ActivationFunctionVisitor<MatType>::operator()(LayerType* /* layer */) const
+{
+  return NULL;
+}
+
+template<typename MatType>
+inline typename ActivationFunctionVisitor<MatType>::FunctionType
+ActivationFunctionVisitor<MatType>::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+template<typename MatType>
+template<typename ActivationFunction>
+inline void ActivationFunctionVisitor<MatType>::Apply(MatType& x)
+{
+  // The matrix versions of some activation functions can't work in place, so
+  // the scalar version is applied to each element.
+  x.transform([](const typename MatType::elem_type value)
+      {
+        return ActivationFunction::Fn(value);
+      });
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file methods/ann/visitor/cast_layer_visitor.hpp
+ *
+ * This file provides an abstraction that creates a copy of a layer that works
+ * on another matrix type (e.g. arma::fmat), for inference or training in lower
+ * precision.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_CAST_LAYER_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_CAST_LAYER_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/visitor/forward_step_visitor.hpp>
+
+#include <boost/variant.hpp>
+
+#include <memory>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * CastLayerVisitor creates a copy of the given layer that works on MatType,
+ * converts the parameters of the layer to MatType, and returns the step of
+ * the copy (by default its ForwardStep).  The copies are owned by the list of
+ * layers that is given to the constructor.  Layers that behave differently
+ * during training are set to the given mode; copies for inference are set to
+ * deterministic mode.
+ *
+ * Only the layers that are commonly used in feed-forward networks can be
+ * copied; for any other layer std::invalid_argument is thrown.
+ *
+ * @tparam MatType Matrix type the copies work on.
+ * @tparam StepType Type of the step that is returned for each copy; it must
+ *     provide StepType::Create(copy, original).
+ */
+template<typename MatType, typename StepType = ForwardStep<MatType> >
+class CastLayerVisitor : public boost::static_visitor<StepType>
+{
+ public:
+  /**
+   * Create the visitor; the copies of the layers are stored in the given list.
+   *
+   * @param layers The list that takes ownership of the copies.
+   * @param deterministic Whether the copies are used for inference.
+   */
+  CastLayerVisitor(std::vector<std::shared_ptr<void> >& layers,
+                   const bool deterministic = true);
+
+  //! Copy the layer.
+  template<typename RegularizerType>
+  StepType operator()(
+      Linear<arma::mat, arma::mat, RegularizerType>* layer) const;
+
+  template<typename RegularizerType>
+  StepType operator()(
+      LinearNoBias<arma::mat, arma::mat, RegularizerType>* layer) const;
+
+  template<typename ActivationFunction>
+  StepType operator()(
+      BaseLayer<ActivationFunction, arma::mat, arma::mat>* layer) const;
+
+  StepType operator()(Add<arma::mat, arma::mat>* layer) const;
+
+  StepType operator()(BatchNorm<arma::mat, arma::mat>* layer) const;
+
+  template<
+      typename ForwardConvolutionRule,
+      typename BackwardConvolutionRule,
+      typename GradientConvolutionRule
+  >
+  StepType operator()(
+      Convolution<ForwardConvolutionRule, BackwardConvolutionRule,
+          GradientConvolutionRule, arma::mat, arma::mat>* layer) const;
+
+  StepType operator()(Dropout<arma::mat, arma::mat>* layer) const;
+
+  StepType operator()(LeakyReLU<arma::mat, arma::mat>* layer) const;
+
+  StepType operator()(
+      LogSoftMax<arma::mat, arma::mat>* layer) const;
+
+  StepType operator()(Softmax<arma::mat, arma::mat>* layer) const;
+
+  //! Throw for all of the layers that can't be copied.
+  template<typename LayerType>
+  StepType operator()(LayerType* layer) const;
+
+  StepType operator()(MoreTypes layer) const;
+
+ private:
+  //! The list that owns the copies of the layers.
+  std::vector<std::shared_ptr<void> >& layers;
+
+  //! Whether the copies are set to deterministic mode.
+  bool deterministic;
+
+  //! Take ownership of the given copy of the given layer and return its step.
+  template<typename LayerType, typename OriginalType>
+  StepType Step(LayerType* copy, OriginalType* original) const;
+
+  //! Convert the given parameters to MatType.
+  static MatType Cast(const arma::mat& parameters)
+  {
+    return arma::conv_to<MatType>::from(parameters);
+  }
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "cast_layer_visitor_impl.hpp"
+
+#endif
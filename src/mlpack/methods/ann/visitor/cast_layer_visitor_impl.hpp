@@ -0,0 +1,177 @@
+/**
+ * @file methods/ann/visitor/cast_layer_visitor_impl.hpp
+ *
+ * Implementation of the CastLayerVisitor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_CAST_LAYER_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_CAST_LAYER_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "cast_layer_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! CastLayerVisitor visitor class.
+template<typename MatType, typename StepType>
+inline CastLayerVisitor<MatType, StepType>::CastLayerVisitor(
+    std::vector<std::shared_ptr<void> >& layers,
+    const bool deterministic) :
+    layers(layers),
+    deterministic(deterministic)
+{
+  /* Nothing to do here. */
+}
+
+template<typename MatType, typename StepType>
+template<typename RegularizerType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    Linear<arma::mat, arma::mat, RegularizerType>* layer) const
+{
+  Linear<MatType, MatType, RegularizerType>* copy =
+      new Linear<MatType, MatType, RegularizerType>(layer->InputSize(),
+      layer->OutputSize());
+  copy->Parameters() = Cast(layer->Parameters());
+  copy->Reset();
+  return Step(copy, layer);
+}
+
+template<typename MatType, typename StepType>
+template<typename RegularizerType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    LinearNoBias<arma::mat, arma::mat, RegularizerType>* layer) const
+{
+  LinearNoBias<MatType, MatType, RegularizerType>* copy =
+      new LinearNoBias<MatType, MatType, RegularizerType>(layer->InputSize(),
+      layer->OutputSize());
+  copy->Parameters() = Cast(layer->Parameters());
+  copy->Reset();
+  return Step(copy, layer);
+}
+
+template<typename MatType, typename StepType>
+template<typename ActivationFunction>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    BaseLayer<ActivationFunction, arma::mat, arma::mat>* layer) const
+{
+  return Step(new BaseLayer<ActivationFunction, MatType, MatType>(), layer);
+}
+
+template<typename MatType, typename StepType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    Add<arma::mat, arma::mat>* layer) const
+{
+  Add<MatType, MatType>* copy = new Add<MatType, MatType>(layer->OutputSize());
+  copy->Parameters() = Cast(layer->Parameters());
+  return Step(copy, layer);
+}
+
+template<typename MatType, typename StepType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    BatchNorm<arma::mat, arma::mat>* layer) const
+{
+  BatchNorm<MatType, MatType>* copy = new BatchNorm<MatType, MatType>(
+      layer->InputSize(), layer->Epsilon(), layer->Average(),
+      layer->Momentum());
+  // Reset() initializes the scale and shift, so the parameters are copied
+  // into the memory of the copy afterwards.
+  copy->Reset();
+  const MatType parameters = Cast(layer->Parameters());
+  copy->Parameters() = parameters;
+  copy->TrainingMean() = Cast(layer->TrainingMean());
+  copy->TrainingVariance() = Cast(layer->TrainingVariance());
+  copy->Deterministic() = deterministic;
+  return Step(copy, layer);
+}
+
+template<typename MatType, typename StepType>
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule
+>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    Convolution<ForwardConvolutionRule, BackwardConvolutionRule,
+        GradientConvolutionRule, arma::mat, arma::mat>* layer) const
+{
+  typedef Convolution<ForwardConvolutionRule, BackwardConvolutionRule,
+      GradientConvolutionRule, MatType, MatType> CopyType;
+
+  // The padding of the layer is already resolved, so the copy doesn't need the
+  // padding type.
+  CopyType* copy = new CopyType(layer->InputSize(), layer->OutputSize(),
+      layer->KernelWidth(), layer->KernelHeight(), layer->StrideWidth(),
+      layer->StrideHeight(),
+      std::tuple<size_t, size_t>(layer->PadWLeft(), layer->PadWRight()),
+      std::tuple<size_t, size_t>(layer->PadHTop(), layer->PadHBottom()),
+      layer->InputWidth(), layer->InputHeight());
+  copy->Parameters() = Cast(layer->Parameters());
+  copy->Reset();
+  return Step(copy, layer);
+}
+
+template<typename MatType, typename StepType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    Dropout<arma::mat, arma::mat>* layer) const
+{
+  Dropout<MatType, MatType>* copy = new Dropout<MatType, MatType>(
+      layer->Ratio());
+  copy->Deterministic() = deterministic;
+  return Step(copy, layer);
+}
+
+template<typename MatType, typename StepType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    LeakyReLU<arma::mat, arma::mat>* layer) const
+{
+  return Step(new LeakyReLU<MatType, MatType>(layer->Alpha()), layer);
+}
+
+template<typename MatType, typename StepType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    LogSoftMax<arma::mat, arma::mat>* layer) const
+{
+  return Step(new LogSoftMax<MatType, MatType>(), layer);
+}
+
+template<typename MatType, typename StepType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    Softmax<arma::mat, arma::mat>* layer) const
+{
+  return Step(new Softmax<MatType, MatType>(), layer);
+}
+
+template<typename MatType, typename StepType>
+template<typename LayerType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    LayerType* /* layer */) const
+{
+  throw std::invalid_argument("CastLayerVisitor: the network contains a "
+      "layer that can't be converted to another matrix type!");
+}
+
+template<typename MatType, typename StepType>
+inline StepType CastLayerVisitor<MatType, StepType>::operator()(
+    MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+template<typename MatType, typename StepType>
+template<typename LayerType, typename OriginalType>
+inline StepType CastLayerVisitor<MatType, StepType>::Step(
+    LayerType* copy, OriginalType* original) const
+{
+  layers.push_back(std::shared_ptr<void>(copy));
+  return StepType::Create(copy, original);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @file methods/ann/visitor/forward_step_visitor.hpp
+ *
+ * This file provides an abstraction that resolves the Forward() function of a
+ * layer ahead of time, so that it can be called later without visiting the
+ * layer again.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_FORWARD_STEP_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_FORWARD_STEP_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * A resolved call of the Forward() function of one layer: calling
+ * function(layer, input, output) is the same as applying a ForwardVisitor to
+ * the layer.
+ *
+ * @tparam MatType Type of the input and output of the layer.
+ */
+template<typename MatType = arma::mat>
+struct ForwardStep
+{
+  //! The type of the function that calls Forward() on the layer.
+  typedef void (*FunctionType)(void* layer,
+                               const MatType& input,
+                               MatType& output);
+
+  //! Execute the Forward() function of the given layer.
+  template<typename LayerType>
+  static void Call(void* layer, const MatType& input, MatType& output)
+  {
+    static_cast<LayerType*>(layer)->Forward(input, output);
+  }
+
+  //! Return the ForwardStep of the given layer.
+  template<typename LayerType>
+  static ForwardStep Create(LayerType* layer)
+  {
+    ForwardStep step;
+    step.function = &Call<LayerType>;
+    step.layer = layer;
+    step.reentrant = IsReentrantLayer<LayerType>::value;
+    return step;
+  }
+
+  //! Return the ForwardStep of the given copy of a layer (the original layer
+  //! isn't needed for inference).
+  template<typename LayerType, typename OriginalType>
+  static ForwardStep Create(LayerType* layer, OriginalType* /* original */)
+  {
+    return Create(layer);
+  }
+
+  //! The function that calls Forward() on the layer.
+  FunctionType function;
+
+  //! The layer.
+  void* layer;
+
+  //! Whether several threads can call the function on the layer at once.
+  bool reentrant;
+};
+
+/**
+ * ForwardStepVisitor returns the ForwardStep of the given layer.
+ */
+class ForwardStepVisitor : public boost::static_visitor<ForwardStep<> >
+{
+ public:
+  //! Return the ForwardStep of the layer.
+  template<typename LayerType>
+  ForwardStep<> operator()(LayerType* layer) const;
+
+  ForwardStep<> operator()(MoreTypes layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "forward_step_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @file methods/ann/visitor/forward_step_visitor_impl.hpp
+ *
+ * Implementation of the ForwardStepVisitor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_FORWARD_STEP_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_FORWARD_STEP_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "forward_step_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! ForwardStepVisitor visitor class.
+template<typename LayerType>
+inline ForwardStep<> ForwardStepVisitor::operator()(LayerType* layer) const
+{
+  return ForwardStep<>::Create(layer);
+}
+
+inline ForwardStep<> ForwardStepVisitor::operator()(MoreTypes layer) const
+{
+  return layer.apply_visitor(*this);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
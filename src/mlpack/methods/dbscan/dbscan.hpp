@@ -15,9 +15,10 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
+#include "grid_range_search.hpp"
 #include <boost/dynamic_bitset.hpp>
 
 namespace mlpack {
@@ -44,6 +45,12 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * The range searches and the merging of neighborhoods run in parallel when
+ * OpenMP is available: neighborhoods are merged through a lock-free union-find
+ * structure, and the clustering does not depend on the order in which they
+ * are merged.  For data with one to three dimensions, GridRangeSearch can be
+ * given as the RangeSearchType to avoid building a tree entirely.
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -57,7 +64,7 @@ class DBSCAN
    * Construct the DBSCAN object with the given parameters.  The batchMode
    * parameter should be set to false in the case where RAM issues will be
    * encountered (i.e. if the dataset is very large or if epsilon is large).
-   * When batchMode is false, each point will be searched iteratively, which
+   * When batchMode is false, the points will be searched in blocks, which
    * could be slower but will use less memory.
    *
    * @param epsilon Size of range query.
@@ -131,17 +138,16 @@ class DBSCAN
 
   /**
    * Performs DBSCAN clustering on the data, returning the number of clusters and
-   * also the list of cluster assignments.  This searches each point iteratively,
-   * and can save on RAM usage.  It may be slower than the batch search with a
-   * dual-tree algorithm.
+   * also the list of cluster assignments.  This searches the points in blocks
+   * of fixed size, and can save on RAM usage.  It may be slower than the batch
+   * search with a dual-tree algorithm.
    *
    * @param data Dataset to cluster.
-   * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf ConcurrentUnionFind structure that will be modified.
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+                        emst::ConcurrentUnionFind& uf);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -149,12 +155,11 @@ class DBSCAN
    * so it is well suited for dual-tree or naive search.
    *
    * @param data Dataset to cluster.
-   * @param assignments Assignments for each point.
-   * @param uf UnionFind structure that will be modified.
+   * @param uf ConcurrentUnionFind structure that will be modified.
    */
   template<typename MatType>
   void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+                    emst::ConcurrentUnionFind& uf);
 };
 
 } // namespace dbscan
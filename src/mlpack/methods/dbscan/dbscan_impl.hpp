@@ -100,8 +100,8 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
+  // Initialize the ConcurrentUnionFind object.
+  emst::ConcurrentUnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
   if (batchMode)
@@ -109,9 +109,10 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
   else
     PointwiseCluster(data, uf);
 
-  // Now set assignments.
+  // Now set assignments.  All unions are done, so the components are final.
   assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     assignments[i] = uf.Find(i);
 
   // Get a count of all clusters.
@@ -142,31 +143,40 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 
 /**
  * Performs DBSCAN clustering on the data, returning the number of clusters and
- * also the list of cluster assignments.  This searches each point iteratively,
- * and can save on RAM usage.  It may be slower than the batch search with a
- * dual-tree algorithm.
+ * also the list of cluster assignments.  This searches the points in blocks of
+ * fixed size, and can save on RAM usage.  It may be slower than the batch
+ * search with a dual-tree algorithm.
  */
 template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
+  // Searching a block of points at once lets the range search work on many
+  // points in parallel, while only the results of one block are kept.
+  const size_t blockSize = 10000;
+
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
   {
-    if (i % 10000 == 0 && i > 0)
-      Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    if (begin > 0)
+      Log::Info << "DBSCAN clustering on point " << begin << "..." << std::endl;
 
-    // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
-        distances);
+    // Do the range search for only the points in this block.
+    rangeSearch.Search(data.cols(begin, end - 1), math::Range(0.0, epsilon),
+        neighbors, distances);
 
     // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (omp_size_t i = 0; i < (omp_size_t) (end - begin); ++i)
+    {
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+        uf.Union(begin + i, neighbors[i][j]);
+    }
   }
 }
 
@@ -179,21 +189,27 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
   // For each point, find the points in epsilon-nighborhood and their distances.
+  // The range search object was already trained in Cluster().
   std::vector<std::vector<size_t>> neighbors;
   std::vector<std::vector<double>> distances;
   Log::Info << "Performing range search." << std::endl;
-  rangeSearch.Train(data);
   rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
   Log::Info << "Range search complete." << std::endl;
 
-  // Now loop over all points.
+  // The point selection policy may keep state, so the order of the points is
+  // found before the unions are done in parallel.
+  arma::Col<size_t> order(data.n_cols);
   for (size_t i = 0; i < data.n_cols; ++i)
+    order[i] = pointSelector.Select(i, data);
+
+  // Now loop over all points.
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
-    // Get the next index.
-    const size_t index = pointSelector.Select(i, data);
+    const size_t index = order[i];
     for (size_t j = 0; j < neighbors[index].size(); ++j)
       uf.Union(index, neighbors[index][j]);
   }
@@ -59,6 +59,9 @@ PROGRAM_INFO("DBSCAN clustering",
     PRINT_PARAM_STRING("single_mode") + " parameter will force single-tree "
     "search (as opposed to the default dual-tree search), and '" +
     PRINT_PARAM_STRING("naive") + " will force brute-force range search."
+    "  For data with one to three dimensions, such as geospatial data, " +
+    PRINT_PARAM_STRING("grid") + " will use a uniform grid with cells the "
+    "size of the radius instead of a tree, which is usually faster."
     "\n\n"
     "An example usage to run DBSCAN on the dataset in " +
     PRINT_DATASET("input") + " with a radius of 0.5 and a minimum cluster size"
@@ -89,14 +92,26 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_FLAG("grid", "If set, grid-based range search (not tree-based) will "
+    "be used; only for data with one to three dimensions.", "g");
+
+// Set the search mode of the range search object.
+template<typename RangeSearchType>
+void SetSearchMode(RangeSearchType& rs)
+{
+  if (IO::HasParam("single_mode"))
+    rs.SingleMode() = true;
+}
+
+// Grid-based range search has no search modes.
+void SetSearchMode(GridRangeSearch& /* rs */) { }
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType, typename PointSelectionPolicy>
 void RunDBSCAN(RangeSearchType rs,
                PointSelectionPolicy pointSelector = PointSelectionPolicy())
 {
-  if (IO::HasParam("single_mode"))
-    rs.SingleMode() = true;
+  SetSearchMode(rs);
 
   // Load dataset.
   arma::mat dataset = std::move(IO::GetParam<arma::mat>("input"));
@@ -143,6 +158,9 @@ static void mlpackMain()
       "no output will be saved");
 
   ReportIgnoredParam({{ "naive", true }}, "single_mode");
+  ReportIgnoredParam({{ "grid", true }}, "naive");
+  ReportIgnoredParam({{ "grid", true }}, "single_mode");
+  ReportIgnoredParam({{ "grid", true }}, "tree_type");
 
   RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star", "x",
       "hilbert-r", "r-plus", "r-plus-plus", "ball" }, true,
@@ -156,8 +174,12 @@ static void mlpackMain()
   RequireParamValue<int>("min_size", [](int y) { return y > 0; },
       true, "invalid value of min_size specified");
 
-  // Fire off naive search if needed.
-  if (IO::HasParam("naive"))
+  // Fire off grid or naive search if needed.
+  if (IO::HasParam("grid"))
+  {
+    ChoosePointSelectionPolicy<GridRangeSearch>();
+  }
+  else if (IO::HasParam("naive"))
   {
     RangeSearch<> rs(true);
     ChoosePointSelectionPolicy(rs);
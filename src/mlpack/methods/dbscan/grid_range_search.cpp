@@ -0,0 +1,191 @@
+/**
+ * @file methods/dbscan/grid_range_search.cpp
+ *
+ * Implementation of the grid-based range search used by DBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "grid_range_search.hpp"
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/util/log.hpp>
+
+using namespace mlpack;
+using namespace mlpack::dbscan;
+
+GridRangeSearch::GridRangeSearch() :
+    cellWidth(0.0),
+    bitsPerDimension(0)
+{
+  // Nothing to do.
+}
+
+void GridRangeSearch::Train(arma::mat referenceSet)
+{
+  if (referenceSet.n_rows == 0 || referenceSet.n_rows > 3)
+  {
+    std::ostringstream oss;
+    oss << "GridRangeSearch::Train(): the grid can only be used with data "
+        << "that has one to three dimensions (given data has "
+        << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  this->referenceSet = std::move(referenceSet);
+  oldFromNew.set_size(this->referenceSet.n_cols);
+  for (size_t i = 0; i < oldFromNew.n_elem; ++i)
+    oldFromNew[i] = i;
+
+  // The grid is built lazily, since its cell size depends on the range.
+  cellWidth = 0.0;
+  cells.clear();
+}
+
+void GridRangeSearch::BuildGrid(const double width)
+{
+  if (!(width > 0.0) || std::isinf(width))
+  {
+    std::ostringstream oss;
+    oss << "GridRangeSearch::Search(): the upper bound of the range must be "
+        << "positive and finite (given " << width << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t dims = referenceSet.n_rows;
+  minimums = arma::min(referenceSet, 1);
+  const arma::vec extents = arma::max(referenceSet, 1) - minimums;
+
+  // The coordinates of a cell are packed into one key, so the number of cells
+  // in each dimension must fit in its share of the bits.
+  bitsPerDimension = 63 / dims;
+  const double cellLimit = std::pow(2.0, (double) bitsPerDimension) - 1.0;
+  maxCells.set_size(dims);
+  for (size_t d = 0; d < dims; ++d)
+  {
+    const double lastCell = std::floor(extents[d] / width);
+    if (lastCell >= cellLimit)
+    {
+      std::ostringstream oss;
+      oss << "GridRangeSearch::Search(): the range upper bound " << width
+          << " is too small for the extent of the data in dimension " << d
+          << " (" << extents[d] << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+    maxCells[d] = (size_t) lastCell;
+  }
+
+  // Compute the key of the cell of each point.
+  arma::Col<size_t> keys(referenceSet.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+  {
+    size_t key = 0;
+    for (size_t d = 0; d < dims; ++d)
+    {
+      const size_t cell = std::min((size_t) std::floor(
+          (referenceSet(d, i) - minimums[d]) / width), maxCells[d]);
+      key |= cell << (d * bitsPerDimension);
+    }
+    keys[i] = key;
+  }
+
+  // Sort the points by cell, so the points of each cell are contiguous.
+  const arma::uvec order = arma::sort_index(keys);
+  referenceSet = referenceSet.cols(order);
+  oldFromNew = oldFromNew.elem(order);
+  keys = keys.elem(order);
+
+  cells.clear();
+  size_t begin = 0;
+  for (size_t i = 1; i <= keys.n_elem; ++i)
+  {
+    if (i == keys.n_elem || keys[i] != keys[begin])
+    {
+      cells[keys[begin]] = std::make_pair(begin, i);
+      begin = i;
+    }
+  }
+
+  cellWidth = width;
+  Log::Info << "GridRangeSearch: built a grid of " << cells.size()
+      << " non-empty cells with side " << cellWidth << "." << std::endl;
+}
+
+void GridRangeSearch::Search(const arma::mat& querySet,
+                             const math::Range& range,
+                             std::vector<std::vector<size_t>>& neighbors,
+                             std::vector<std::vector<double>>& distances)
+{
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "GridRangeSearch::Search(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet.n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.clear();
+  neighbors.resize(querySet.n_cols);
+  distances.clear();
+  distances.resize(querySet.n_cols);
+
+  if (referenceSet.n_cols == 0)
+    return;
+
+  if (cells.empty() || range.Hi() != cellWidth)
+    BuildGrid(range.Hi());
+
+  // Each query looks at its own cell and the cells next to it in every
+  // dimension.
+  const size_t dims = referenceSet.n_rows;
+  const size_t numNeighborCells = (dims == 1) ? 3 : (dims == 2) ? 9 : 27;
+
+  #pragma omp parallel for schedule(dynamic, 256)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    // The cell of the query, which may lie outside the grid.
+    double queryCell[3];
+    for (size_t d = 0; d < dims; ++d)
+      queryCell[d] = std::floor((querySet(d, i) - minimums[d]) / cellWidth);
+
+    for (size_t c = 0; c < numNeighborCells; ++c)
+    {
+      // Decode the offset of this cell, and skip it if it is not in the grid.
+      size_t key = 0;
+      size_t offsets = c;
+      bool inGrid = true;
+      for (size_t d = 0; d < dims; ++d)
+      {
+        const double cell = queryCell[d] + (double) (offsets % 3) - 1.0;
+        offsets /= 3;
+        if (cell < 0.0 || cell > (double) maxCells[d])
+        {
+          inGrid = false;
+          break;
+        }
+        key |= ((size_t) cell) << (d * bitsPerDimension);
+      }
+
+      if (!inGrid)
+        continue;
+
+      const auto it = cells.find(key);
+      if (it == cells.end())
+        continue;
+
+      for (size_t j = it->second.first; j < it->second.second; ++j)
+      {
+        const double distance = metric::EuclideanDistance::Evaluate(
+            querySet.col(i), referenceSet.col(j));
+        if (range.Contains(distance))
+        {
+          neighbors[i].push_back(oldFromNew[j]);
+          distances[i].push_back(distance);
+        }
+      }
+    }
+  }
+}
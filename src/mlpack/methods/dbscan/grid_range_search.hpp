@@ -0,0 +1,115 @@
+/**
+ * @file methods/dbscan/grid_range_search.hpp
+ *
+ * A range search class that buckets the reference points into a uniform grid.
+ * For low-dimensional data this is faster than tree-based range search, and it
+ * can be used as the RangeSearchType of DBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_GRID_RANGE_SEARCH_HPP
+#define MLPACK_METHODS_DBSCAN_GRID_RANGE_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/range.hpp>
+
+#include <unordered_map>
+
+namespace mlpack {
+namespace dbscan {
+
+/**
+ * GridRangeSearch answers Euclidean range queries on data with one to three
+ * dimensions.  The reference points are bucketed into a grid of cubic cells
+ * whose side is the upper bound of the range, so every reference point in
+ * range of a query lies either in the cell of the query or in one of the
+ * 3^d cells around it.  This avoids building and traversing a tree, which makes
+ * it a good fit for DBSCAN on geospatial data, where every search uses the same
+ * small radius.
+ *
+ * The grid is built by the first call to Search() and reused as long as the
+ * upper bound of the range does not change.  The queries of a Search() call are
+ * answered in parallel when OpenMP is available.
+ *
+ * Only the part of the RangeSearch interface that DBSCAN needs is provided,
+ * so this class can be given as the RangeSearchType template parameter of
+ * DBSCAN:
+ *
+ * @code
+ * DBSCAN<GridRangeSearch> dbscan(epsilon, minPoints);
+ * dbscan.Cluster(data, assignments);
+ * @endcode
+ */
+class GridRangeSearch
+{
+ public:
+  /**
+   * Create the GridRangeSearch object.  Train() must be called before
+   * Search().
+   */
+  GridRangeSearch();
+
+  /**
+   * Set the reference set.  Any existing grid is discarded; the new grid is
+   * built by the next call to Search().
+   *
+   * @param referenceSet Set of reference points (with one to three
+   *     dimensions).
+   */
+  void Train(arma::mat referenceSet);
+
+  /**
+   * Search for all reference points in the given range of each point in the
+   * query set.  neighbors[i] and distances[i] will hold the indices of the
+   * reference points in range of the i'th query point and their distances, in
+   * no particular order.
+   *
+   * @param querySet Set of query points.
+   * @param range The range of distances in which to search.
+   * @param neighbors Object which will hold the list of neighbors for each
+   *     point which fell into the given range, for each query point.
+   * @param distances Object which will hold the list of distances for each
+   *     point which fell into the given range, for each query point.
+   */
+  void Search(const arma::mat& querySet,
+              const math::Range& range,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances);
+
+  //! Get the side of the grid cells (0 if the grid has not been built).
+  double CellWidth() const { return cellWidth; }
+
+  //! Get the number of non-empty grid cells.
+  size_t NumCells() const { return cells.size(); }
+
+ private:
+  /**
+   * Sort the reference points by grid cell, with cells of the given side, and
+   * record where the points of each cell begin and end.
+   */
+  void BuildGrid(const double width);
+
+  //! The reference points, sorted by grid cell once the grid is built.
+  arma::mat referenceSet;
+  //! The original index of each point in referenceSet.
+  arma::Col<size_t> oldFromNew;
+
+  //! The side of the grid cells.
+  double cellWidth;
+  //! The lowest coordinate of the reference points in each dimension.
+  arma::vec minimums;
+  //! The index of the last cell in each dimension.
+  arma::Col<size_t> maxCells;
+  //! The number of bits of a cell key used by each dimension.
+  size_t bitsPerDimension;
+  //! The range of reference points in each non-empty cell, indexed by key.
+  std::unordered_map<size_t, std::pair<size_t, size_t>> cells;
+};
+
+} // namespace dbscan
+} // namespace mlpack
+
+#endif
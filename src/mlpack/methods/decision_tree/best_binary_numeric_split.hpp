@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_DECISION_TREE_BEST_BINARY_NUMERIC_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "numeric_split_traits.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -63,6 +64,39 @@ class BestBinaryNumericSplit
       arma::Col<typename VecType::elem_type>& classProbabilities,
       AuxiliarySplitInfo<typename VecType::elem_type>& aux);
 
+  /**
+   * Check if we can split a node, like SplitIfBetter(), when the points of the
+   * node are already sorted in ascending order of the dimension.  This lets
+   * DecisionTree sort each dimension once for the whole tree instead of at
+   * every node.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param sortedData The sorted values of the dimension to check for a split
+   *      in.
+   * @param sortedLabels Labels for each point, in the same order.
+   * @param numClasses Number of classes in the dataset.
+   * @param sortedWeights Weights associated with labels, in the same order.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetterSorted(
+      const double bestGain,
+      const VecType& sortedData,
+      const arma::Row<size_t>& sortedLabels,
+      const size_t numClasses,
+      const WeightVecType& sortedWeights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
   /**
    * Returns 2, since the binary split always has two children.
    */
@@ -87,6 +121,16 @@ class BestBinaryNumericSplit
       const AuxiliarySplitInfo<ElemType>& /* aux */);
 };
 
+//! BestBinaryNumericSplit can search presorted points.
+template<typename FitnessFunction>
+class NumericSplitTraits<BestBinaryNumericSplit<FitnessFunction>>
+{
+ public:
+  static const bool SupportsSortedData = true;
+  static const bool UsesBins = false;
+  static const bool SplitsOnThreshold = true;
+};
+
 } // namespace tree
 } // namespace mlpack
 
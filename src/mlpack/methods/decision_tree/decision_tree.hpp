@@ -17,6 +17,8 @@
 #include "gini_gain.hpp"
 #include "information_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
+#include "numeric_split_traits.hpp"
 #include "all_categorical_split.hpp"
 #include "all_dimension_select.hpp"
 #include <type_traits>
@@ -30,6 +32,18 @@ namespace tree {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * When OpenMP is available, the dimensions of large nodes are searched in
+ * parallel.  If every dimension is searched at every node (AllDimensionSelect),
+ * the children of large nodes are also built in parallel; random dimension
+ * selectors build the children in order, so that the dimensions they draw
+ * don't depend on the order in which threads run.  Either way, the resulting
+ * tree is the same as with serial training.  If the numeric split type
+ * supports it (see NumericSplitTraits) and every dimension is searched at every
+ * node, the numeric dimensions of large datasets are only sorted once, at the
+ * root.  If the numeric split type uses bins (like HistogramNumericSplit),
+ * the numeric dimensions are instead quantized once, at the root, and each
+ * node searches class histograms of the bins.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -505,6 +519,14 @@ class DecisionTree :
   typedef typename CategoricalSplit::template AuxiliarySplitInfo<ElemType>
       CategoricalAuxiliarySplitInfo;
 
+  //! RandomForest trains its trees on bootstrap samples of a shared dataset.
+  template<typename, typename, template<typename> class,
+           template<typename> class, typename>
+  friend class RandomForest;
+
+  //! CompiledForest copies the nodes of the tree into its own layout.
+  friend class CompiledForest;
+
   /**
    * Calculate the class probabilities of the given labels.
    */
@@ -513,31 +535,104 @@ class DecisionTree :
                                    const size_t numClasses,
                                    const WeightsRowType& weights);
 
+  //! Nodes with at least this many points search their dimensions in
+  //! parallel.
+  static const size_t ParallelSplitCutoff = 1000;
+  //! Nodes with at least this many points build their children in parallel,
+  //! if every dimension is searched at every node.
+  static const size_t ParallelBuildCutoff = 10000;
+  //! Trees trained on at least this many points sort the numeric dimensions
+  //! once, when the split type and dimension selection allow it.
+  static const size_t PresortCutoff = 10000;
+
+  /**
+   * Train on the points of the data with the given indices, which may contain
+   * repeats (as in a bootstrap sample).  The data is only read; the nodes hold
+   * ranges of the list of point indices instead.  The labels and weights are
+   * indexed like the columns of the data.  The dimension selector must already
+   * know the dimensionality of the data.
+   *
+   * @param data Dataset to train on.
+   * @param points Indices of the points of the data to train on.
+   * @param datasetInfo Type information for each dimension.
+   * @param labels Labels for each point in the data.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels (ignored if UseWeights is false).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, typename MatType>
+  double Train(const MatType& data,
+               arma::Col<size_t> points,
+               const data::DatasetInfo& datasetInfo,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const arma::rowvec& weights,
+               const size_t minimumLeafSize,
+               const double minimumGainSplit,
+               const size_t maximumDepth,
+               DimensionSelectionType& dimensionSelector);
+
+  /**
+   * Train on the given points of the data like the Train() method above, with
+   * the data already quantized by QuantizeData().  This lets several trees
+   * trained on the same data (like those of a RandomForest) share one
+   * quantization.
+   *
+   * @param data Dataset to train on.
+   * @param points Indices of the points of the data to train on.
+   * @param binnedData Bin of each point in each numeric dimension (empty if
+   *      the numeric split type does not use bins).
+   * @param binBoundaries Boundaries between the bins of each dimension.
+   * @param datasetInfo Type information for each dimension.
+   * @param labels Labels for each point in the data.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels (ignored if UseWeights is false).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, typename MatType>
+  double Train(const MatType& data,
+               arma::Col<size_t> points,
+               const arma::Mat<unsigned char>& binnedData,
+               const std::vector<arma::vec>& binBoundaries,
+               const data::DatasetInfo& datasetInfo,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const arma::rowvec& weights,
+               const size_t minimumLeafSize,
+               const double minimumGainSplit,
+               const size_t maximumDepth,
+               DimensionSelectionType& dimensionSelector);
+
   /**
    * Corresponding to the public Train() method, this method is designed for
-   * avoiding unnecessary copies during training.  This function is called to
-   * train children.
+   * avoiding unnecessary copies during training.  The data is only read; the
+   * nodes hold ranges of a list of point indices instead.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
-   * @param count Number of points in this node.
    * @param datasetInfo Type information for each dimension.
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels (ignored if UseWeights is false).
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
-  double Train(MatType& data,
-               const size_t begin,
-               const size_t count,
+  double Train(const MatType& data,
                const data::DatasetInfo& datasetInfo,
-               arma::Row<size_t>& labels,
+               const arma::Row<size_t>& labels,
                const size_t numClasses,
-               arma::rowvec& weights,
+               const arma::rowvec& weights,
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
@@ -545,31 +640,224 @@ class DecisionTree :
 
   /**
    * Corresponding to the public Train() method, this method is designed for
-   * avoiding unnecessary copies during training.  This method is called for
-   * training children.
+   * avoiding unnecessary copies during training, when all dimensions are
+   * numeric.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
-   * @param count Number of points in this node.
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels (ignored if UseWeights is false).
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
-  double Train(MatType& data,
-               const size_t begin,
-               const size_t count,
-               arma::Row<size_t>& labels,
+  double Train(const MatType& data,
+               const arma::Row<size_t>& labels,
                const size_t numClasses,
-               arma::rowvec& weights,
+               const arma::rowvec& weights,
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
                DimensionSelectionType& dimensionSelector);
+
+  /**
+   * Train this node on the points in the given range of the list of points,
+   * and then its children recursively.  Splitting the node reorders the range
+   * (and the same range of each presorted list) so that the points of each
+   * child are contiguous.
+   *
+   * @param data Dataset to train on.
+   * @param points Indices of the points in the data, ordered by node.
+   * @param sortedPoints If not empty, the points ordered by node and then
+   *      sorted by each numeric dimension (one column per dimension).
+   * @param binnedData If not empty, the bin of each point in each numeric
+   *      dimension (one column per dimension).
+   * @param binBoundaries The boundaries between the bins of each dimension.
+   * @param histograms The class histograms of the bins of the node in each
+   *      dimension, if already known (otherwise empty, or with empty
+   *      histograms).  They are cleared once the node no longer needs them.
+   * @param begin Index of the first point of this node in points.
+   * @param count Number of points in this node.
+   * @param datasetInfo Type information for each dimension.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of all the labels (ignored if UseWeights is false).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<bool UseWeights, typename MatType>
+  double TrainNode(const MatType& data,
+                   arma::Col<size_t>& points,
+                   arma::Mat<size_t>& sortedPoints,
+                   const arma::Mat<unsigned char>& binnedData,
+                   const std::vector<arma::vec>& binBoundaries,
+                   std::vector<arma::mat>& histograms,
+                   const size_t begin,
+                   const size_t count,
+                   const data::DatasetInfo& datasetInfo,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const arma::rowvec& weights,
+                   const size_t minimumLeafSize,
+                   const double minimumGainSplit,
+                   const size_t maximumDepth,
+                   DimensionSelectionType& dimensionSelector);
+
+  /**
+   * Search one dimension of the points of a node for a split with gain better
+   * than bestGain, with the categorical or numeric split type (on the
+   * histogram of the dimension, if the data is quantized).  On success the
+   * gain of the split is returned and the split information is stored in
+   * splitInfo and the auxiliary split information; otherwise DBL_MAX is
+   * returned.
+   */
+  template<bool UseWeights, typename MatType>
+  static double SearchDimension(const double bestGain,
+                                const MatType& data,
+                                const size_t dimension,
+                                const arma::Col<size_t>& points,
+                                const arma::Mat<size_t>& sortedPoints,
+                                const std::vector<arma::vec>& binBoundaries,
+                                const std::vector<arma::mat>& histograms,
+                                const size_t begin,
+                                const size_t count,
+                                const data::DatasetInfo& datasetInfo,
+                                const arma::Row<size_t>& labels,
+                                const arma::Row<size_t>& nodeLabels,
+                                const size_t numClasses,
+                                const arma::rowvec& weights,
+                                const arma::rowvec& nodeWeights,
+                                const size_t minimumLeafSize,
+                                const double minimumGainSplit,
+                                arma::vec& splitInfo,
+                                NumericAuxiliarySplitInfo& numericAux,
+                                CategoricalAuxiliarySplitInfo& categoricalAux);
+
+  /**
+   * Call the numeric split type on the sorted values of a dimension, with
+   * SplitIfBetterSorted() if the split type supports it, and SplitIfBetter()
+   * otherwise.
+   */
+  template<bool UseWeights, typename VecType>
+  static double NumericSplitIfBetterSorted(
+      const double bestGain,
+      const VecType& sortedData,
+      const arma::Row<size_t>& sortedLabels,
+      const size_t numClasses,
+      const arma::rowvec& sortedWeights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      NumericAuxiliarySplitInfo& aux,
+      const std::true_type& /* supportsSortedData */);
+
+  //! Call SplitIfBetter() for a split type that does not use sorted values.
+  template<bool UseWeights, typename VecType>
+  static double NumericSplitIfBetterSorted(
+      const double bestGain,
+      const VecType& sortedData,
+      const arma::Row<size_t>& sortedLabels,
+      const size_t numClasses,
+      const arma::rowvec& sortedWeights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      NumericAuxiliarySplitInfo& aux,
+      const std::false_type& /* supportsSortedData */);
+
+  /**
+   * Call SplitIfBetterHistogram() of the numeric split type on the class
+   * histogram of a quantized dimension.
+   */
+  template<bool UseWeights>
+  static double NumericSplitIfBetterHistogram(
+      const double bestGain,
+      const arma::mat& histogram,
+      const arma::vec& boundaries,
+      const size_t numClasses,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      NumericAuxiliarySplitInfo& aux,
+      const std::true_type& /* usesBins */);
+
+  //! Histograms are only built for split types that use bins.
+  template<bool UseWeights>
+  static double NumericSplitIfBetterHistogram(
+      const double bestGain,
+      const arma::mat& histogram,
+      const arma::vec& boundaries,
+      const size_t numClasses,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      NumericAuxiliarySplitInfo& aux,
+      const std::false_type& /* usesBins */);
+
+  /**
+   * Quantize each numeric dimension of the data with the numeric split type,
+   * if it uses bins; otherwise, binnedData and binBoundaries are left empty.
+   *
+   * @param data Dataset to quantize.
+   * @param datasetInfo Type information for each dimension.
+   * @param binnedData Matrix to store the bin of each point in, with one column
+   *      per dimension.
+   * @param binBoundaries Vector to store the boundaries between the bins of
+   *      each dimension in.
+   */
+  template<typename MatType>
+  static void QuantizeData(const MatType& data,
+                           const data::DatasetInfo& datasetInfo,
+                           arma::Mat<unsigned char>& binnedData,
+                           std::vector<arma::vec>& binBoundaries);
+
+  /**
+   * Quantize each numeric dimension of the data with the numeric split type.
+   *
+   * @param data Dataset to quantize.
+   * @param datasetInfo Type information for each dimension.
+   * @param binnedData Matrix to store the bin of each point in, with one column
+   *      per dimension.
+   * @param binBoundaries Vector to store the boundaries between the bins of
+   *      each dimension in.
+   */
+  template<typename MatType>
+  static void QuantizeData(const MatType& data,
+                           const data::DatasetInfo& datasetInfo,
+                           arma::Mat<unsigned char>& binnedData,
+                           std::vector<arma::vec>& binBoundaries,
+                           const std::true_type& /* usesBins */);
+
+  //! The numeric split type does not use bins, so nothing is quantized.
+  template<typename MatType>
+  static void QuantizeData(const MatType& data,
+                           const data::DatasetInfo& datasetInfo,
+                           arma::Mat<unsigned char>& binnedData,
+                           std::vector<arma::vec>& binBoundaries,
+                           const std::false_type& /* usesBins */);
+
+  /**
+   * Build the class histogram of the bins of one dimension for the points in
+   * the given range of the list of points, in the layout that
+   * SplitIfBetterHistogram() expects.
+   */
+  template<bool UseWeights>
+  static void BuildHistogram(const arma::Mat<unsigned char>& binnedData,
+                             const size_t dimension,
+                             const size_t numBins,
+                             const arma::Col<size_t>& points,
+                             const size_t begin,
+                             const size_t count,
+                             const arma::Row<size_t>& labels,
+                             const size_t numClasses,
+                             const arma::rowvec& weights,
+                             arma::mat& histogram);
 };
 
 /**
@@ -52,7 +52,7 @@ DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
+  Train<false>(tmpData, datasetInfo, tmpLabels, numClasses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -91,7 +91,7 @@ DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
+  Train<false>(tmpData, tmpLabels, numClasses, weights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -134,7 +134,7 @@ DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
+  Train<true>(tmpData, datasetInfo, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -176,7 +176,7 @@ DecisionTree<FitnessFunction,
   TrueWeightsType tmpWeights(std::move(weights));
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
+  Train<true>(tmpData, datasetInfo, tmpLabels, numClasses,
               tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
@@ -220,7 +220,7 @@ DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
+  Train<true>(tmpData, tmpLabels, numClasses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -266,7 +266,7 @@ DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
+  Train<true>(tmpData, tmpLabels, numClasses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -490,7 +490,7 @@ double DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+  return Train<false>(tmpData, datasetInfo, tmpLabels,
       numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -539,7 +539,7 @@ double DecisionTree<FitnessFunction,
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
+  return Train<false>(tmpData, tmpLabels, numClasses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -595,7 +595,7 @@ double DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+  return Train<true>(tmpData, datasetInfo, tmpLabels,
       numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -650,7 +650,7 @@ double DecisionTree<FitnessFunction,
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
+  return Train<true>(tmpData, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -669,13 +669,209 @@ double DecisionTree<FitnessFunction,
                     DimensionSelectionType,
                     ElemType,
                     NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  // A default DatasetInfo marks every dimension as numeric.
+  const data::DatasetInfo datasetInfo(data.n_rows);
+  return Train<UseWeights>(data, datasetInfo, labels, numClasses, weights,
+      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+}
+
+//! Train on the given data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  // Train on every point.
+  arma::Col<size_t> points(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    points[i] = i;
+
+  return Train<UseWeights>(data, std::move(points), datasetInfo, labels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train on the given points of the data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::Col<size_t> points,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  // If the numeric split works on histograms, quantize each numeric dimension
+  // once here, and keep the bin of each point as a byte.
+  arma::Mat<unsigned char> binnedData;
+  std::vector<arma::vec> binBoundaries;
+  QuantizeData(data, datasetInfo, binnedData, binBoundaries);
+
+  return Train<UseWeights>(data, std::move(points), binnedData, binBoundaries,
+      datasetInfo, labels, numClasses, weights, minimumLeafSize,
+      minimumGainSplit, maximumDepth, dimensionSelector);
+}
+
+//! Train on the given points of the data, which is already quantized.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::Col<size_t> points,
+    const arma::Mat<unsigned char>& binnedData,
+    const std::vector<arma::vec>& binBoundaries,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType& dimensionSelector)
+{
+  // Each node holds a contiguous range of the list of points; the data itself
+  // is never reordered.
+  // If the numeric split can search presorted points and every dimension is
+  // searched at every node, sort each numeric dimension once here.  Each node
+  // then holds the same range of every sorted list, and splitting a node
+  // partitions those ranges, which is cheaper than sorting at every node.
+  arma::Mat<size_t> sortedPoints;
+  if (NumericSplitTraits<NumericSplit>::SupportsSortedData &&
+      std::is_same<DimensionSelectionType, AllDimensionSelect>::value &&
+      points.n_elem >= PresortCutoff && maximumDepth != 1)
+  {
+    sortedPoints.set_size(points.n_elem, data.n_rows);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+    {
+      if (datasetInfo.Type(d) != data::Datatype::numeric)
+        continue;
+
+      arma::Row<typename MatType::elem_type> values(points.n_elem);
+      for (size_t i = 0; i < points.n_elem; ++i)
+        values[i] = data(d, points[i]);
+
+      const arma::uvec order = arma::sort_index(values);
+      for (size_t i = 0; i < order.n_elem; ++i)
+        sortedPoints(i, d) = points[order[i]];
+    }
+  }
+
+  std::vector<arma::mat> histograms;
+
+  // The recursion is started by a single thread; TrainNode() then creates
+  // tasks for large nodes, which the other threads pick up.  The smallest
+  // nodes that create tasks are those that search their dimensions in
+  // parallel.  If the tree is already being built inside a parallel region
+  // (for instance by RandomForest), the tasks are run by the threads of that
+  // region instead.
+  bool startParallelRegion = (points.n_elem >= ParallelSplitCutoff);
+  #ifdef HAS_OPENMP
+    startParallelRegion = startParallelRegion && (omp_get_level() == 0);
+  #endif
+
+  double gain = 0.0;
+  if (startParallelRegion)
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = TrainNode<UseWeights>(data, points, sortedPoints, binnedData,
+          binBoundaries, histograms, 0, points.n_elem, datasetInfo, labels,
+          numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector);
+    }
+  }
+  else
+  {
+    gain = TrainNode<UseWeights>(data, points, sortedPoints, binnedData,
+        binBoundaries, histograms, 0, points.n_elem, datasetInfo, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+        dimensionSelector);
+  }
+
+  return gain;
+}
+
+//! Train the node holding the given range of points, and its children.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::TrainNode(
+    const MatType& data,
+    arma::Col<size_t>& points,
+    arma::Mat<size_t>& sortedPoints,
+    const arma::Mat<unsigned char>& binnedData,
+    const std::vector<arma::vec>& binBoundaries,
+    std::vector<arma::mat>& histograms,
     const size_t begin,
     const size_t count,
     const data::DatasetInfo& datasetInfo,
-    arma::Row<size_t>& labels,
+    const arma::Row<size_t>& labels,
     const size_t numClasses,
-    arma::rowvec& weights,
+    const arma::rowvec& weights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
@@ -686,68 +882,127 @@ double DecisionTree<FitnessFunction,
     delete children[i];
   children.clear();
 
+  // Gather the labels and weights of the points in this node.
+  arma::Row<size_t> nodeLabels(count);
+  arma::rowvec nodeWeights(UseWeights ? count : 0);
+  for (size_t i = 0; i < count; ++i)
+  {
+    nodeLabels[i] = labels[points[begin + i]];
+    if (UseWeights)
+      nodeWeights[i] = weights[points[begin + i]];
+  }
+
   // Look through the list of dimensions and obtain the gain of the best split.
-  // We'll cache the best numeric and categorical split auxiliary information in
-  // numericAux and categoricalAux (and clear them later if we make no split),
-  // and use classProbabilities as auxiliary information.  Later we'll overwrite
-  // classProbabilities to the empirical class probabilities if we do not split.
-  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
-      labels.subvec(begin, begin + count - 1),
-      numClasses,
-      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  // We'll keep the split information of the best dimension in
+  // classProbabilities and the auxiliary split information (and clear the
+  // latter later if we make no split).  Later we'll overwrite
+  // classProbabilities to the empirical class probabilities if we do not
+  // split.
+  double bestGain = FitnessFunction::template Evaluate<UseWeights>(nodeLabels,
+      numClasses, nodeWeights);
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  const size_t end = dimensionSelector.End();
 
   if (maximumDepth != 1)
   {
-    for (size_t i = dimensionSelector.Begin(); i != end;
-         i = dimensionSelector.Next())
+    // Dimension selection policies may draw random numbers, and the random
+    // number generator must only be used by one thread at a time.
+    std::vector<size_t> dimensions;
+    #pragma omp critical(decision_tree_dimension_selection)
     {
-      double dimGain = -DBL_MAX;
-      if (datasetInfo.Type(i) == data::Datatype::categorical)
-      {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            datasetInfo.NumMappings(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
-      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+      for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+           i = dimensionSelector.Next())
+        dimensions.push_back(i);
+    }
+
+    // Search every dimension for a split that is better than not splitting,
+    // each with its own split information.  The dimensions of large nodes are
+    // searched in parallel.  If the data is quantized, the histograms of the
+    // node that the parent did not provide are built first.
+    if (binnedData.n_elem > 0 && histograms.empty())
+      histograms.resize(data.n_rows);
+
+    const double nodeGain = bestGain;
+    std::vector<double> gains(dimensions.size());
+    std::vector<arma::vec> splitInfo(dimensions.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAux(dimensions.size());
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+        dimensions.size());
+    for (size_t k = 0; k < dimensions.size(); ++k)
+    {
+      #pragma omp task default(shared) firstprivate(k) \
+          if (count >= ParallelSplitCutoff)
       {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
+        const size_t d = dimensions[k];
+        if (binnedData.n_elem > 0 && histograms[d].is_empty() &&
+            datasetInfo.Type(d) == data::Datatype::numeric)
+        {
+          BuildHistogram<UseWeights>(binnedData, d, binBoundaries[d].n_elem + 1,
+              points, begin, count, labels, numClasses, weights, histograms[d]);
+        }
 
+        gains[k] = SearchDimension<UseWeights>(nodeGain, data, d, points,
+            sortedPoints, binBoundaries, histograms, begin, count, datasetInfo,
+            labels, nodeLabels, numClasses, weights, nodeWeights,
+            minimumLeafSize, minimumGainSplit, splitInfo[k], numericAux[k],
+            categoricalAux[k]);
+      }
+    }
+    #pragma omp taskwait
+
+    // Now pick the split that a search of the dimensions in order would pick:
+    // a dimension must improve on the best split found before it.  Its search
+    // is repeated with that split's gain as the bar to beat, which only happens
+    // when the best split improves.
+    size_t bestIndex = dimensions.size();
+    for (size_t k = 0; k < dimensions.size(); ++k)
+    {
       // If the splitter reported that it did not split, move to the next
       // dimension.
-      if (dimGain == DBL_MAX)
+      if (gains[k] == DBL_MAX)
         continue;
 
+      if (bestIndex != dimensions.size())
+      {
+        if (gains[k] <= bestGain)
+          continue;
+
+        gains[k] = SearchDimension<UseWeights>(bestGain, data, dimensions[k],
+            points, sortedPoints, binBoundaries, histograms, begin, count,
+            datasetInfo, labels, nodeLabels, numClasses, weights, nodeWeights,
+            minimumLeafSize, minimumGainSplit, splitInfo[k], numericAux[k],
+            categoricalAux[k]);
+        if (gains[k] == DBL_MAX)
+          continue;
+      }
+
       // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
+      bestIndex = k;
+      bestGain = gains[k];
 
       // If the gain is the best possible, no need to keep looking.
       if (bestGain >= 0.0)
         break;
     }
+
+    if (bestIndex != dimensions.size())
+    {
+      bestDim = dimensions[bestIndex];
+      classProbabilities = std::move(splitInfo[bestIndex]);
+      NumericAuxiliarySplitInfo::operator=(numericAux[bestIndex]);
+      CategoricalAuxiliarySplitInfo::operator=(categoricalAux[bestIndex]);
+    }
   }
 
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != datasetInfo.Dimensionality())
   {
+    // Only a leaf needs the labels and weights of its points.  Release them
+    // before the children are built, so that the memory used by the nodes on
+    // the path from the root stays proportional to the number of points, not
+    // to the number of points times the depth.
+    nodeLabels.reset();
+    nodeWeights.reset();
+
     dimensionTypeOrMajorityClass = (size_t) datasetInfo.Type(bestDim);
     splitDimension = bestDim;
 
@@ -758,27 +1013,86 @@ double DecisionTree<FitnessFunction,
     else
       numChildren = NumericSplit::NumChildren(classProbabilities, *this);
 
-    // Calculate all child assignments.
+    // Calculate all child assignments, and the counts of children.
     arma::Row<size_t> childAssignments(count);
-    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
+    for (size_t j = 0; j < count; ++j)
     {
-      for (size_t j = begin; j < begin + count; ++j)
-        childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
+      childAssignments[j] = CalculateDirection(data.col(points[begin + j]));
+      childCounts[childAssignments[j]]++;
     }
-    else
+
+    // The points of each child will be a contiguous range.
+    arma::Row<size_t> childBegins(numChildren);
+    childBegins[0] = begin;
+    for (size_t i = 1; i < numChildren; ++i)
+      childBegins[i] = childBegins[i - 1] + childCounts[i - 1];
+
+    // Split the points into children, keeping their order.
     {
-      for (size_t j = begin; j < begin + count; ++j)
+      const arma::Col<size_t> nodePoints = points.subvec(begin,
+          begin + count - 1);
+      arma::Row<size_t> positions(childBegins);
+      for (size_t j = 0; j < count; ++j)
+        points[positions[childAssignments[j]]++] = nodePoints[j];
+    }
+    childAssignments.reset();
+
+    // Split each presorted list in the same way, so that each child holds its
+    // points in sorted order.
+    if (sortedPoints.n_elem > 0)
+    {
+      for (size_t d = 0; d < data.n_rows; ++d)
       {
-        childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
+        if (datasetInfo.Type(d) != data::Datatype::numeric)
+          continue;
+
+        #pragma omp task default(shared) firstprivate(d) \
+            if (count >= ParallelSplitCutoff)
+        {
+          const arma::Col<size_t> sorted = sortedPoints.col(d).subvec(begin,
+              begin + count - 1);
+          arma::Row<size_t> positions(childBegins);
+          for (size_t j = 0; j < count; ++j)
+          {
+            sortedPoints(positions[CalculateDirection(data.col(sorted[j]))]++,
+                d) = sorted[j];
+          }
+        }
       }
+      #pragma omp taskwait
     }
 
-    // Figure out counts of children.
-    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
-    for (size_t i = begin; i < begin + count; ++i)
-      childCounts[childAssignments[i - begin]]++;
+    // If the data is quantized and the children will search every dimension,
+    // build the histograms of the smaller of two children, and get those of
+    // the larger one by subtracting them from the histograms of this node.
+    // Any other child builds its own histograms.
+    std::vector<std::vector<arma::mat>> childHistograms(numChildren);
+    if (binnedData.n_elem > 0 && numChildren == 2 && !NoRecursion &&
+        maximumDepth != 2 &&
+        std::is_same<DimensionSelectionType, AllDimensionSelect>::value)
+    {
+      const size_t small = (childCounts[0] <= childCounts[1]) ? 0 : 1;
+      childHistograms[small].resize(data.n_rows);
+      childHistograms[1 - small] = std::move(histograms);
+      for (size_t d = 0; d < data.n_rows; ++d)
+      {
+        if (childHistograms[1 - small][d].is_empty())
+          continue;
+
+        #pragma omp task default(shared) firstprivate(d) \
+            if (count >= ParallelSplitCutoff)
+        {
+          BuildHistogram<UseWeights>(binnedData, d,
+              binBoundaries[d].n_elem + 1, points, childBegins[small],
+              childCounts[small], labels, numClasses, weights,
+              childHistograms[small][d]);
+          childHistograms[1 - small][d] -= childHistograms[small][d];
+        }
+      }
+      #pragma omp taskwait
+    }
+    histograms.clear();
 
     // Initialize bestGain if recursive split is allowed.
     if (!NoRecursion)
@@ -786,62 +1100,70 @@ double DecisionTree<FitnessFunction,
       bestGain = 0.0;
     }
 
-    // Split into children.
-    size_t currentCol = begin;
+    // Now build the children.  If NoRecursion is set, each child gets a
+    // minimum leaf size equal to its number of points, so that it is a leaf.
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTree());
+
+    arma::vec childGains(numChildren);
+    auto trainChild = [&](const size_t i, DimensionSelectionType& selector)
+    {
+      childGains[i] = children[i]->template TrainNode<UseWeights>(data, points,
+          sortedPoints, binnedData, binBoundaries, childHistograms[i],
+          childBegins[i], childCounts[i], datasetInfo, labels, numClasses,
+          weights, NoRecursion ? childCounts[i] : minimumLeafSize,
+          minimumGainSplit, maximumDepth - 1, selector);
+    };
+
+    // The children of large nodes are built in parallel tasks.  They hold
+    // disjoint ranges of points, and each gets its own copy of the dimension
+    // selector, since selectors keep state.  A selector that draws random
+    // dimensions would draw them in whatever order the tasks run, so the
+    // children are only built in parallel when every dimension is searched;
+    // the tree is then the same as with serial training.
+    const bool parallelChildren = (count >= ParallelBuildCutoff) &&
+        std::is_same<DimensionSelectionType, AllDimensionSelect>::value;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      if (parallelChildren)
       {
-        if (childAssignments[j - begin] == i)
+        #pragma omp task default(shared) firstprivate(i)
         {
-          childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
-          ++currentCol;
+          DimensionSelectionType childSelector(dimensionSelector);
+          trainChild(i, childSelector);
         }
       }
-
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
       else
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        trainChild(i, dimensionSelector);
       }
-      children.push_back(child);
+    }
+    #pragma omp taskwait
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
   {
+    histograms.clear();
+
     // Clear auxiliary info objects.
     NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
     CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
 
     // Calculate class probabilities because we are a leaf.
-    CalculateClassProbabilities<UseWeights>(
-        labels.subvec(begin, begin + count - 1),
-        numClasses,
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+    CalculateClassProbabilities<UseWeights>(nodeLabels, numClasses,
+        nodeWeights);
   }
 
   return -bestGain;
 }
 
-//! Train on the given data, assuming all dimensions are numeric.
+//! Search one dimension of a node for a better split.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
@@ -854,149 +1176,312 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
-                    NoRecursion>::Train(
-    MatType& data,
+                    NoRecursion>::SearchDimension(
+    const double bestGain,
+    const MatType& data,
+    const size_t dimension,
+    const arma::Col<size_t>& points,
+    const arma::Mat<size_t>& sortedPoints,
+    const std::vector<arma::vec>& binBoundaries,
+    const std::vector<arma::mat>& histograms,
     const size_t begin,
     const size_t count,
-    arma::Row<size_t>& labels,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const arma::Row<size_t>& nodeLabels,
     const size_t numClasses,
-    arma::rowvec& weights,
+    const arma::rowvec& weights,
+    const arma::rowvec& nodeWeights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
-    const size_t maximumDepth,
-    DimensionSelectionType& dimensionSelector)
+    arma::vec& splitInfo,
+    NumericAuxiliarySplitInfo& numericAux,
+    CategoricalAuxiliarySplitInfo& categoricalAux)
 {
-  // Clear children if needed.
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
-
-  // We won't be using these members, so reset them.
-  CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+  arma::Row<typename MatType::elem_type> values(count);
+  if (datasetInfo.Type(dimension) == data::Datatype::categorical)
+  {
+    for (size_t i = 0; i < count; ++i)
+      values[i] = data(dimension, points[begin + i]);
 
-  // Look through the list of dimensions and obtain the best split.  We'll cache
-  // the best numeric split auxiliary information in numericAux (and clear it
-  // later if we don't make a split), and use classProbabilities as auxiliary
-  // information.  Later we'll overwrite classProbabilities to the empirical
-  // class probabilities if we do not split.
-  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
-      labels.subvec(begin, begin + count - 1),
-      numClasses,
-      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = data.n_rows; // This means "no split".
+    return CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+        values, datasetInfo.NumMappings(dimension), nodeLabels, numClasses,
+        nodeWeights, minimumLeafSize, minimumGainSplit, splitInfo,
+        categoricalAux);
+  }
 
-  if (maximumDepth != 1)
+  if (!histograms.empty())
   {
-    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
-         i = dimensionSelector.Next())
-    {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    labels.cols(begin, begin + count - 1),
-                                    numClasses,
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    classProbabilities,
-                                    *this);
-
-      // If the splitter did not report that it improved, then move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
+    return NumericSplitIfBetterHistogram<UseWeights>(bestGain,
+        histograms[dimension], binBoundaries[dimension], numClasses,
+        minimumLeafSize, minimumGainSplit, splitInfo, numericAux,
+        std::integral_constant<bool,
+        NumericSplitTraits<NumericSplit>::UsesBins>());
+  }
 
-      bestDim = i;
-      bestGain = dimGain;
+  if (sortedPoints.n_elem == 0)
+  {
+    for (size_t i = 0; i < count; ++i)
+      values[i] = data(dimension, points[begin + i]);
 
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+    return NumericSplit::template SplitIfBetter<UseWeights>(bestGain, values,
+        nodeLabels, numClasses, nodeWeights, minimumLeafSize, minimumGainSplit,
+        splitInfo, numericAux);
   }
 
-  // Did we split or not?  If so, then split the data and create the children.
-  if (bestDim != data.n_rows)
+  // Gather the points of the node in sorted order.
+  arma::Row<size_t> sortedLabels(count);
+  arma::rowvec sortedWeights(UseWeights ? count : 0);
+  for (size_t i = 0; i < count; ++i)
   {
-    // We know that the split is numeric.
-    size_t numChildren = NumericSplit::NumChildren(classProbabilities, *this);
-    splitDimension = bestDim;
-    dimensionTypeOrMajorityClass = (size_t) data::Datatype::numeric;
+    const size_t point = sortedPoints(begin + i, dimension);
+    values[i] = data(dimension, point);
+    sortedLabels[i] = labels[point];
+    if (UseWeights)
+      sortedWeights[i] = weights[point];
+  }
 
-    // Calculate all child assignments.
-    arma::Row<size_t> childAssignments(count);
+  return NumericSplitIfBetterSorted<UseWeights>(bestGain, values, sortedLabels,
+      numClasses, sortedWeights, minimumLeafSize, minimumGainSplit, splitInfo,
+      numericAux, std::integral_constant<bool,
+      NumericSplitTraits<NumericSplit>::SupportsSortedData>());
+}
 
-    for (size_t j = begin; j < begin + count; ++j)
-    {
-      childAssignments[j - begin] = NumericSplit::CalculateDirection(
-          data(bestDim, j), classProbabilities, *this);
-    }
+//! Search the sorted values of a numeric dimension for a better split.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename VecType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::NumericSplitIfBetterSorted(
+    const double bestGain,
+    const VecType& sortedData,
+    const arma::Row<size_t>& sortedLabels,
+    const size_t numClasses,
+    const arma::rowvec& sortedWeights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    NumericAuxiliarySplitInfo& aux,
+    const std::true_type& /* supportsSortedData */)
+{
+  return NumericSplit::template SplitIfBetterSorted<UseWeights>(bestGain,
+      sortedData, sortedLabels, numClasses, sortedWeights, minimumLeafSize,
+      minimumGainSplit, splitInfo, aux);
+}
 
-    // Calculate counts of children in each node.
-    arma::Row<size_t> childCounts(numChildren);
-    childCounts.zeros();
-    for (size_t j = begin; j < begin + count; ++j)
-      childCounts[childAssignments[j - begin]]++;
+//! Search the sorted values of a numeric dimension for a better split, with a
+//! numeric split type that does not use the order.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename VecType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::NumericSplitIfBetterSorted(
+    const double bestGain,
+    const VecType& sortedData,
+    const arma::Row<size_t>& sortedLabels,
+    const size_t numClasses,
+    const arma::rowvec& sortedWeights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    NumericAuxiliarySplitInfo& aux,
+    const std::false_type& /* supportsSortedData */)
+{
+  return NumericSplit::template SplitIfBetter<UseWeights>(bestGain, sortedData,
+      sortedLabels, numClasses, sortedWeights, minimumLeafSize,
+      minimumGainSplit, splitInfo, aux);
+}
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
+//! Search the histogram of a quantized dimension for a better split.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::NumericSplitIfBetterHistogram(
+    const double bestGain,
+    const arma::mat& histogram,
+    const arma::vec& boundaries,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    NumericAuxiliarySplitInfo& aux,
+    const std::true_type& /* usesBins */)
+{
+  return NumericSplit::template SplitIfBetterHistogram<UseWeights>(bestGain,
+      histogram, boundaries, numClasses, minimumLeafSize, minimumGainSplit,
+      splitInfo, aux);
+}
 
-    size_t currentCol = begin;
-    for (size_t i = 0; i < numChildren; ++i)
-    {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
-      {
-        if (childAssignments[j - begin] == i)
-        {
-          childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
-          ++currentCol;
-        }
-      }
+//! Histograms are only built for split types that use bins, so this is never
+//! called.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::NumericSplitIfBetterHistogram(
+    const double /* bestGain */,
+    const arma::mat& /* histogram */,
+    const arma::vec& /* boundaries */,
+    const size_t /* numClasses */,
+    const size_t /* minimumLeafSize */,
+    const double /* minimumGainSplit */,
+    arma::vec& /* splitInfo */,
+    NumericAuxiliarySplitInfo& /* aux */,
+    const std::false_type& /* usesBins */)
+{
+  return DBL_MAX;
+}
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-      }
-      else
-      {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
-      }
-      children.push_back(child);
-    }
-  }
-  else
+//! Quantize the numeric dimensions of the data, if the numeric split uses bins.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::QuantizeData(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    arma::Mat<unsigned char>& binnedData,
+    std::vector<arma::vec>& binBoundaries)
+{
+  QuantizeData(data, datasetInfo, binnedData, binBoundaries,
+      std::integral_constant<bool,
+      NumericSplitTraits<NumericSplit>::UsesBins>());
+}
+
+//! Quantize the numeric dimensions of the data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::QuantizeData(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    arma::Mat<unsigned char>& binnedData,
+    std::vector<arma::vec>& binBoundaries,
+    const std::true_type& /* usesBins */)
+{
+  // The bins of each dimension are stored contiguously.
+  binnedData.zeros(data.n_cols, data.n_rows);
+  binBoundaries.resize(data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
   {
-    // We won't be needing these members, so reset them.
-    NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    if (datasetInfo.Type(d) != data::Datatype::numeric)
+      continue;
 
-    // Calculate class probabilities because we are a leaf.
-    CalculateClassProbabilities<UseWeights>(
-        labels.subvec(begin, begin + count - 1),
-        numClasses,
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+    const arma::rowvec values = arma::conv_to<arma::rowvec>::from(data.row(d));
+    NumericSplit::Quantize(values, binBoundaries[d]);
+    for (size_t i = 0; i < values.n_elem; ++i)
+      binnedData(i, d) = NumericSplit::Bin(values[i], binBoundaries[d]);
   }
+}
 
-  return -bestGain;
+//! The numeric split type does not use bins, so there is nothing to do.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename MatType>
+void DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::QuantizeData(
+    const MatType& /* data */,
+    const data::DatasetInfo& /* datasetInfo */,
+    arma::Mat<unsigned char>& /* binnedData */,
+    std::vector<arma::vec>& /* binBoundaries */,
+    const std::false_type& /* usesBins */)
+{
+  // Nothing to do.
+}
+
+//! Build the class histogram of one quantized dimension of a node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights>
+void DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::BuildHistogram(
+    const arma::Mat<unsigned char>& binnedData,
+    const size_t dimension,
+    const size_t numBins,
+    const arma::Col<size_t>& points,
+    const size_t begin,
+    const size_t count,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    arma::mat& histogram)
+{
+  histogram.zeros(numClasses + 1, numBins);
+  const unsigned char* bins = binnedData.colptr(dimension);
+  for (size_t i = begin; i < begin + count; ++i)
+  {
+    const size_t point = points[i];
+    histogram(labels[point], bins[point]) += UseWeights ? weights[point] : 1.0;
+    histogram(numClasses, bins[point]) += 1.0;
+  }
 }
 
 //! Return the class.
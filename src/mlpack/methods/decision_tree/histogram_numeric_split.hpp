@@ -0,0 +1,183 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split on a quantized
+ * dimension, by scanning the class histogram of its bins.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "numeric_split_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HistogramNumericSplit is a splitting function for decision trees that
+ * searches a numeric dimension for the best binary split between the bins of
+ * a quantization of the dimension, instead of between every pair of distinct
+ * values like BestBinaryNumericSplit.
+ *
+ * Each dimension is quantized into at most 256 bins whose boundaries are
+ * quantiles of the values, so a bin index fits in one byte.  If a dimension
+ * has at most 256 distinct values, every value gets its own bin and the same
+ * thresholds as BestBinaryNumericSplit are considered.
+ *
+ * When used with DecisionTree, each dimension is quantized once for the whole
+ * tree and stored as bytes, and each node finds its split by scanning a
+ * histogram of the classes in each bin.  With AllDimensionSelect, the
+ * histograms of the larger child of a node are obtained by subtracting those
+ * of the smaller child from those of the node, so only the smaller child is
+ * scanned.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class HistogramNumericSplit
+{
+ public:
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  //! The maximum number of bins of a dimension.
+  static const size_t MaxBins = 256;
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.  The values of the node are quantized and
+   * searched with SplitIfBetterHistogram().
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Check if we can split a node, like SplitIfBetter(), given the class
+   * histogram of its points.  histogram(c, b) is the number of points of class
+   * c in bin b (or their total weight, if UseWeights is true), and
+   * histogram(numClasses, b) is the number of points in bin b.  The split
+   * thresholds are the bin boundaries.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param histogram Class histogram of the points of the node, with
+   *      numClasses + 1 rows and one column per bin.
+   * @param boundaries Boundaries between the bins, as given by Quantize().
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename ElemType>
+  static double SplitIfBetterHistogram(
+      const double bestGain,
+      const arma::mat& histogram,
+      const arma::Col<ElemType>& boundaries,
+      const size_t numClasses,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<ElemType>& classProbabilities,
+      AuxiliarySplitInfo<ElemType>& aux);
+
+  /**
+   * Compute the boundaries between the bins of a dimension.  The boundaries
+   * are increasing, and there are at most MaxBins - 1 of them; a value goes to
+   * the first bin whose upper boundary is not below it, or to the last bin.
+   *
+   * @param data The values of the dimension.
+   * @param boundaries Vector to store the boundaries in.
+   */
+  template<typename VecType>
+  static void Quantize(const VecType& data,
+                       arma::Col<typename VecType::elem_type>& boundaries);
+
+  /**
+   * Return the bin of a value.
+   *
+   * @param value Value to find the bin of.
+   * @param boundaries Boundaries between the bins, as given by Quantize().
+   */
+  template<typename ElemType>
+  static unsigned char Bin(const ElemType value,
+                           const arma::Col<ElemType>& boundaries)
+  {
+    return (unsigned char) (std::lower_bound(boundaries.begin(),
+        boundaries.end(), value) - boundaries.begin());
+  }
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param * (aux) Auxiliary information for the split (Unused).
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */);
+};
+
+//! HistogramNumericSplit searches histograms of quantized dimensions.
+template<typename FitnessFunction>
+class NumericSplitTraits<HistogramNumericSplit<FitnessFunction>>
+{
+ public:
+  static const bool SupportsSortedData = false;
+  static const bool UsesBins = true;
+  static const bool SplitsOnThreshold = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds the best binary numeric split on a
+ * quantized dimension.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& aux)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Quantize the values and build the class histogram of the bins.
+  arma::Col<typename VecType::elem_type> boundaries;
+  Quantize(data, boundaries);
+
+  arma::mat histogram(numClasses + 1, boundaries.n_elem + 1,
+      arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t bin = Bin(data[i], boundaries);
+    histogram(labels[i], bin) += UseWeights ? weights[i] : 1.0;
+    histogram(numClasses, bin) += 1.0;
+  }
+
+  return SplitIfBetterHistogram<UseWeights>(bestGain, histogram, boundaries,
+      numClasses, minimumLeafSize, minimumGainSplit, classProbabilities, aux);
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename ElemType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetterHistogram(
+    const double bestGain,
+    const arma::mat& histogram,
+    const arma::Col<ElemType>& boundaries,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<ElemType>& classProbabilities,
+    AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Sanity check: if there is only one bin, we can't split in this dimension.
+  if (histogram.n_cols < 2)
+    return DBL_MAX;
+
+  // The totals of each class, and the number of points, over all the bins.
+  const arma::vec totals = arma::sum(histogram, 1);
+  const double totalCount = totals[numClasses];
+  if (totalCount < (double) (minimumLeafSize * 2))
+    return DBL_MAX;
+
+  const double totalWeight = UseWeights ?
+      arma::accu(totals.head(numClasses)) : totalCount;
+
+  // Loop through the boundaries between bins, choosing the best one.  Also,
+  // force a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0) *
+      totalWeight;
+  bool improved = false;
+  const double minimum = (double) std::max(minimumLeafSize, (size_t) 1);
+
+  arma::vec leftSums(numClasses + 1, arma::fill::zeros);
+  arma::vec rightSums(numClasses + 1);
+  for (size_t bin = 0; bin < histogram.n_cols - 1; ++bin)
+  {
+    // An empty bin gives the same split as the bin before it.
+    if (histogram(numClasses, bin) == 0.0)
+      continue;
+
+    leftSums += histogram.col(bin);
+    const double leftCount = leftSums[numClasses];
+    const double rightCount = totalCount - leftCount;
+    if (leftCount < minimum)
+      continue;
+    if (rightCount < minimum)
+      break;
+
+    rightSums = totals - leftSums;
+    const double leftWeight = UseWeights ?
+        arma::accu(leftSums.head(numClasses)) : leftCount;
+    const double rightWeight = UseWeights ?
+        arma::accu(rightSums.head(numClasses)) : rightCount;
+
+    // Calculate the gain for the left and right child.
+    const double leftGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        leftSums.memptr(), numClasses, leftWeight);
+    const double rightGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        rightSums.memptr(), numClasses, rightWeight);
+    const double gain = leftWeight * leftGain + rightWeight * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = boundaries[bin];
+
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = boundaries[bin];
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  return bestFoundGain / totalWeight;
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+void HistogramNumericSplit<FitnessFunction>::Quantize(
+    const VecType& data,
+    arma::Col<typename VecType::elem_type>& boundaries)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  const size_t n = data.n_elem;
+  const arma::Col<ElemType> sorted = arma::sort(arma::vectorise(data));
+
+  // If there are few distinct values, each one gets its own bin.
+  size_t distinctValues = (n > 0) ? 1 : 0;
+  for (size_t i = 1; i < n && distinctValues <= MaxBins; ++i)
+    if (sorted[i] != sorted[i - 1])
+      ++distinctValues;
+
+  std::vector<ElemType> cuts;
+  if (distinctValues <= MaxBins)
+  {
+    for (size_t i = 1; i < n; ++i)
+      if (sorted[i] != sorted[i - 1])
+        cuts.push_back((sorted[i - 1] + sorted[i]) / 2.0);
+  }
+  else
+  {
+    // Otherwise, place the boundaries at quantiles.  If a quantile falls
+    // inside a run of equal values, the boundary goes at the end of the run,
+    // so a value is never split between two bins.
+    for (size_t b = 1; b < MaxBins; ++b)
+    {
+      size_t index = (b * n) / MaxBins;
+      if (index == 0)
+        continue;
+      if (sorted[index] == sorted[index - 1])
+      {
+        index = std::upper_bound(sorted.begin() + index, sorted.end(),
+            sorted[index]) - sorted.begin();
+        if (index == n)
+          break;
+      }
+
+      const ElemType cut = (sorted[index - 1] + sorted[index]) / 2.0;
+      if (cuts.empty() || cut > cuts.back())
+        cuts.push_back(cut);
+    }
+  }
+
+  boundaries = arma::Col<ElemType>(cuts);
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file methods/decision_tree/numeric_split_traits.hpp
+ *
+ * Traits of the numeric split types used by DecisionTree, which tell the tree
+ * what a split type can do beyond the required interface.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_NUMERIC_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The NumericSplitTraits class holds the properties of a numeric split type.
+ * The defaults are safe for any split type; a split type can specialize this
+ * class to declare more.
+ *
+ * @tparam SplitType The numeric split type.
+ */
+template<typename SplitType>
+class NumericSplitTraits
+{
+ public:
+  /**
+   * If true, the split type has a static SplitIfBetterSorted() function, like
+   * SplitIfBetter() but taking the points of the node in ascending order of
+   * the dimension.  DecisionTree can then sort each dimension once for the
+   * whole tree instead of at every node.
+   */
+  static const bool SupportsSortedData = false;
+
+  /**
+   * If true, the split type quantizes each dimension into at most 256 bins
+   * with static Quantize() and Bin() functions, and has a static
+   * SplitIfBetterHistogram() function that searches the class histogram of the
+   * bins of a node instead of its points.  DecisionTree then quantizes the
+   * data once for the whole tree, and builds histograms instead of sorting.
+   */
+  static const bool UsesBins = false;
+
+  /**
+   * If true, the split type always has two children, and
+   * CalculateDirection() sends a point to the first child if its value is not
+   * greater than classProbabilities[0] and to the second one otherwise.  Trees
+   * with such splits can be compiled into a CompiledForest.
+   */
+  static const bool SplitsOnThreshold = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
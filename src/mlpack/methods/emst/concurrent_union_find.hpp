@@ -0,0 +1,126 @@
+/**
+ * @file methods/emst/concurrent_union_find.hpp
+ *
+ * Implements a union-find data structure that can be used by many threads at
+ * the same time.  Like UnionFind, it tracks the components of a graph, but
+ * Find() and Union() are lock-free.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free Union-Find data structure.  Each point in the graph is initially
+ * in its own component; Union(x, y) unites the components containing x and y,
+ * and Find(x) returns the index of the component containing x.  Both may be
+ * called from many threads at once.
+ *
+ * The parent of each element is only ever changed with a compare-and-swap.
+ * Union() always links the root with the smaller index below the root with the
+ * larger index, so concurrent unions can never create a cycle, and Find()
+ * shortens paths with path halving.  See the following paper for details:
+ *
+ * @code
+ * @inproceedings{anderson1991wait,
+ *   title={Wait-free parallel algorithms for the union-find problem},
+ *   author={Anderson, R.J. and Woll, H.},
+ *   booktitle={Proceedings of the Twenty-Third Annual ACM Symposium on Theory
+ *       of Computing (STOC '91)},
+ *   pages={370--380},
+ *   year={1991}
+ * }
+ * @endcode
+ *
+ * While unions are in progress, two calls to Find() for the same element may
+ * return different roots; the components are only well-defined once all
+ * threads are done.
+ */
+class ConcurrentUnionFind
+{
+ private:
+  //! The parent of each element; a root is its own parent.
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.
+   *
+   * @param x The element to be found.
+   * @return The index of the component containing x.
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load(std::memory_order_acquire);
+      if (p == x)
+        return x;
+
+      // Path halving: point x at its grandparent.  Parents only ever move up
+      // the tree, so if the swap fails, the grandparent is still an ancestor.
+      const size_t grandparent = parent[p].load(std::memory_order_acquire);
+      if (grandparent != p)
+      {
+        parent[x].compare_exchange_weak(p, grandparent,
+            std::memory_order_release, std::memory_order_relaxed);
+      }
+      x = grandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x One component.
+   * @param y The other component.
+   * @return true if the components were different and have been united by this
+   *     call.
+   */
+  bool Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+      if (x == y)
+        return false;
+
+      // Link the smaller root below the larger one.  If x is no longer a root,
+      // another thread got there first and we try again.
+      if (x > y)
+        std::swap(x, y);
+      size_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y,
+          std::memory_order_acq_rel, std::memory_order_relaxed))
+      {
+        return true;
+      }
+    }
+  }
+
+  //! Get the number of elements.
+  size_t Size() const { return parent.size(); }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
@@ -27,6 +27,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -68,6 +69,12 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * If OpenMP is available, the nearest neighbor search of each Boruvka round is
+ * split into query subtrees that are traversed in parallel, and the components
+ * are then merged in parallel with a lock-free union-find structure.  Ties
+ * between edges are broken by point indices, so the results do not depend on
+ * the number of threads.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -103,14 +110,18 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
-
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsInComponent;
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsOutComponent;
-  //! List of edge distances.
-  arma::vec neighborsDistances;
+  ConcurrentUnionFind connections;
+
+  //! The component of each point at the start of the current round.
+  arma::Col<size_t> components;
+  //! The length of the shortest candidate edge of each component.
+  std::vector<std::atomic<double>> componentDistances;
+  //! The point whose candidate edge is chosen for each component.
+  std::vector<std::atomic<size_t>> componentPoints;
+  //! The distance from each point to its candidate nearest neighbor.
+  arma::vec pointDistances;
+  //! The candidate nearest neighbor of each point, outside its component.
+  arma::Col<size_t> pointNeighbors;
 
   //! Total distance of the tree.
   double totalDist;
@@ -123,7 +134,13 @@ class DualTreeBoruvka
   {
     bool operator()(const EdgePair& pairA, const EdgePair& pairB)
     {
-      return (pairA.Distance() < pairB.Distance());
+      // Ties are broken by the indices, so that the order of the edges does
+      // not depend on the order in which they were found.
+      if (pairA.Distance() != pairB.Distance())
+        return (pairA.Distance() < pairB.Distance());
+      if (pairA.Lesser() != pairB.Lesser())
+        return (pairA.Lesser() < pairB.Lesser());
+      return (pairA.Greater() < pairB.Greater());
     }
   } SortFun;
 
@@ -177,12 +194,17 @@ class DualTreeBoruvka
 
  private:
   /**
-   * Adds a single edge to the edge list
+   * Adds a single edge to the given edge list.
    */
-  void AddEdge(const size_t e1, const size_t e2, const double distance);
+  static void AddEdge(const size_t e1,
+                      const size_t e2,
+                      const double distance,
+                      std::vector<EdgePair>& edgeList);
 
   /**
-   * Adds all the edges found in one iteration to the list of neighbors.
+   * Adds all the edges found in one iteration to the list of neighbors.  The
+   * shortest edge of each component is chosen, and the components are merged
+   * in parallel.
    */
   void AddAllEdges();
 
@@ -198,7 +220,8 @@ class DualTreeBoruvka
   void CleanupHelper(Tree* tree);
 
   /**
-   * The values stored in the tree must be reset on each iteration.
+   * The values stored in the tree and the candidate edges must be reset on
+   * each iteration, and the component of each point must be updated.
    */
   void Cleanup();
 }; // class DualTreeBoruvka
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_EMST_DTB_IMPL_HPP
 
 #include "dtb_rules.hpp"
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 
 namespace mlpack {
 namespace emst {
@@ -58,15 +59,16 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(!naive),
     naive(naive),
     connections(dataset.n_cols),
+    componentDistances(dataset.n_cols),
+    componentPoints(dataset.n_cols),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Set size.
 
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
+  components.set_size(data.n_cols);
+  pointDistances.set_size(data.n_cols);
+  pointNeighbors.set_size(data.n_cols);
 }
 
 template<
@@ -83,15 +85,16 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(false),
     naive(false),
     connections(data.n_cols),
+    componentDistances(data.n_cols),
+    componentPoints(data.n_cols),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Fill with EdgePairs.
 
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
+  components.set_size(data.n_cols);
+  pointDistances.set_size(data.n_cols);
+  pointNeighbors.set_size(data.n_cols);
 }
 
 template<
@@ -123,21 +126,33 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 
   totalDist = 0; // Reset distance.
 
+  // Put every point in its own component and initialize the tree.
+  Cleanup();
+
   typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+  RuleType rules(data, components, componentDistances, pointDistances,
+                 pointNeighbors, metric);
   while (edges.size() < (data.n_cols - 1))
   {
     if (naive)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
+      // Full O(N^2) traversal.  Each thread works on its own query points.
+      #pragma omp parallel
+      {
+        RuleType threadRules(rules);
+
+        #pragma omp for schedule(dynamic, 16)
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            threadRules.BaseCase(i, j);
+      }
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+      // Independent query subtrees are traversed in parallel if OpenMP is
+      // available.
+      tree::ParallelDualTreeTraverser<RuleType,
+          Tree::template DualTreeTraverser> traverser(rules);
       traverser.Traverse(*tree, *tree);
     }
 
@@ -162,7 +177,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 }
 
 /**
- * Adds a single edge to the edge list
+ * Adds a single edge to the given edge list.
  */
 template<
     typename MetricType,
@@ -173,15 +188,16 @@ template<
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddEdge(
     const size_t e1,
     const size_t e2,
-    const double distance)
+    const double distance,
+    std::vector<EdgePair>& edgeList)
 {
   Log::Assert((distance >= 0.0),
       "DualTreeBoruvka::AddEdge(): distance cannot be negative.");
 
   if (e1 < e2)
-    edges.push_back(EdgePair(e1, e2, distance));
+    edgeList.push_back(EdgePair(e1, e2, distance));
   else
-    edges.push_back(EdgePair(e2, e1, distance));
+    edgeList.push_back(EdgePair(e2, e1, distance));
 }
 
 /**
@@ -195,20 +211,66 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
-  for (size_t i = 0; i < data.n_cols; ++i)
+  const size_t noPoint = data.n_cols;
+
+  // Order the candidate edges of two points with the same distance by their
+  // endpoints.  With this total order every component chooses an edge of the
+  // same minimum spanning tree, so the chosen edges can't form a cycle (but two
+  // components may choose the same edge).
+  auto edgeBefore = [&](const size_t a, const size_t b)
+  {
+    const size_t aLesser = std::min(a, pointNeighbors[a]);
+    const size_t bLesser = std::min(b, pointNeighbors[b]);
+    if (aLesser != bLesser)
+      return aLesser < bLesser;
+    return std::max(a, pointNeighbors[a]) < std::max(b, pointNeighbors[b]);
+  };
+
+  // Find the point that holds the shortest candidate edge of each component.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
-    size_t component = connections.Find(i);
-    size_t inEdge = neighborsInComponent[component];
-    size_t outEdge = neighborsOutComponent[component];
-    if (connections.Find(inEdge) != connections.Find(outEdge))
+    const size_t component = components[i];
+    if (pointDistances[i] == DBL_MAX || pointDistances[i] !=
+        componentDistances[component].load(std::memory_order_relaxed))
+      continue;
+
+    std::atomic<size_t>& componentPoint = componentPoints[component];
+    size_t current = componentPoint.load(std::memory_order_relaxed);
+    while ((current == noPoint || edgeBefore(i, current)) &&
+        !componentPoint.compare_exchange_weak(current, (size_t) i,
+            std::memory_order_relaxed)) { }
+  }
+
+  // Merge the components along the chosen edges.
+  double roundDist = 0.0;
+  #pragma omp parallel reduction(+:roundDist)
+  {
+    std::vector<EdgePair> threadEdges;
+
+    #pragma omp for
+    for (omp_size_t c = 0; c < (omp_size_t) data.n_cols; ++c)
     {
-      // totalDist = totalDist + dist;
-      // changed to make this agree with the cover tree code
-      totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
-      connections.Union(inEdge, outEdge);
+      const size_t inEdge = componentPoints[c].load(std::memory_order_relaxed);
+      if (inEdge == noPoint)
+        continue;
+
+      // Only the first of two components that chose the same edge unites them.
+      const size_t outEdge = pointNeighbors[inEdge];
+      if (connections.Union(inEdge, outEdge))
+      {
+        // totalDist = totalDist + dist;
+        // changed to make this agree with the cover tree code
+        roundDist += pointDistances[inEdge];
+        AddEdge(inEdge, outEdge, pointDistances[inEdge], threadEdges);
+      }
     }
+
+    #pragma omp critical
+    edges.insert(edges.end(), threadEdges.begin(), threadEdges.end());
   }
+
+  totalDist += roundDist;
 }
 
 /**
@@ -223,9 +285,6 @@ template<
 void DualTreeBoruvka<MetricType, MatType, TreeType>::EmitResults(
     arma::mat& results)
 {
-  // Sort the edges.
-  std::sort(edges.begin(), edges.end(), SortFun);
-
   Log::Assert(edges.size() == data.n_cols - 1);
   results.set_size(3, edges.size());
 
@@ -249,20 +308,18 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::EmitResults(
         edges[i].Lesser() = ind2;
         edges[i].Greater() = ind1;
       }
-
-      results(0, i) = edges[i].Lesser();
-      results(1, i) = edges[i].Greater();
-      results(2, i) = edges[i].Distance();
     }
   }
-  else
+
+  // Sort the edges.  This is done after unpermuting, so that edges of the same
+  // length are ordered by their original indices.
+  std::sort(edges.begin(), edges.end(), SortFun);
+
+  for (size_t i = 0; i < edges.size(); ++i)
   {
-    for (size_t i = 0; i < edges.size(); ++i)
-    {
-      results(0, i) = edges[i].Lesser();
-      results(1, i) = edges[i].Greater();
-      results(2, i) = edges[i].Distance();
-    }
+    results(0, i) = edges[i].Lesser();
+    results(1, i) = edges[i].Greater();
+    results(2, i) = edges[i].Distance();
   }
 }
 
@@ -291,7 +348,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
   // if all other components of children and points are the same.
   const int component = (tree->NumChildren() != 0) ?
       tree->Child(0).Stat().ComponentMembership() :
-      connections.Find(tree->Point(0));
+      components[tree->Point(0)];
 
   // Check components of children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
@@ -300,7 +357,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Check components of points.
   for (size_t i = 0; i < tree->NumPoints(); ++i)
-    if (connections.Find(tree->Point(i)) != size_t(component))
+    if (components[tree->Point(i)] != size_t(component))
       return;
 
   // If we made it this far, all components are the same.
@@ -318,8 +375,15 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; ++i)
-    neighborsDistances[i] = DBL_MAX;
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    components[i] = connections.Find(i);
+    componentDistances[i].store(DBL_MAX, std::memory_order_relaxed);
+    componentPoints[i].store(data.n_cols, std::memory_order_relaxed);
+    pointDistances[i] = DBL_MAX;
+    pointNeighbors[i] = data.n_cols;
+  }
 
   if (!naive)
     CleanupHelper(tree);
@@ -16,18 +16,49 @@
 
 #include <mlpack/core/tree/traversal_info.hpp>
 
+#include <atomic>
+
 namespace mlpack {
 namespace emst {
 
+/**
+ * Rules for one round of the DualTreeBoruvka algorithm: for every component,
+ * find the shortest edge to a point of another component.
+ *
+ * Each query point records its own nearest neighbor outside its component,
+ * and the shortest candidate distance of each component, which is the bound
+ * used for pruning, is updated atomically.  Copies of a DTBRules object share
+ * all of these results, but each copy holds its own traversal information and
+ * base case and score counts, so each task of a
+ * tree::ParallelDualTreeTraverser can work with its own copy so long as the
+ * tasks work on disjoint sets of query points.
+ *
+ * Ties between candidate neighbors of a point are broken in favor of the
+ * smaller reference index, so the results do not depend on the traversal
+ * order.
+ */
 template<typename MetricType, typename TreeType>
 class DTBRules
 {
  public:
+  /**
+   * Construct the rules.
+   *
+   * @param dataSet The dataset.
+   * @param components Component of each point for this round.
+   * @param componentDistances Shortest candidate edge length of each
+   *     component; should be DBL_MAX before the round.
+   * @param pointDistances Distance from each point to its nearest neighbor
+   *     outside its component; should be DBL_MAX before the round.
+   * @param pointNeighbors Nearest neighbor of each point outside its
+   *     component.
+   * @param metric Instantiated metric.
+   */
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
-           arma::vec& neighborsDistances,
-           arma::Col<size_t>& neighborsInComponent,
-           arma::Col<size_t>& neighborsOutComponent,
+           const arma::Col<size_t>& components,
+           std::vector<std::atomic<double>>& componentDistances,
+           arma::vec& pointDistances,
+           arma::Col<size_t>& pointNeighbors,
            MetricType& metric);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -101,19 +132,19 @@ class DTBRules
   //! The data points.
   const arma::mat& dataSet;
 
-  //! Stores the tree structure so far
-  UnionFind& connections;
+  //! The component of each point for this round.
+  const arma::Col<size_t>& components;
 
-  //! The distance to the candidate nearest neighbor for each component.
-  arma::vec& neighborsDistances;
+  //! The distance to the candidate nearest neighbor for each component.  This
+  //! is shared between threads, so it is only updated atomically.
+  std::vector<std::atomic<double>>& componentDistances;
 
-  //! The index of the point in the component that is an endpoint of the
-  //! candidate edge.
-  arma::Col<size_t>& neighborsInComponent;
+  //! The distance to the candidate nearest neighbor of each point.
+  arma::vec& pointDistances;
 
-  //! The index of the point outside of the component that is an endpoint
-  //! of the candidate edge.
-  arma::Col<size_t>& neighborsOutComponent;
+  //! The index of the candidate nearest neighbor of each point, outside of the
+  //! point's component.
+  arma::Col<size_t>& pointNeighbors;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -123,6 +154,12 @@ class DTBRules
    */
   inline double CalculateBound(TreeType& queryNode) const;
 
+  //! Get the shortest candidate edge length of the given component.
+  double ComponentDistance(const size_t component) const
+  {
+    return componentDistances[component].load(std::memory_order_relaxed);
+  }
+
   TraversalInfoType traversalInfo;
 
   //! The number of base cases calculated.
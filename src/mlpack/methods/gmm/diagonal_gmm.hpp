@@ -19,6 +19,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// Online fitting method for Update().
+#include "online_em_fit.hpp"
 
 // This is the default covariance matrix constraint.
 #include "diagonal_constraint.hpp"
@@ -263,6 +265,23 @@ class DiagonalGMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with one step of online EM on the given mini-batch of
+   * observations, for instance to keep the model up to date on a stream of
+   * data.  The model must already be trained (or otherwise initialized).  The
+   * fitter keeps the number of steps taken, which sets the step size, so the
+   * same fitter should be used for all of the mini-batches of a stream.
+   *
+   * @tparam OnlineFittingType The type of online fitting method which should
+   *     be used (OnlineEMFit<kmeans::KMeans<>, DiagonalConstraint,
+   *     distribution::DiagonalGaussianDistribution> is suggested).
+   * @param observations Mini-batch of observations.
+   * @param fitter The fitter to use.
+   * @return The log-likelihood of the mini-batch before the update.
+   */
+  template<typename OnlineFittingType>
+  double Update(const arma::mat& observations, OnlineFittingType& fitter);
+
   /**
    * Classify the given observations as being from an individual component in
    * this DiagonalGMM. The resultant classifications are stored in the 'labels'
@@ -189,6 +189,14 @@ double DiagonalGMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+//! Update the DiagonalGMM with one step of online fitting.
+template<typename OnlineFittingType>
+double DiagonalGMM::Update(const arma::mat& observations,
+                           OnlineFittingType& fitter)
+{
+  return fitter.Step(observations, dists, weights);
+}
+
 //! Serialize the object.
 template<typename Archive>
 void DiagonalGMM::serialize(Archive& ar, const unsigned int /* version */)
@@ -148,19 +148,45 @@ class EMFit
       arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Run the E-step: calculate the log-probability of each component given each
+   * observation, and the log-likelihood of the model.  Yes, the log-likelihood
+   * is reimplemented in the GMM code.  Intuition suggests that the
+   * log-likelihood is not the best way to determine if the EM algorithm has
+   * converged.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param dists Distributions to store model in.
+   * The observations are split into blocks that are handled in parallel with
+   * OpenMP; each block is evaluated against every component.
+   *
+   * @param observations Data matrix.
+   * @param dists Distributions of the model.
    * @param weights Vector of a priori weights.
+   * @param condLogProb Matrix to store the conditional log-probabilities in,
+   *     with one row per observation and one column per component.
+   * @return Log-likelihood of the model.
    */
-  double LogLikelihood(
-      const arma::mat& data,
+  double Expectation(
+      const arma::mat& observations,
       const std::vector<Distribution>& dists,
-      const arma::vec& weights) const;
+      const arma::vec& weights,
+      arma::mat& condLogProb) const;
+
+  /**
+   * Run the M-step: update the means and covariances of the distributions
+   * from the conditional log-probabilities.  The weighted sums over the
+   * observations are accumulated per thread over blocks of observations and
+   * then reduced.
+   *
+   * @param observations Data matrix.
+   * @param condLogProb Conditional log-probabilities of each component, with
+   *     one row per observation and one column per component.
+   * @param probRowSums Log of the sum of each column of condLogProb.
+   * @param dists Distributions to update.
+   */
+  void Maximization(
+      const arma::mat& observations,
+      const arma::mat& condLogProb,
+      const arma::vec& probRowSums,
+      std::vector<Distribution>& dists);
 
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
@@ -71,13 +71,16 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present theta value, along with the
+  // log-likelihood of the model.
+  arma::mat condLogProb;
+  double l = Expectation(observations, dists, weights, condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -86,81 +89,24 @@ Estimate(const arma::mat& observations,
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
     // Store the sum of the probability of each state over all the observations.
     arma::vec probRowSums(dists.size());
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
       probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
-    }
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * arma::exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec covariance = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    // Calculate the new value of the means and covariances using the updated
+    // conditional probabilities.
+    Maximization(observations, condLogProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
     weights = arma::exp(probRowSums - log(observations.n_cols));
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the conditional
+    // probabilities for the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = Expectation(observations, dists, weights, condLogProb);
 
     iteration++;
   }
@@ -179,101 +125,45 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present theta value, along with the
+  // log-likelihood of the model.
+  arma::mat condLogProb;
+  double l = Expectation(observations, dists, weights, condLogProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
+  const arma::vec logProbabilities = arma::log(probabilities);
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = mlpack::math::AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
+    // Multiply the conditional probability of each point being from Gaussian
+    // i by the probability of the point being from this mixture model.
+    condLogProb.each_col() += logProbabilities;
 
     // This will store the sum of probabilities of each state over all the
     // observations.
     arma::vec probRowSums(dists.size());
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+      probRowSums(i) = mlpack::math::AccuLog(condLogProb.col(i));
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    arma::vec logProbabilities = arma::log(probabilities);
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      arma::vec tmpProb = condLogProb.col(i) + logProbabilities;
-      probRowSums[i] = mlpack::math::AccuLog(tmpProb);
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-      {
-        dists[i].Mean() = observations *
-              arma::exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
-      }
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same<Distribution,
-          distribution::DiagonalGaussianDistribution>::value)
-      {
-        arma::vec cov = arma::sum((tmp % tmp) %
-            (arma::ones<arma::vec>(observations.n_rows) *
-            trans(arma::exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(arma::exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-    }
+    // Calculate the new value of the means and covariances using the updated
+    // conditional probabilities.
+    Maximization(observations, condLogProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
     weights = arma::exp(probRowSums - mlpack::math::AccuLog(logProbabilities));
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the conditional
+    // probabilities for the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = Expectation(observations, dists, weights, condLogProb);
 
     iteration++;
   }
@@ -377,34 +267,191 @@ template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
 double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
-LogLikelihood(const arma::mat& observations,
-              const std::vector<Distribution>& dists,
-              const arma::vec& weights) const
+Expectation(const arma::mat& observations,
+            const std::vector<Distribution>& dists,
+            const arma::vec& weights,
+            arma::mat& condLogProb) const
 {
-  double logLikelihood = 0;
+  condLogProb.set_size(observations.n_cols, dists.size());
+  const arma::vec logWeights = arma::log(weights);
+
+  // Each block is large enough that the distributions can use matrix-matrix
+  // operations on it, but small enough that it stays in cache.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  double logLikelihood = 0.0;
+  size_t outliers = 0;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:logLikelihood, outliers)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize,
+        (size_t) observations.n_cols);
+    const arma::mat block = observations.cols(begin, end - 1);
+
+    // It has to be LogProbability() otherwise Probability() would overflow
+    // easily.  The block is stored with one column per point, so that the
+    // normalization below works on contiguous memory.
+    arma::mat blockLogProb(dists.size(), block.n_cols);
+    arma::vec logPhis;
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(block, logPhis);
+      blockLogProb.row(i) = logWeights[i] + logPhis.t();
+    }
+
+    // Normalize each point, and sum the log-likelihood over every point.
+    for (size_t j = 0; j < block.n_cols; ++j)
+    {
+      const double probSum = mlpack::math::AccuLog(blockLogProb.col(j));
+      logLikelihood += probSum;
+
+      // Avoid dividing by zero; if the probability for everything is 0, we
+      // don't want to make it NaN.
+      if (probSum != -std::numeric_limits<double>::infinity())
+        blockLogProb.col(j) -= probSum;
+      else
+        ++outliers;
+    }
 
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
+    condLogProb.rows(begin, end - 1) = blockLogProb.t();
+  }
 
-  // It has to be LogProbability() otherwise Probability() would overflow easily
+  if (outliers > 0)
+  {
+    Log::Info << "Likelihood of " << outliers << " points is 0!  They are "
+        << "probably outliers." << std::endl;
+  }
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Maximization(const arma::mat& observations,
+             const arma::mat& condLogProb,
+             const arma::vec& probRowSums,
+             std::vector<Distribution>& dists)
+{
+  // If the distribution is DiagonalGaussianDistribution, calculate the
+  // covariance only with diagonal components.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  // Don't update if there's no probability of the Gaussian having points.
+  std::vector<size_t> components;
   for (size_t i = 0; i < dists.size(); ++i)
   {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = log(weights(i)) + trans(logPhis);
+    if (probRowSums[i] != -std::numeric_limits<double>::infinity())
+      components.push_back(i);
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  // Calculate the new value of the means.  Each thread sums the weighted points
+  // of its blocks, and the sums are reduced at the end.
+  arma::mat means(observations.n_rows, dists.size(), arma::fill::zeros);
+  #pragma omp parallel
   {
-    if (mlpack::math::AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
+    arma::mat localMeans(observations.n_rows, dists.size(), arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
     {
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols);
+
+      const arma::mat probs = arma::exp(condLogProb.rows(begin, end - 1)
+          .each_row() - probRowSums.t());
+      for (size_t i : components)
+        localMeans.col(i) += observations.cols(begin, end - 1) * probs.col(i);
+    }
+
+    #pragma omp critical
+    {
+      means += localMeans;
     }
-    logLikelihood += mlpack::math::AccuLog(logLikelihoods.col(j));
   }
 
-  return logLikelihood;
+  // Calculate the new value of the covariances using the updated conditional
+  // probabilities and the updated means, in the same way.
+  arma::mat diagCovs;
+  arma::cube covs;
+  if (isDiagGaussDist)
+    diagCovs.zeros(observations.n_rows, dists.size());
+  else
+    covs.zeros(observations.n_rows, observations.n_rows, dists.size());
+
+  #pragma omp parallel
+  {
+    arma::mat localDiagCovs;
+    arma::cube localCovs;
+    if (isDiagGaussDist)
+      localDiagCovs.zeros(arma::size(diagCovs));
+    else
+      localCovs.zeros(arma::size(covs));
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize,
+          (size_t) observations.n_cols);
+
+      const arma::mat probs = arma::exp(condLogProb.rows(begin, end - 1)
+          .each_row() - probRowSums.t());
+      for (size_t i : components)
+      {
+        const arma::mat tmp = observations.cols(begin, end - 1).each_col() -
+            means.col(i);
+        if (isDiagGaussDist)
+        {
+          localDiagCovs.col(i) += arma::square(tmp) * probs.col(i);
+        }
+        else
+        {
+          localCovs.slice(i) += (tmp.each_row() % probs.col(i).t()) *
+              tmp.t();
+        }
+      }
+    }
+
+    #pragma omp critical
+    {
+      if (isDiagGaussDist)
+        diagCovs += localDiagCovs;
+      else
+        covs += localCovs;
+    }
+  }
+
+  for (size_t i : components)
+  {
+    dists[i].Mean() = means.col(i);
+
+    if (isDiagGaussDist)
+    {
+      arma::vec covariance = diagCovs.col(i);
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+    else
+    {
+      arma::mat covariance = covs.slice(i);
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+  }
 }
 
 template<typename InitialClusteringType,
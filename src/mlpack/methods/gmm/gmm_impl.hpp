@@ -187,6 +187,15 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Update the GMM with one step of online fitting on the given observations.
+ */
+template<typename OnlineFittingType>
+double GMM::Update(const arma::mat& observations, OnlineFittingType& fitter)
+{
+  return fitter.Step(observations, dists, weights);
+}
+
 /**
  * Serialize the object.
  */
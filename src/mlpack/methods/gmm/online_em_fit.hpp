@@ -0,0 +1,203 @@
+/**
+ * @file methods/gmm/online_em_fit.hpp
+ *
+ * Utility class to fit a GMM with the online (stepwise) EM algorithm, which
+ * updates the model from mini-batches of observations.  Used by GMM::Train()
+ * and GMM::Update().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
+
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the online EM algorithm described
+ * in the following paper:
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title={On-line expectation-maximization algorithm for latent data models},
+ *   author={Capp{\'e}, O. and Moulines, E.},
+ *   journal={Journal of the Royal Statistical Society: Series B},
+ *   volume={71},
+ *   number={3},
+ *   pages={593--613},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * Each step computes the expected sufficient statistics (the weight, the mean
+ * and the scatter of each component) on a mini-batch of observations and
+ * moves the statistics of the model towards them with the step size
+ * (t + offset)^-decay, where t is the number of steps taken so far.  The
+ * statistics of the model are recovered from its current parameters, so the
+ * only state kept between steps is the step count.  A decay between 0.5 and 1
+ * guarantees convergence.
+ *
+ * Step() can be called directly (or through GMM::Update()) to keep a model up
+ * to date on a stream of data.  Estimate() makes this class usable as the
+ * FittingType of GMM::Train(): it makes one pass over the observations in
+ * shuffled mini-batches, after an optional initial clustering.
+ *
+ * @tparam InitialClusteringType Clustering used to build the initial model
+ *     (see EMFit).
+ * @tparam CovarianceConstraintPolicy Constraint applied to each updated
+ *     covariance.
+ * @tparam Distribution Type of the components (GaussianDistribution or
+ *     DiagonalGaussianDistribution).
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object.
+   *
+   * @param batchSize Number of observations in each mini-batch of Estimate().
+   * @param decay Exponent of the step size decay; should be in (0.5, 1].
+   * @param offset Offset of the step count in the step size; larger values
+   *     make the first steps smaller.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  OnlineEMFit(const size_t batchSize = 1000,
+              const double decay = 0.6,
+              const double offset = 2.0,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model with one pass of online
+   * EM over shuffled mini-batches.  The size of the vectors (indicating the
+   * number of components) must already be set.  If useInitialModel is false,
+   * the initial model is built with the clusterer first.  The step count is
+   * reset to 0, so each call starts with the largest step size.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model with one pass of online
+   * EM, taking into account the probabilities of each point being from this
+   * mixture.  The step count is reset to 0, like in Estimate() above.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Take one step of online EM on the given mini-batch.  The model must
+   * already be initialized.
+   *
+   * @param batch Mini-batch of observations.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @return Log-likelihood of the mini-batch under the model before the step.
+   */
+  double Step(const arma::mat& batch,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  /**
+   * Take one step of online EM on the given mini-batch, taking into account
+   * the probability of each point being from this mixture.
+   *
+   * @param batch Mini-batch of observations.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   * @return Log-likelihood of the mini-batch under the model before the step.
+   */
+  double Step(const arma::mat& batch,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the mini-batch size used by Estimate().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the mini-batch size used by Estimate().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the step size decay.
+  double Decay() const { return decay; }
+  //! Modify the step size decay.
+  double& Decay() { return decay; }
+
+  //! Get the step count offset.
+  double Offset() const { return offset; }
+  //! Modify the step count offset.
+  double& Offset() { return offset; }
+
+  //! Get the number of steps taken so far.
+  size_t Steps() const { return steps; }
+  //! Modify the number of steps taken so far (set to 0 to restart).
+  size_t& Steps() { return steps; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! Number of observations in each mini-batch of Estimate().
+  size_t batchSize;
+  //! Exponent of the step size decay.
+  double decay;
+  //! Offset of the step count in the step size.
+  double offset;
+  //! Number of steps taken so far.
+  size_t steps;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
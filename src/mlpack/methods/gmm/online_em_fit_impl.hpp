@@ -0,0 +1,235 @@
+/**
+ * @file methods/gmm/online_em_fit_impl.hpp
+ *
+ * Implementation of the online EM algorithm for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+OnlineEMFit(const size_t batchSize,
+            const double decay,
+            const double offset,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    decay(decay),
+    offset(offset),
+    steps(0),
+    clusterer(clusterer),
+    constraint(constraint)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  Estimate(observations, arma::vec(), dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("OnlineEMFit::Estimate(): the batch size must "
+        "be positive!");
+  }
+
+  // Each fit starts with the largest steps; GMM::Train() uses the same fitter
+  // for every trial.
+  steps = 0;
+
+  // EMFit stops before the first M-step when it is only allowed one iteration,
+  // so this only builds the initial model from the clustering.
+  if (!useInitialModel)
+  {
+    EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+        initialFit(1, 1e-10, clusterer, constraint);
+    initialFit.Estimate(observations, dists, weights, false);
+  }
+
+  // Visit the observations in a random order, so that each mini-batch is a
+  // sample of the whole dataset.
+  const arma::uvec order = arma::randperm(observations.n_cols);
+  for (size_t begin = 0; begin < observations.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize,
+        (size_t) observations.n_cols);
+    const arma::uvec batchIndices = order.subvec(begin, end - 1);
+
+    double logLikelihood;
+    if (probabilities.is_empty())
+    {
+      logLikelihood = Step(observations.cols(batchIndices), dists, weights);
+    }
+    else
+    {
+      logLikelihood = Step(observations.cols(batchIndices),
+          probabilities.elem(batchIndices), dists, weights);
+    }
+
+    Log::Debug << "OnlineEMFit::Estimate(): step " << steps << ", mini-batch "
+        << "log-likelihood " << logLikelihood << "." << std::endl;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& batch,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights)
+{
+  return Step(batch, arma::vec(), dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& batch,
+                        const arma::vec& probabilities,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights)
+{
+  if (batch.n_cols == 0)
+    return 0.0;
+
+  // Calculate the conditional probabilities of choosing a particular Gaussian
+  // given the observations and the present theta value.
+  arma::mat condLogProb(dists.size(), batch.n_cols);
+  arma::vec logPhis;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].LogProbability(batch, logPhis);
+    condLogProb.row(i) = log(weights[i]) + logPhis.t();
+  }
+
+  // Normalize each point.  A point with zero likelihood under every component
+  // ends up with zero probabilities and does not contribute to the step.
+  double logLikelihood = 0.0;
+  for (size_t j = 0; j < batch.n_cols; ++j)
+  {
+    const double probSum = mlpack::math::AccuLog(condLogProb.col(j));
+    logLikelihood += probSum;
+    if (probSum != -std::numeric_limits<double>::infinity())
+      condLogProb.col(j) -= probSum;
+  }
+
+  arma::mat condProb = arma::exp(condLogProb);
+  double total = batch.n_cols;
+  if (!probabilities.is_empty())
+  {
+    condProb.each_row() %= probabilities.t();
+    total = arma::accu(probabilities);
+  }
+
+  // The step size decays with the number of steps taken.
+  const double stepSize = std::min(1.0, std::pow(steps + offset, -decay));
+  ++steps;
+
+  // If the distribution is DiagonalGaussianDistribution, calculate the
+  // covariance only with diagonal components.
+  const bool isDiagGaussDist = std::is_same<Distribution,
+      distribution::DiagonalGaussianDistribution>::value;
+
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const double newWeight = (1.0 - stepSize) * weights[i] +
+        stepSize * arma::accu(condProb.row(i)) / total;
+
+    // Don't update if there's no probability of the Gaussian having points.
+    if (newWeight <= 0.0)
+    {
+      weights[i] = 0.0;
+      continue;
+    }
+
+    // The statistics are centered on the current mean, so the first-order
+    // statistic of the current model is zero and only the mini-batch moves the
+    // mean.
+    const arma::mat diffs = batch.each_col() - dists[i].Mean();
+    const arma::vec shift = stepSize * (diffs * condProb.row(i).t()) /
+        (total * newWeight);
+
+    if (isDiagGaussDist)
+    {
+      arma::vec covariance = ((1.0 - stepSize) * weights[i] *
+          dists[i].Covariance() + stepSize * (arma::square(diffs) *
+          condProb.row(i).t()) / total) / newWeight - arma::square(shift);
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+    else
+    {
+      arma::mat covariance = ((1.0 - stepSize) * weights[i] *
+          dists[i].Covariance() + stepSize * ((diffs.each_row() %
+          condProb.row(i)) * diffs.t()) / total) / newWeight - shift *
+          shift.t();
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariance);
+      dists[i].Covariance(std::move(covariance));
+    }
+
+    dists[i].Mean() += shift;
+    weights[i] = newWeight;
+  }
+
+  // Points with zero likelihood leave the weights slightly short of one.
+  weights /= arma::accu(weights);
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(decay);
+  ar & BOOST_SERIALIZATION_NVP(offset);
+  ar & BOOST_SERIALIZATION_NVP(steps);
+  ar & BOOST_SERIALIZATION_NVP(clusterer);
+  ar & BOOST_SERIALIZATION_NVP(constraint);
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -290,6 +290,32 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are processed in
+   * parallel with OpenMP.
+   *
+   * @param dataSeq Sequences of observations.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    data sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of each most
+   *    probable state sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t>>& stateSeq,
+               arma::vec& logLikelihoods) const;
+
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are processed in parallel with OpenMP.
+   *
+   * @param dataSeq Data sequences to evaluate the likelihood of.
+   * @param logLikelihoods Vector in which the log-likelihood of each sequence
+   *    will be stored.
+   */
+  void LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                     arma::vec& logLikelihoods) const;
+
   /**
    * HMM filtering. Computes the k-step-ahead expected emission at each time
    * conditioned only on prior observations. That is
@@ -399,6 +425,45 @@ class HMM
                 const arma::vec& logScales,
                 arma::mat& backwardLogProb) const;
 
+  /**
+   * Compute the log-probability of each observation in the given data sequence
+   * under the emission distribution of each hidden state.  The returned matrix
+   * has rows equal to the number of hidden states and columns equal to the
+   * number of observations.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logEmission Matrix in which emission log-probabilities will be
+   *     saved.
+   */
+  void LogEmission(const arma::mat& dataSeq, arma::mat& logEmission) const;
+
+  /**
+   * The Forward algorithm, given the emission log-probabilities computed by
+   * LogEmission().  Each step is one product of the transition matrix with the
+   * (normalized) forward probabilities of the previous step.
+   *
+   * @param logEmission Emission log-probabilities of the data sequence.
+   * @param logScales Vector in which scaling factors will be saved.
+   * @param forwardLogProb Matrix in which forward probabilities will be saved.
+   */
+  void LogForward(const arma::mat& logEmission,
+                  arma::vec& logScales,
+                  arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm, given the emission log-probabilities computed by
+   * LogEmission() and the scaling factors found by LogForward().  Each step is
+   * one product of the transposed transition matrix with the backward
+   * probabilities of the next step.
+   *
+   * @param logEmission Emission log-probabilities of the data sequence.
+   * @param logScales Vector of scaling factors.
+   * @param backwardLogProb Matrix in which backward probabilities will be saved.
+   */
+  void LogBackward(const arma::mat& logEmission,
+                   const arma::vec& logScales,
+                   arma::mat& backwardLogProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
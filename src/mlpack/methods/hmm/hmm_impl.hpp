@@ -101,10 +101,13 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Maximum iterations?
   size_t iterations = 1000;
 
-  // Find length of all sequences and ensure they are the correct size.
+  // Find length of all sequences and ensure they are the correct size.  Each
+  // sequence gets its own range of the emission list, starting at its offset.
   size_t totalLength = 0;
+  std::vector<size_t> offsets(dataSeq.size());
   for (size_t seq = 0; seq < dataSeq.size(); seq++)
   {
+    offsets[seq] = totalLength;
     totalLength += dataSeq[seq].n_cols;
 
     if (dataSeq[seq].n_rows != dimensionality)
@@ -114,10 +117,22 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The list of
+  // emissions is the same for every iteration.
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(offsets[seq], offsets[seq] + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    }
+  }
+
+  // The log-space parameters must be in sync before the threads use them.
+  ConvertToLogSpace();
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -133,53 +148,82 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // The sequences are independent, so each thread handles some of them and
+    // accumulates its own statistics, which are then combined.
+    #pragma omp parallel
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < logTransition.n_cols; ++j)
-        newLogInitial[j] = math::LogAdd(newLogInitial[j], stateLogProb(j, 0));
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      arma::vec localLogInitial(logTransition.n_rows);
+      localLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat localLogTransition(logTransition.n_rows, logTransition.n_cols);
+      localLogTransition.fill(-std::numeric_limits<double>::infinity());
+
+      #pragma omp for schedule(dynamic) reduction(+:loglik)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
+        arma::mat logEmission;
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        LogEmission(dataSeq[seq], logEmission);
+        LogForward(logEmission, logScales, forwardLog);
+        LogBackward(logEmission, logScales, backwardLog);
+        loglik += arma::accu(logScales);
+
+        const arma::mat stateLogProb = forwardLog + backwardLog;
+
+        // Add to estimate of initial probability for state j.
         for (size_t j = 0; j < logTransition.n_cols; ++j)
         {
-          if (t < dataSeq[seq].n_cols - 1)
+          localLogInitial[j] = math::LogAdd(localLogInitial[j],
+              stateLogProb(j, 0));
+        }
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        for (size_t t = 0; t + 1 < dataSeq[seq].n_cols; ++t)
+        {
+          // Estimate of T_ij (probability of transition from state j to state
+          // i).  We postpone multiplication of the old T_ij until later.
+          const arma::vec nextLogProb = backwardLog.col(t + 1) +
+              logEmission.col(t + 1) - logScales[t + 1];
+          for (size_t j = 0; j < logTransition.n_cols; ++j)
           {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
             for (size_t i = 0; i < logTransition.n_rows; ++i)
             {
-              newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
-                  forwardLog(j, t) + backwardLog(i, t + 1) +
-                  emission[i].LogProbability(dataSeq[seq].unsafe_col(t + 1)) -
-                  logScales[t + 1]);
+              localLogTransition(i, j) = math::LogAdd(localLogTransition(i, j),
+                  forwardLog(j, t) + nextLogProb[i]);
             }
           }
+        }
 
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
+        // Store the emission probabilities, for Distribution::Train().
+        for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+        {
+          for (size_t j = 0; j < logTransition.n_cols; ++j)
+            emissionProb[j][offsets[seq] + t] = exp(stateLogProb(j, t));
+        }
+      }
+
+      #pragma omp critical
+      {
+        for (size_t j = 0; j < newLogInitial.n_elem; ++j)
+        {
+          newLogInitial[j] = math::LogAdd(newLogInitial[j],
+              localLogInitial[j]);
+        }
+
+        for (size_t i = 0; i < newLogTransition.n_elem; ++i)
+        {
+          newLogTransition[i] = math::LogAdd(newLogTransition[i],
+              localLogTransition[i]);
         }
-        sumTime++;
       }
     }
 
@@ -338,8 +382,10 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::vec& logScales) const
 {
   // First run the forward-backward algorithm.
-  Forward(dataSeq, logScales, forwardLogProb);
-  Backward(dataSeq, logScales, backwardLogProb);
+  arma::mat logEmission;
+  LogEmission(dataSeq, logEmission);
+  LogForward(logEmission, logScales, forwardLogProb);
+  LogBackward(logEmission, logScales, backwardLogProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
@@ -459,43 +505,42 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
   // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
+  // probable sequence of states to produce the observed data sequence.
   stateSeq.set_size(dataSeq.n_cols);
   arma::mat logStateProb(logTransition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
+  arma::umat stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
 
   ConvertToLogSpace();
 
+  arma::mat logEmission;
+  LogEmission(dataSeq, logEmission);
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-    stateSeqBack(state, 0) = state;
-  }
+  logStateProb.col(0) = logInitial + logEmission.col(0);
+  stateSeqBack.col(0) = arma::regspace<arma::uvec>(0,
+      logTransition.n_rows - 1);
 
-  // Store the best first state.
-  arma::uword index;
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
     // Assemble the state probability for this element.
     // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
+    // of being the previous state.  Row j of 'prob' holds the log-probability
+    // of each previous state followed by a transition to state j, so this is
+    // one max-plus product of the transition matrix and the previous column.
+    const arma::mat prob = logTransition.each_row() +
+        logStateProb.col(t - 1).t();
+    const arma::uvec best = arma::index_max(prob, 1);
     for (size_t j = 0; j < logTransition.n_rows; ++j)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      logStateProb(j, t) = prob.max(index) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
-      stateSeqBack(j, t) = index;
+      logStateProb(j, t) = prob(j, best[j]) + logEmission(j, t);
+      stateSeqBack(j, t) = best[j];
     }
   }
 
   // Backtrack to find the most probable state sequence.
+  arma::uword index;
   logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
   stateSeq[dataSeq.n_cols - 1] = index;
   for (size_t t = 2; t <= dataSeq.n_cols; t++)
@@ -522,6 +567,42 @@ double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
   return accu(logScales);
 }
 
+/**
+ * Compute the most probable hidden state sequences of the given data sequences.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Row<size_t>>& stateSeq,
+                                arma::vec& logLikelihoods) const
+{
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
+
+  // The log-space parameters must be in sync before the threads use them.
+  ConvertToLogSpace();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dataSeq.size(); ++i)
+    logLikelihoods[i] = Predict(dataSeq[i], stateSeq[i]);
+}
+
+/**
+ * Compute the log-likelihood of each of the given data sequences.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogLikelihood(const std::vector<arma::mat>& dataSeq,
+                                      arma::vec& logLikelihoods) const
+{
+  logLikelihoods.set_size(dataSeq.size());
+
+  // The log-space parameters must be in sync before the threads use them.
+  ConvertToLogSpace();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dataSeq.size(); ++i)
+    logLikelihoods[i] = LogLikelihood(dataSeq[i]);
+}
+
 /**
  * HMM filtering.
  */
@@ -577,13 +658,51 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& logScales,
                                 arma::mat& forwardLogProb) const
+{
+  arma::mat logEmission;
+  LogEmission(dataSeq, logEmission);
+  LogForward(logEmission, logScales, forwardLogProb);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& logScales,
+                                 arma::mat& backwardLogProb) const
+{
+  arma::mat logEmission;
+  LogEmission(dataSeq, logEmission);
+  LogBackward(logEmission, logScales, backwardLogProb);
+}
+
+/**
+ * Compute the emission log-probabilities of each observation for each state.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogEmission(const arma::mat& dataSeq,
+                                    arma::mat& logEmission) const
+{
+  // Each emission probability is needed several times by the forward and
+  // backward procedures, so it is computed only once here.
+  logEmission.set_size(emission.size(), dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; ++t)
+  {
+    for (size_t state = 0; state < emission.size(); ++state)
+    {
+      logEmission(state, t) =
+          emission[state].LogProbability(dataSeq.unsafe_col(t));
+    }
+  }
+}
+
+template<typename Distribution>
+void HMM<Distribution>::LogForward(const arma::mat& logEmission,
+                                   arma::vec& logScales,
+                                   arma::mat& forwardLogProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
-  forwardLogProb.fill(-std::numeric_limits<double>::infinity());
-  logScales.resize(dataSeq.n_cols);
-  logScales.fill(-std::numeric_limits<double>::infinity());
+  forwardLogProb.set_size(logTransition.n_rows, logEmission.n_cols);
+  logScales.set_size(logEmission.n_cols);
 
   ConvertToLogSpace();
 
@@ -592,29 +711,28 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    forwardLogProb(state, 0) = logInitial(state) +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-  }
+  forwardLogProb.col(0) = logInitial + logEmission.col(0);
 
   // Then normalize the column.
   logScales[0] = math::AccuLog(forwardLogProb.col(0));
   if (std::isfinite(logScales[0]))
     forwardLogProb.col(0) -= logScales[0];
 
+  // Each column is normalized, so its exponential is a probability vector and
+  // the sum over the previous states is done in linear space, with the
+  // transition matrix that transitionProxy already holds.  Terms with very
+  // small transition probabilities may underflow to zero there, which drops
+  // them from the sum.
+  const arma::mat& transition = transitionProxy;
+
   // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < logEmission.n_cols; t++)
   {
-    for (size_t j = 0; j < logTransition.n_rows; ++j)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      arma::vec tmp = forwardLogProb.col(t - 1) + logTransition.row(j).t();
-      forwardLogProb(j, t) = math::AccuLog(tmp) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
-    }
+    // The forward probability of state j at time t is the sum over all states
+    // of the probability of the previous state transitioning to the current
+    // state and emitting the given observation.
+    forwardLogProb.col(t) = arma::log(transition *
+        arma::exp(forwardLogProb.col(t - 1))) + logEmission.col(t);
 
     // Normalize probability.
     logScales[t] = math::AccuLog(forwardLogProb.col(t));
@@ -624,38 +742,44 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
 }
 
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& logScales,
-                                 arma::mat& backwardLogProb) const
+void HMM<Distribution>::LogBackward(const arma::mat& logEmission,
+                                    const arma::vec& logScales,
+                                    arma::mat& backwardLogProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardLogProb.resize(logTransition.n_rows, dataSeq.n_cols);
-  backwardLogProb.fill(-std::numeric_limits<double>::infinity());
+  backwardLogProb.set_size(logTransition.n_rows, logEmission.n_cols);
+
+  ConvertToLogSpace();
+  const arma::mat& transition = transitionProxy;
 
   // The last element probability is 1.
-  backwardLogProb.col(dataSeq.n_cols - 1).fill(0);
+  backwardLogProb.col(logEmission.n_cols - 1).fill(0);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  for (size_t t = logEmission.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < logTransition.n_rows; ++j)
+    // The backward probability of state j at time t is the sum over all states
+    // of the probability of the next state having been a transition from the
+    // current state multiplied by the probability of each of those states
+    // emitting the given observation.  The sum is done in linear space after
+    // shifting by the largest term; as in LogForward(), terms with very small
+    // transition probabilities may underflow to zero.
+    const arma::vec next = backwardLogProb.col(t + 1) + logEmission.col(t + 1);
+    const double shift = next.max();
+    if (std::isfinite(shift))
     {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < logTransition.n_rows; state++)
-      {
-        backwardLogProb(j, t) = math::LogAdd(backwardLogProb(j, t),
-            logTransition(state, j) + backwardLogProb(state, t + 1)
-            + emission[state].LogProbability(dataSeq.unsafe_col(t + 1)));
-      }
-
-      // Normalize by the weights from the forward algorithm.
-      if (std::isfinite(logScales[t + 1]))
-        backwardLogProb(j, t) -= logScales[t + 1];
+      backwardLogProb.col(t) = arma::log(transition.t() *
+          arma::exp(next - shift)) + shift;
     }
+    else
+    {
+      backwardLogProb.col(t).fill(-std::numeric_limits<double>::infinity());
+    }
+
+    // Normalize by the weights from the forward algorithm.
+    if (std::isfinite(logScales[t + 1]))
+      backwardLogProb.col(t) -= logScales[t + 1];
   }
 }
 
@@ -44,7 +44,14 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Sequence Log-Likelihood",
     PRINT_DATASET("seq") + " with the pre-trained HMM " + PRINT_MODEL("hmm") +
     ", the following command may be used: "
     "\n\n" +
-    PRINT_CALL("hmm_loglik", "input", "seq", "input_model", "hmm"),
+    PRINT_CALL("hmm_loglik", "input", "seq", "input_model", "hmm") +
+    "\n\n"
+    "Many sequences can be evaluated at once (in parallel, if OpenMP is "
+    "available) by concatenating them in " + PRINT_PARAM_STRING("input") +
+    " and giving the number of observations in each sequence with the " +
+    PRINT_PARAM_STRING("lengths") + " parameter.  The log-likelihood of each "
+    "sequence is then given by the " + PRINT_PARAM_STRING("log_likelihoods") +
+    " output, and " + PRINT_PARAM_STRING("log_likelihood") + " is their sum.",
     SEE_ALSO("@hmm_train", "#hmm_train"),
     SEE_ALSO("@hmm_generate", "#hmm_generate"),
     SEE_ALSO("@hmm_viterbi", "#hmm_viterbi"),
@@ -56,7 +63,12 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Sequence Log-Likelihood",
 PARAM_MATRIX_IN_REQ("input", "File containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "File containing HMM.", "m");
 
+PARAM_UROW_IN("lengths", "Lengths of the sequences concatenated in the input "
+    "matrix, if there are many sequences.", "l");
+
 PARAM_DOUBLE_OUT("log_likelihood", "Log-likelihood of the sequence.");
+PARAM_COL_OUT("log_likelihoods", "Log-likelihood of each sequence, if "
+    "lengths are given.", "L");
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -70,7 +82,8 @@ struct Loglik
 
     // Detect if we need to transpose the data, in the case where the input data
     // has one dimension.
-    if ((dataSeq.n_cols == 1) && (hmm.Emission()[0].Dimensionality() == 1))
+    if (!IO::HasParam("lengths") && (dataSeq.n_cols == 1) &&
+        (hmm.Emission()[0].Dimensionality() == 1))
     {
       Log::Info << "Data sequence appears to be transposed; correcting."
           << endl;
@@ -84,9 +97,26 @@ struct Loglik
           << hmm.Emission()[0].Dimensionality() << ")!" << endl;
     }
 
-    const double loglik = hmm.LogLikelihood(dataSeq);
+    if (IO::HasParam("lengths"))
+    {
+      // Split the observations into the individual sequences.
+      const arma::Row<size_t>& lengths = IO::GetParam<arma::Row<size_t>>(
+          "lengths");
+      std::vector<mat> sequences;
+      SplitSequences(dataSeq, lengths, sequences);
+
+      arma::vec logLikelihoods;
+      hmm.LogLikelihood(sequences, logLikelihoods);
 
-    IO::GetParam<double>("log_likelihood") = loglik;
+      IO::GetParam<double>("log_likelihood") = arma::accu(logLikelihoods);
+      IO::GetParam<arma::vec>("log_likelihoods") = std::move(logLikelihoods);
+    }
+    else
+    {
+      const double loglik = hmm.LogLikelihood(dataSeq);
+
+      IO::GetParam<double>("log_likelihood") = loglik;
+    }
   }
 };
 
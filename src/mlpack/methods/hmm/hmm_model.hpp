@@ -219,6 +219,38 @@ class HMMModel
   HMM<gmm::DiagonalGMM>* DiagGMMHMM() { return diagGMMHMM; }
 };
 
+/**
+ * Split the observations given to an HMM binding into the individual sequences
+ * given by the lengths parameter.  A fatal error is issued if the lengths don't
+ * add up to the number of observations or a sequence is empty.
+ *
+ * @param observations Concatenated observations, one per column.
+ * @param lengths Number of observations in each sequence.
+ * @param sequences Vector to store the sequences in.
+ */
+inline void SplitSequences(const arma::mat& observations,
+                           const arma::Row<size_t>& lengths,
+                           std::vector<arma::mat>& sequences)
+{
+  if (arma::accu(lengths) != observations.n_cols)
+  {
+    Log::Fatal << "Sum of sequence lengths (" << arma::accu(lengths)
+        << ") does not match the number of observations ("
+        << observations.n_cols << ")!" << std::endl;
+  }
+
+  sequences.resize(lengths.n_elem);
+  size_t begin = 0;
+  for (size_t i = 0; i < lengths.n_elem; ++i)
+  {
+    if (lengths[i] == 0)
+      Log::Fatal << "Sequence " << i << " is empty!" << std::endl;
+
+    sequences[i] = observations.cols(begin, begin + lengths[i] - 1);
+    begin += lengths[i];
+  }
+}
+
 } // namespace hmm
 } // namespace mlpack
 
@@ -48,7 +48,14 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction",
     ", the following command could be used:"
     "\n\n" +
     PRINT_CALL("hmm_viterbi", "input", "obs", "input_model", "hmm", "output",
-        "states"),
+        "states") +
+    "\n\n"
+    "Many sequences can be processed at once (in parallel, if OpenMP is "
+    "available) by concatenating them in " + PRINT_PARAM_STRING("input") +
+    " and giving the number of observations in each sequence with the " +
+    PRINT_PARAM_STRING("lengths") + " parameter.  The state sequences are "
+    "then concatenated in the same way in " + PRINT_PARAM_STRING("output") +
+    ".",
     SEE_ALSO("@hmm_train", "#hmm_train"),
     SEE_ALSO("@hmm_generate", "#hmm_generate"),
     SEE_ALSO("@hmm_loglik", "#hmm_loglik"),
@@ -59,6 +66,8 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction",
 
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
+PARAM_UROW_IN("lengths", "Lengths of the sequences concatenated in the input "
+    "matrix, if there are many sequences.", "l");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
 
 // Because we don't know what the type of our HMM is, we need to write a
@@ -72,7 +81,8 @@ struct Viterbi
     mat dataSeq = std::move(IO::GetParam<arma::mat>("input"));
 
     // See if transposing the data could make it the right dimensionality.
-    if ((dataSeq.n_cols == 1) && (hmm.Emission()[0].Dimensionality() == 1))
+    if (!IO::HasParam("lengths") && (dataSeq.n_cols == 1) &&
+        (hmm.Emission()[0].Dimensionality() == 1))
     {
       Log::Info << "Data sequence appears to be transposed; correcting."
           << endl;
@@ -88,7 +98,30 @@ struct Viterbi
     }
 
     arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    if (IO::HasParam("lengths"))
+    {
+      // Split the observations into the individual sequences.
+      const arma::Row<size_t>& lengths = IO::GetParam<arma::Row<size_t>>(
+          "lengths");
+      std::vector<mat> sequences;
+      SplitSequences(dataSeq, lengths, sequences);
+
+      std::vector<arma::Row<size_t>> stateSequences;
+      arma::vec logLikelihoods;
+      hmm.Predict(sequences, stateSequences, logLikelihoods);
+
+      sequence.set_size(dataSeq.n_cols);
+      size_t begin = 0;
+      for (size_t i = 0; i < stateSequences.size(); ++i)
+      {
+        sequence.cols(begin, begin + lengths[i] - 1) = stateSequences[i];
+        begin += lengths[i];
+      }
+    }
+    else
+    {
+      hmm.Predict(dataSeq, sequence);
+    }
 
     // Save output.
     IO::GetParam<arma::Mat<size_t>>("output") = std::move(sequence);
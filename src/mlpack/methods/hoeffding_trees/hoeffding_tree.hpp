@@ -314,6 +314,32 @@ class HoeffdingTree
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  //! Leaves update the statistics of their dimensions in parallel tasks that
+  //! each take about this many values (points times dimensions).  The chunks
+  //! between two split checks are small (checkInterval points), so the
+  //! dimensions are grouped into tasks by the number of values.
+  static const size_t ParallelUpdateCutoff = 1000;
+  //! Nodes given at least this many points train their children in parallel.
+  static const size_t ParallelTrainCutoff = 10000;
+
+  /**
+   * Train on the points of the data with the given indices, in the order of
+   * the indices.  This gives the same tree as calling Train() on each point in
+   * turn: a leaf takes all the points up to its next split check at once, and
+   * updates the statistics of groups of dimensions with them in parallel, and
+   * once
+   * a node has split its remaining points are routed to the children, which
+   * are trained in parallel.
+   *
+   * @param data Data points to train on.
+   * @param labels Labels of data points.
+   * @param points Indices of the points to train on, in training order.
+   */
+  template<typename MatType>
+  void TrainPoints(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const arma::Col<size_t>& points);
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
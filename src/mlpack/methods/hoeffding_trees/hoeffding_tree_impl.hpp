@@ -251,6 +251,10 @@ void HoeffdingTree<
          const arma::Row<size_t>& labels,
          const bool batchTraining)
 {
+  arma::Col<size_t> points(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    points[i] = i;
+
   if (batchTraining)
   {
     // Pass all the points through the nodes, and then split only after that.
@@ -258,8 +262,7 @@ void HoeffdingTree<
     // Don't split if there are fewer than five points.
     size_t oldMaxSamples = maxSamples;
     maxSamples = std::max(size_t(data.n_cols - 1), size_t(5));
-    for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    TrainPoints(data, labels, points);
     maxSamples = oldMaxSamples;
 
     // Now, if we did split, find out which points go to which child, and
@@ -310,9 +313,9 @@ void HoeffdingTree<
   }
   else
   {
-    // We aren't training in batch mode; loop through the points.
-    for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    // We aren't training in batch mode; the points are seen in order, as if
+    // they were given one at a time.
+    TrainPoints(data, labels, points);
   }
 }
 
@@ -429,6 +432,134 @@ void HoeffdingTree<
   }
 }
 
+//! Train on the points with the given indices.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainPoints(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const arma::Col<size_t>& points)
+{
+  if (points.n_elem == 0)
+    return;
+
+  // The training is started by a single thread; the tasks created below are
+  // picked up by the other threads.  If we are already inside a parallel
+  // region, the tasks are run by the threads of that region instead.
+  bool startParallelRegion = false;
+  #ifdef HAS_OPENMP
+    startParallelRegion =
+        (points.n_elem * data.n_rows >= 2 * ParallelUpdateCutoff) &&
+        (omp_get_level() == 0);
+  #endif
+
+  if (startParallelRegion)
+  {
+    #pragma omp parallel
+    {
+      #pragma omp single
+      TrainPoints(data, labels, points);
+    }
+    return;
+  }
+
+  size_t i = 0;
+  while (i < points.n_elem && splitDimension == size_t(-1))
+  {
+    // Take every point up to the next split check.  The statistics of each
+    // dimension only depend on the values of that dimension, so each
+    // dimension can be updated separately, as long as its values are given in
+    // order.  There are at most checkInterval points, so the dimensions are
+    // grouped into tasks that each update about ParallelUpdateCutoff values.
+    const size_t count = std::min(size_t(points.n_elem - i),
+        checkInterval - (numSamples % checkInterval));
+    const size_t taskDimensions = std::max(size_t(1),
+        size_t(ParallelUpdateCutoff / count));
+    for (size_t first = 0; first < data.n_rows; first += taskDimensions)
+    {
+      #pragma omp task default(shared) firstprivate(first) \
+          if (taskDimensions < data.n_rows)
+      {
+        const size_t last = std::min(size_t(data.n_rows),
+            first + taskDimensions);
+        for (size_t d = first; d < last; ++d)
+        {
+          const size_t type = dimensionMappings->at(d).first;
+          const size_t index = dimensionMappings->at(d).second;
+          if (type == data::Datatype::categorical)
+          {
+            for (size_t j = i; j < i + count; ++j)
+              categoricalSplits[index].Train(data(d, points[j]),
+                  labels[points[j]]);
+          }
+          else if (type == data::Datatype::numeric)
+          {
+            for (size_t j = i; j < i + count; ++j)
+            {
+              numericSplits[index].Train(data(d, points[j]),
+                  labels[points[j]]);
+            }
+          }
+        }
+      }
+    }
+    #pragma omp taskwait
+
+    numSamples += count;
+    i += count;
+
+    // Grab majority class from splits.
+    if (categoricalSplits.size() > 0)
+    {
+      majorityClass = categoricalSplits[0].MajorityClass();
+      majorityProbability = categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      majorityClass = numericSplits[0].MajorityClass();
+      majorityProbability = numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split, if we should.
+    if (numSamples % checkInterval == 0)
+    {
+      const size_t numChildren = SplitCheck();
+      if (numChildren > 0)
+      {
+        children.clear();
+        CreateChildren();
+      }
+    }
+  }
+
+  if (i == points.n_elem)
+    return;
+
+  // We have split, so pass the rest of the points to the children, keeping
+  // their order.
+  std::vector<std::vector<size_t>> childPoints(children.size());
+  for (; i < points.n_elem; ++i)
+    childPoints[CalculateDirection(data.col(points[i]))].push_back(points[i]);
+
+  // Each child sees a different set of points, so the children can be trained
+  // in parallel.
+  for (size_t c = 0; c < children.size(); ++c)
+  {
+    #pragma omp task default(shared) firstprivate(c) \
+        if (childPoints[c].size() >= ParallelTrainCutoff)
+    {
+      children[c]->TrainPoints(data, labels,
+          arma::Col<size_t>(childPoints[c]));
+    }
+  }
+  #pragma omp taskwait
+}
+
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType>
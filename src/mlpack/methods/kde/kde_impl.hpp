@@ -12,6 +12,7 @@
 
 #include "kde.hpp"
 #include "kde_rules.hpp"
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 
 namespace mlpack {
 namespace kde {
@@ -395,12 +396,30 @@ Evaluate(MatType querySet, arma::vec& estimations)
                               monteCarlo,
                               false);
 
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
+    if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+      rules.InitializeAlpha(*referenceTree);
 
-    // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Traverse for each point.  The query points are split between threads,
+    // and each thread works with its own copy of the rules; the results and
+    // the error tolerance of each point are the same as with a serial
+    // traversal.
+    size_t baseCases = 0;
+    size_t scores = 0;
+    #pragma omp parallel reduction(+:baseCases, scores)
+    {
+      RuleType threadRules(rules);
+      SingleTreeTraversalType<RuleType> traverser(threadRules);
+
+      #pragma omp for schedule(dynamic, 64)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      baseCases += threadRules.BaseCases();
+      scores += threadRules.Scores();
+    }
+
+    rules.BaseCases() += baseCases;
+    rules.Scores() += scores;
 
     estimations /= referenceTree->Dataset().n_cols;
     Timer::Stop("computing_kde");
@@ -493,8 +512,13 @@ Evaluate(Tree* queryTree,
                             monteCarlo,
                             false);
 
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
+  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+    rules.InitializeAlpha(*referenceTree);
+
+  // Create traverser.  Independent query subtrees are traversed in parallel if
+  // OpenMP is available.
+  tree::ParallelDualTreeTraverser<RuleType, DualTreeTraversalType>
+      traverser(rules);
   traverser.Traverse(*queryTree, *referenceTree);
   estimations /= referenceTree->Dataset().n_cols;
   Timer::Stop("computing_kde");
@@ -562,17 +586,41 @@ Evaluate(arma::vec& estimations)
                             monteCarlo,
                             true);
 
+  if (monteCarlo && std::is_same<KernelType, kernel::GaussianKernel>::value)
+    rules.InitializeAlpha(*referenceTree);
+
   if (mode == DUAL_TREE_MODE)
   {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
+    // Create traverser.  Independent query subtrees are traversed in parallel
+    // if OpenMP is available.
+    tree::ParallelDualTreeTraverser<RuleType, DualTreeTraversalType>
+        traverser(rules);
     traverser.Traverse(*referenceTree, *referenceTree);
   }
   else if (mode == SINGLE_TREE_MODE)
   {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // The query points are split between threads, each with its own copy of
+    // the rules.
+    size_t baseCases = 0;
+    size_t scores = 0;
+    #pragma omp parallel reduction(+:baseCases, scores)
+    {
+      RuleType threadRules(rules);
+      SingleTreeTraversalType<RuleType> traverser(threadRules);
+
+      #pragma omp for schedule(dynamic, 64)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceTree->Dataset().n_cols;
+          ++i)
+      {
+        traverser.Traverse(i, *referenceTree);
+      }
+
+      baseCases += threadRules.BaseCases();
+      scores += threadRules.Scores();
+    }
+
+    rules.BaseCases() += baseCases;
+    rules.Scores() += scores;
   }
 
   estimations /= referenceTree->Dataset().n_cols;
@@ -15,12 +15,22 @@
 
 #include <mlpack/core/tree/traversal_info.hpp>
 
+#include <memory>
+
 namespace mlpack {
 namespace kde {
 
 /**
  * A dual-tree traversal Rules class for kernel density estimation.  This
  * contains the Score() and BaseCase() implementations.
+ *
+ * Copies of a KDERules object share the density estimations and the
+ * accumulated error tolerances of each query point, but each copy holds its own
+ * traversal information and base case and score counts.  This allows each
+ * thread (or each task of a tree::ParallelDualTreeTraverser) to work with its
+ * own copy of the rules, so long as the copies work on disjoint sets of query
+ * points.  Before copies are used at the same time with Monte Carlo
+ * estimations, InitializeAlpha() must be called on the reference tree.
  */
 template<typename MetricType, typename KernelType, typename TreeType>
 class KDERules
@@ -87,11 +97,24 @@ class KDERules
   //! Modify traversal information.
   TraversalInfoType& TraversalInfo() { return traversalInfo; }
 
+  /**
+   * Compute the Monte Carlo alpha of every node of the given reference tree.
+   * Score() otherwise computes them lazily, which is not safe when several
+   * copies of the rules traverse the reference tree at the same time.
+   *
+   * @param referenceNode Root of the reference tree.
+   */
+  void InitializeAlpha(TreeType& referenceNode);
+
   //! Get the number of base cases.
   size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
 
   //! Get the number of scores.
   size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
 
  private:
   //! Evaluate kernel value of 2 points given their indexes.
@@ -105,6 +128,12 @@ class KDERules
   //! Calculate depth alpha for some node.
   double CalculateAlpha(TreeType* node);
 
+  //! Draw m indices uniformly from [lo, hiExclusive) for Monte Carlo samples.
+  void SampleDescendants(const size_t m,
+                         const size_t lo,
+                         const size_t hiExclusive,
+                         arma::Col<size_t>& samples) const;
+
   //! The reference set.
   const arma::mat& referenceSet;
 
@@ -145,11 +174,13 @@ class KDERules
   //! Whether Monte Carlo estimations are going to be applied.
   const bool monteCarlo;
 
-  //! Accumulated not used MC alpha values for each query point.
-  arma::vec accumMCAlpha;
+  //! Accumulated not used MC alpha values for each query point.  This is shared
+  //! between copies of the rules.
+  std::shared_ptr<arma::vec> accumMCAlpha;
 
-  //! Accumulated not used error tolerance for each query point.
-  arma::vec accumError;
+  //! Accumulated not used error tolerance for each query point.  This is
+  //! shared between copies of the rules.
+  std::shared_ptr<arma::vec> accumError;
 
   //! Whether reference and query sets are the same.
   const bool sameSet;
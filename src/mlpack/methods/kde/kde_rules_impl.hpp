@@ -49,6 +49,8 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     metric(metric),
     kernel(kernel),
     monteCarlo(monteCarlo),
+    accumMCAlpha(new arma::vec()),
+    accumError(new arma::vec()),
     sameSet(sameSet),
     absErrorTol(absError / referenceSet.n_cols),
     lastQueryIndex(querySet.n_cols),
@@ -57,11 +59,11 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     scores(0)
 {
   // Initialize accumError.
-  accumError = arma::vec(querySet.n_cols, arma::fill::zeros);
+  accumError->zeros(querySet.n_cols);
 
   // Initialize accumMCAlpha only if Monte Carlo estimations are available.
   if (monteCarlo && kernelIsGaussian)
-    accumMCAlpha = arma::vec(querySet.n_cols, arma::fill::zeros);
+    accumMCAlpha->zeros(querySet.n_cols);
 }
 
 //! The base case.
@@ -87,7 +89,7 @@ double KDERules<MetricType, KernelType, TreeType>::BaseCase(
   densities(queryIndex) += kernelValue;
 
   // Update accumulated relative error tolerance for single-tree pruning.
-  accumError(queryIndex) += 2 * relError * kernelValue;
+  (*accumError)(queryIndex) += 2 * relError * kernelValue;
 
   ++baseCases;
   lastQueryIndex = queryIndex;
@@ -151,14 +153,14 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   const double relErrorTol = relError * minKernel;
   const double errorTolerance = absErrorTol + relErrorTol;
 
-  // We relax the bound for pruning by accumError(queryIndex), so that if there
-  // is any leftover error tolerance from the rest of the traversal, we can use
-  // it here to prune more.
+  // We relax the bound for pruning by the accumulated error of the query point,
+  // so that if there is any leftover error tolerance from the rest of the
+  // traversal, we can use it here to prune more.
   double pointAccumErrorTol;
   if (alreadyDidRefPoint0)
-    pointAccumErrorTol = accumError(queryIndex) / (refNumDesc - 1);
+    pointAccumErrorTol = (*accumError)(queryIndex) / (refNumDesc - 1);
   else
-    pointAccumErrorTol = accumError(queryIndex) / refNumDesc;
+    pointAccumErrorTol = (*accumError)(queryIndex) / refNumDesc;
 
   if (bound <= 2 * errorTolerance + pointAccumErrorTol)
   {
@@ -176,13 +178,18 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     // Subtract used error tolerance or add extra available tolerace from this
     // prune.
     if (alreadyDidRefPoint0)
-      accumError(queryIndex) -= (refNumDesc - 1) * (bound - 2 * errorTolerance);
+    {
+      (*accumError)(queryIndex) -=
+          (refNumDesc - 1) * (bound - 2 * errorTolerance);
+    }
     else
-      accumError(queryIndex) -= refNumDesc * (bound - 2 * errorTolerance);
+    {
+      (*accumError)(queryIndex) -= refNumDesc * (bound - 2 * errorTolerance);
+    }
 
     // Store not used alpha for Monte Carlo.
     if (kernelIsGaussian && monteCarlo)
-      accumMCAlpha(queryIndex) += depthAlpha;
+      (*accumMCAlpha)(queryIndex) += depthAlpha;
   }
   else if (monteCarlo &&
            refNumDesc >= mcAccessCoef * initialSampleSize &&
@@ -190,7 +197,7 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   {
     // Monte Carlo probabilistic estimation.
     // Calculate z using accumulated alpha if possible.
-    const double alpha = depthAlpha + accumMCAlpha(queryIndex);
+    const double alpha = depthAlpha + (*accumMCAlpha)(queryIndex);
     const boost::math::normal normalDist;
     const double z =
         std::abs(boost::math::quantile(normalDist, alpha / 2));
@@ -217,17 +224,14 @@ Score(const size_t queryIndex, TreeType& referenceNode)
 
       // Increase the sample size.
       sample.resize(newSize);
+      arma::Col<size_t> randomPoints;
+      SampleDescendants(m, alreadyDidRefPoint0 ? 1 : 0, refNumDesc,
+          randomPoints);
       for (size_t i = 0; i < m; ++i)
       {
-        // Sample and evaluate random points from the reference node.
-        size_t randomPoint;
-        if (alreadyDidRefPoint0)
-          randomPoint = math::RandInt(1, refNumDesc);
-        else
-          randomPoint = math::RandInt(0, refNumDesc);
-
-        sample(oldSize + i) =
-            EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
+        // Evaluate random points from the reference node.
+        sample(oldSize + i) = EvaluateKernel(queryIndex,
+            referenceNode.Descendant(randomPoints[i]));
       }
       meanSample = arma::mean(sample);
       const double stddev = arma::stddev(sample);
@@ -253,7 +257,7 @@ Score(const size_t queryIndex, TreeType& referenceNode)
       score = DBL_MAX;
 
       // Accumulated alpha has been used.
-      accumMCAlpha(queryIndex) = 0;
+      (*accumMCAlpha)(queryIndex) = 0;
     }
     else
     {
@@ -263,7 +267,7 @@ Score(const size_t queryIndex, TreeType& referenceNode)
       if (referenceNode.IsLeaf())
       {
         // Reclaim not used alpha since the node will be exactly computed.
-        accumMCAlpha(queryIndex) += depthAlpha;
+        (*accumMCAlpha)(queryIndex) += depthAlpha;
       }
     }
   }
@@ -276,15 +280,15 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     if (referenceNode.IsLeaf())
     {
       if (alreadyDidRefPoint0)
-        accumError(queryIndex) += (refNumDesc - 1) * 2 * absErrorTol;
+        (*accumError)(queryIndex) += (refNumDesc - 1) * 2 * absErrorTol;
       else
-        accumError(queryIndex) += refNumDesc * 2 * absErrorTol;
+        (*accumError)(queryIndex) += refNumDesc * 2 * absErrorTol;
     }
 
     // If node is going to be exactly computed, reclaim not used alpha for
     // Monte Carlo estimations.
     if (kernelIsGaussian && monteCarlo && referenceNode.IsLeaf())
-      accumMCAlpha(queryIndex) += depthAlpha;
+      (*accumMCAlpha)(queryIndex) += depthAlpha;
   }
 
   ++scores;
@@ -434,17 +438,14 @@ Score(TreeType& queryNode, TreeType& referenceNode)
 
         // Increase the sample size.
         sample.resize(newSize);
+        arma::Col<size_t> randomPoints;
+        SampleDescendants(m, alreadyDidRefPoint0 ? 1 : 0, refNumDesc,
+            randomPoints);
         for (size_t i = 0; i < m; ++i)
         {
-          // Sample and evaluate random points from the reference node.
-          size_t randomPoint;
-          if (alreadyDidRefPoint0)
-            randomPoint = math::RandInt(1, refNumDesc);
-          else
-            randomPoint = math::RandInt(0, refNumDesc);
-
-          sample(oldSize + i) =
-              EvaluateKernel(queryIndex, referenceNode.Descendant(randomPoint));
+          // Evaluate random points from the reference node.
+          sample(oldSize + i) = EvaluateKernel(queryIndex,
+              referenceNode.Descendant(randomPoints[i]));
         }
         meanSample = arma::mean(sample);
         const double stddev = arma::stddev(sample);
@@ -573,6 +574,35 @@ CalculateAlpha(TreeType* node)
   return stat.MCAlpha();
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::
+InitializeAlpha(TreeType& referenceNode)
+{
+  // The alpha of a node depends on the alpha of its parent, so the tree has to
+  // be visited top-down.
+  CalculateAlpha(&referenceNode);
+  for (size_t i = 0; i < referenceNode.NumChildren(); ++i)
+    InitializeAlpha(referenceNode.Child(i));
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline void KDERules<MetricType, KernelType, TreeType>::
+SampleDescendants(const size_t m,
+                  const size_t lo,
+                  const size_t hiExclusive,
+                  arma::Col<size_t>& samples) const
+{
+  // math::RandInt() uses a single global generator, so draws made by copies of
+  // the rules on different threads have to be serialized.  They are drawn all
+  // at once to keep the critical section short.
+  samples.set_size(m);
+  #pragma omp critical(kde_monte_carlo_sample)
+  {
+    for (size_t i = 0; i < m; ++i)
+      samples[i] = math::RandInt(lo, hiExclusive);
+  }
+}
+
 //! Clean rules base case.
 template<typename TreeType>
 inline force_inline
@@ -0,0 +1,132 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| seeding strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+#include <random>
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids) const
+{
+  centroids.set_size(data.n_rows, clusters);
+  if (clusters == 0 || data.n_cols == 0)
+    return;
+
+  const arma::rowvec dataNorms = arma::sum(arma::square(data), 0);
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(DBL_MAX);
+  arma::Row<size_t> closest(data.n_cols);
+
+  // Start with one random point.
+  std::vector<size_t> candidates;
+  candidates.push_back(math::RandInt(0, data.n_cols));
+  KMeansPlusPlusInitialization::UpdateDistances(data, dataNorms,
+      arma::mat(data.col(candidates[0])), 0, minDistances, closest);
+
+  const double expected = oversampling * clusters;
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  for (size_t r = 0; r < rounds; ++r)
+  {
+    const double phi = arma::accu(minDistances);
+    if (phi <= 0.0)
+      break; // Every point is a candidate already.
+
+    // Each block of points gets its own generator, seeded from the mlpack
+    // generator, so the result doesn't depend on the number of threads.
+    const size_t seed = (size_t) math::RandInt(0, INT_MAX);
+    std::vector<size_t> sampled;
+    #pragma omp parallel
+    {
+      std::vector<size_t> localSampled;
+
+      #pragma omp for schedule(static)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        std::mt19937_64 generator(seed + b);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        const size_t begin = b * blockSize;
+        const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+        for (size_t i = begin; i < end; ++i)
+        {
+          if (uniform(generator) < expected * minDistances[i] / phi)
+            localSampled.push_back(i);
+        }
+      }
+
+      #pragma omp critical
+      {
+        sampled.insert(sampled.end(), localSampled.begin(),
+            localSampled.end());
+      }
+    }
+
+    if (sampled.empty())
+      continue;
+
+    std::sort(sampled.begin(), sampled.end());
+    arma::mat newCandidates(data.n_rows, sampled.size());
+    for (size_t i = 0; i < sampled.size(); ++i)
+      newCandidates.col(i) = arma::vec(data.col(sampled[i]));
+
+    KMeansPlusPlusInitialization::UpdateDistances(data, dataNorms,
+        newCandidates, candidates.size(), minDistances, closest);
+    candidates.insert(candidates.end(), sampled.begin(), sampled.end());
+  }
+
+  // Weight each candidate by the number of points that are closest to it.
+  arma::vec weights(candidates.size(), arma::fill::zeros);
+  #pragma omp parallel
+  {
+    arma::vec localWeights(candidates.size(), arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      localWeights[closest[i]] += 1.0;
+
+    #pragma omp critical
+    {
+      weights += localWeights;
+    }
+  }
+
+  arma::mat candidateMatrix(data.n_rows, candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i)
+    candidateMatrix.col(i) = arma::vec(data.col(candidates[i]));
+
+  if (candidates.size() <= clusters)
+  {
+    // There are too few candidates (e.g. because there are few distinct
+    // points), so use all of them and fill up with random points.
+    centroids.cols(0, candidates.size() - 1) = candidateMatrix;
+    for (size_t c = candidates.size(); c < clusters; ++c)
+      centroids.col(c) = arma::vec(data.col(math::RandInt(0, data.n_cols)));
+    return;
+  }
+
+  // Reduce the weighted candidates to the requested number of centroids.
+  KMeansPlusPlusInitialization::WeightedCluster(candidateMatrix, weights,
+      clusters, centroids);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
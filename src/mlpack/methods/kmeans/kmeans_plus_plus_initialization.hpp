@@ -0,0 +1,120 @@
+/**
+ * @file methods/kmeans/kmeans_plus_plus_initialization.hpp
+ *
+ * An implementation of the k-means++ seeding strategy, which picks each new
+ * initial centroid with probability proportional to the squared distance to
+ * the closest centroid picked so far.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means++ initialization strategy, described in the following paper:
+ *
+ * @code
+ * @inproceedings{arthur2007k,
+ *   title={k-means++: The advantages of careful seeding},
+ *   author={Arthur, D. and Vassilvitskii, S.},
+ *   booktitle={Proceedings of the Eighteenth Annual ACM-SIAM Symposium on
+ *       Discrete Algorithms (SODA '07)},
+ *   pages={1027--1035},
+ *   year={2007}
+ * }
+ * @endcode
+ *
+ * The first centroid is a random point; each next centroid is a point sampled
+ * with probability proportional to its squared Euclidean distance to the
+ * closest centroid chosen so far.  The distances of all points to each new
+ * centroid are computed in blocks with matrix products, split between the
+ * threads with OpenMP.  Picking k centroids takes O(nkd) time; for very large
+ * k and n, see KMeansParallelInitialization.
+ */
+class KMeansPlusPlusInitialization
+{
+ public:
+  //! Empty constructor, required by the InitialPartitionPolicy type definition.
+  KMeansPlusPlusInitialization() { }
+
+  /**
+   * Initialize the centroids matrix with the k-means++ strategy.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids) const;
+
+  /**
+   * Initialize the centroids matrix with the k-means++ strategy, where each
+   * point counts as many times as its weight: points are sampled with
+   * probability proportional to their weight times their squared distance.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset.
+   * @param weights Weight of each point.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  static void WeightedCluster(const MatType& data,
+                              const arma::vec& weights,
+                              const size_t clusters,
+                              arma::mat& centroids);
+
+  /**
+   * Update the squared distance of each point to its closest center with the
+   * given new centers, and store the index of the closest center.  The
+   * distances are computed as ||x||^2 + ||c||^2 - 2 x^T c, in blocks of points,
+   * so that the dot products are one matrix product per block.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset.
+   * @param dataNorms Squared norm of each point.
+   * @param centers New centers.
+   * @param offset Index of the first new center.
+   * @param minDistances Squared distance of each point to its closest center.
+   * @param closest Index of the closest center of each point.
+   */
+  template<typename MatType>
+  static void UpdateDistances(const MatType& data,
+                              const arma::rowvec& dataNorms,
+                              const arma::mat& centers,
+                              const size_t offset,
+                              arma::vec& minDistances,
+                              arma::Row<size_t>& closest);
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  //! Pick the centroids; if the weights are empty, every point counts once.
+  template<typename MatType>
+  static void Seed(const MatType& data,
+                   const arma::vec& weights,
+                   const size_t clusters,
+                   arma::mat& centroids);
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_plus_plus_initialization_impl.hpp"
+
+#endif
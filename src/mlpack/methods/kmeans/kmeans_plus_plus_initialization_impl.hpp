@@ -0,0 +1,137 @@
+/**
+ * @file methods/kmeans/kmeans_plus_plus_initialization_impl.hpp
+ *
+ * Implementation of the k-means++ seeding strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_plus_plus_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansPlusPlusInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids) const
+{
+  Seed(data, arma::vec(), clusters, centroids);
+}
+
+template<typename MatType>
+void KMeansPlusPlusInitialization::WeightedCluster(const MatType& data,
+                                                   const arma::vec& weights,
+                                                   const size_t clusters,
+                                                   arma::mat& centroids)
+{
+  if (weights.n_elem != data.n_cols)
+  {
+    throw std::invalid_argument("KMeansPlusPlusInitialization::"
+        "WeightedCluster(): there must be one weight for each point!");
+  }
+
+  Seed(data, weights, clusters, centroids);
+}
+
+template<typename MatType>
+void KMeansPlusPlusInitialization::UpdateDistances(
+    const MatType& data,
+    const arma::rowvec& dataNorms,
+    const arma::mat& centers,
+    const size_t offset,
+    arma::vec& minDistances,
+    arma::Row<size_t>& closest)
+{
+  const arma::rowvec centerNorms = arma::sum(arma::square(centers), 0);
+
+  // Each block is small enough that its distances stay in cache.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+
+    const arma::mat products = centers.t() * data.cols(begin, end - 1);
+    for (size_t i = begin; i < end; ++i)
+    {
+      for (size_t c = 0; c < centers.n_cols; ++c)
+      {
+        // Rounding can make the distance slightly negative.
+        const double distance = std::max(dataNorms[i] + centerNorms[c] -
+            2.0 * products(c, i - begin), 0.0);
+        if (distance < minDistances[i])
+        {
+          minDistances[i] = distance;
+          closest[i] = offset + c;
+        }
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void KMeansPlusPlusInitialization::Seed(const MatType& data,
+                                        const arma::vec& weights,
+                                        const size_t clusters,
+                                        arma::mat& centroids)
+{
+  centroids.set_size(data.n_rows, clusters);
+  if (clusters == 0 || data.n_cols == 0)
+    return;
+
+  const arma::rowvec dataNorms = arma::sum(arma::square(data), 0);
+  arma::vec minDistances(data.n_cols);
+  minDistances.fill(DBL_MAX);
+  arma::Row<size_t> closest(data.n_cols);
+
+  arma::vec probabilities(data.n_cols);
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    // The first centroid is sampled by weight only.
+    if (c == 0)
+      probabilities.ones();
+    else
+      probabilities = minDistances;
+
+    if (!weights.is_empty())
+      probabilities %= weights;
+
+    // If all of the points are already centroids, any point will do.
+    const double total = arma::accu(probabilities);
+    size_t index;
+    if (total > 0.0)
+    {
+      const double threshold = math::Random(0.0, total);
+      double sum = 0.0;
+      for (index = 0; index < data.n_cols - 1; ++index)
+      {
+        sum += probabilities[index];
+        if (sum > threshold)
+          break;
+      }
+    }
+    else
+    {
+      index = math::RandInt(0, data.n_cols);
+    }
+
+    centroids.col(c) = arma::vec(data.col(index));
+    UpdateDistances(data, dataNorms, centroids.cols(c, c), c, minDistances,
+        closest);
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
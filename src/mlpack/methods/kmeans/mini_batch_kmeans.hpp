@@ -0,0 +1,116 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans.hpp
+ *
+ * An implementation of a mini-batch step for k-means clustering, which
+ * updates the centroids after each small chunk of points with per-centroid
+ * learning rates, instead of once per pass over the whole dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This is an implementation of mini-batch k-means, as described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * Each call to Iterate() makes one pass over the dataset in chunks of
+ * BatchSize() consecutive points, in a random order of the chunks.  The points
+ * of a chunk are assigned to their closest centroids, and then each centroid
+ * moves towards the mean of its new points with a learning rate that is the
+ * inverse of the total number of points the centroid has been assigned so
+ * far.  So the centroids move a lot at first and then settle, and a few passes
+ * are usually enough.  Only one chunk of the dataset is touched at a time, so
+ * the dataset may be, e.g., a memory-mapped matrix (see data::MappedFile)
+ * that does not fit in memory.
+ *
+ * Unlike the other Lloyd step types, the result is an approximation of the
+ * k-means solution.  This class is used by KMeans as the implementation of
+ * each iteration; the learning rates are kept from one iteration to the next.
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  //! The default number of points in each chunk.
+  static const size_t DefaultBatchSize = 1024;
+
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points in each chunk.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = DefaultBatchSize);
+
+  /**
+   * Make one pass over the dataset in chunks, updating the given centroids into
+   * the newCentroids matrix after each chunk.  If any cluster received no
+   * points during the pass, its count is zero and its centroid is not moved
+   * (the empty cluster policy of KMeans may then change it).
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster during the pass.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  //! Get the number of distance calculations.
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the number of points in each chunk.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each chunk.
+  size_t& BatchSize() { return batchSize; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The number of points in each chunk.
+  size_t batchSize;
+
+  //! The total number of points assigned to each cluster so far; the learning
+  //! rate of each centroid is the inverse of its total.
+  arma::Col<size_t> totalCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
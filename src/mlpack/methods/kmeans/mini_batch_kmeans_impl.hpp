@@ -0,0 +1,133 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of the mini-batch step for k-means clustering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("MiniBatchKMeans: the batch size must be "
+        "positive!");
+  }
+}
+
+// Run a single pass over the dataset.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  if (totalCounts.n_elem != centroids.n_cols)
+    totalCounts.zeros(centroids.n_cols);
+
+  newCentroids = centroids;
+  counts.zeros(centroids.n_cols);
+
+  // Visit the chunks in a random order, so that the centroids don't follow any
+  // ordering of the dataset.
+  const size_t numBatches = (dataset.n_cols + batchSize - 1) / batchSize;
+  const arma::uvec order = arma::randperm(numBatches);
+
+  arma::mat batchSums(centroids.n_rows, centroids.n_cols);
+  arma::Col<size_t> batchCounts(centroids.n_cols);
+  for (size_t b = 0; b < numBatches; ++b)
+  {
+    const size_t begin = order[b] * batchSize;
+    const size_t end = std::min(begin + batchSize, (size_t) dataset.n_cols);
+
+    batchSums.zeros();
+    batchCounts.zeros();
+
+    // Assign each point of the chunk to the closest of the current centroids.
+    #pragma omp parallel
+    {
+      arma::mat localSums(centroids.n_rows, centroids.n_cols,
+          arma::fill::zeros);
+      arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+      #pragma omp for
+      for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+      {
+        double minDistance = std::numeric_limits<double>::infinity();
+        size_t closestCluster = centroids.n_cols; // Invalid value.
+
+        for (size_t j = 0; j < newCentroids.n_cols; ++j)
+        {
+          const double distance = metric.Evaluate(dataset.col(i),
+              newCentroids.unsafe_col(j));
+          if (distance < minDistance)
+          {
+            minDistance = distance;
+            closestCluster = j;
+          }
+        }
+
+        Log::Assert(closestCluster != centroids.n_cols);
+
+        localSums.unsafe_col(closestCluster) += dataset.col(i);
+        localCounts(closestCluster)++;
+      }
+
+      #pragma omp critical
+      {
+        batchSums += localSums;
+        batchCounts += localCounts;
+      }
+    }
+
+    // Move each centroid towards the mean of its new points.  With a learning
+    // rate of 1 / (total count) per point, the centroid stays the mean of all
+    // of the points it was ever assigned.
+    for (size_t j = 0; j < newCentroids.n_cols; ++j)
+    {
+      if (batchCounts[j] == 0)
+        continue;
+
+      totalCounts[j] += batchCounts[j];
+      newCentroids.col(j) += (batchSums.col(j) - batchCounts[j] *
+          newCentroids.col(j)) / totalCounts[j];
+    }
+
+    counts += batchCounts;
+    distanceCalculations += centroids.n_cols * (end - begin);
+  }
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
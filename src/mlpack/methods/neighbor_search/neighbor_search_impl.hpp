@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
@@ -484,9 +485,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
+      rules.ComputeNorms();
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
+      // Create the traverser.  Independent query subtrees are traversed in
+      // parallel if OpenMP is available.
+      tree::ParallelDualTreeTraverser<RuleType, DualTreeTraversalType>
+          traverser(rules);
 
       traverser.Traverse(*queryTree, *referenceTree);
 
@@ -643,9 +647,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
+  rules.ComputeNorms();
 
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
+  // Create the traverser.  Independent query subtrees are traversed in
+  // parallel if OpenMP is available.
+  tree::ParallelDualTreeTraverser<RuleType, DualTreeTraversalType>
+      traverser(rules);
   traverser.Traverse(queryTree, *referenceTree);
 
   scores += rules.Scores();
@@ -785,8 +792,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
+      // Create the traverser.  Independent query subtrees are traversed in
+      // parallel if OpenMP is available.
+      rules.ComputeNorms();
+      tree::ParallelDualTreeTraverser<RuleType, DualTreeTraversalType>
+          traverser(rules);
 
       if (tree::IsSpillTree<Tree>::value)
       {
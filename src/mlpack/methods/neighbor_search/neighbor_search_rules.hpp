@@ -14,12 +14,33 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 #include <queue>
+#include <memory>
 
 namespace mlpack {
 namespace neighbor {
 
+namespace meta /** Metaprogramming utilities. */ {
+
+//! Utility struct where Value is true if and only if the argument is the
+//! Euclidean or squared Euclidean distance.
+template<typename MetricType>
+struct IsEuclidean
+{
+  static const bool Value = false;
+};
+
+//! Specialization for IsEuclidean when the argument is LMetric<2>.
+template<bool TakeRoot>
+struct IsEuclidean<metric::LMetric<2, TakeRoot>>
+{
+  static const bool Value = true;
+};
+
+} // namespace meta
+
 /**
  * The NeighborSearchRules class is a template helper class used by
  * NeighborSearch class when performing distance-based neighbor searches.  For
@@ -27,6 +48,12 @@ namespace neighbor {
  * reference dataset which have the 'best' distance according to a given sorting
  * policy.
  *
+ * Copies of a NeighborSearchRules object share the same lists of candidate
+ * neighbors, but each copy holds its own traversal information and base case
+ * and score counts.  This allows each task of a tree::ParallelDualTreeTraverser
+ * to work with its own copy of the rules, so long as the tasks work on disjoint
+ * sets of query points.
+ *
  * @tparam SortPolicy The sort policy for distances.
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
@@ -73,6 +100,33 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Evaluate the base cases between every point in the query leaf and every
+   * point in the reference leaf.  Query points for which Score() says that the
+   * reference node can be pruned are skipped.  For the Euclidean distance on
+   * dense data, if ComputeNorms() has been called, all distances are computed
+   * at once as a matrix product, and only the reference points that may enter
+   * the list of candidates of a query point are evaluated exactly with the
+   * metric.
+   *
+   * @param queryNode Query leaf.
+   * @param referenceNode Reference leaf.
+   * @return Number of base cases that were evaluated with the metric.
+   */
+  size_t LeafBaseCase(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Cache the squared norms of the query and reference points, so that
+   * LeafBaseCase() can compute distances with a matrix product.  This only
+   * does something for the Euclidean distance on dense data, and is only
+   * useful for dual-tree traversals.  Call it before the rules are copied, so
+   * that the copies share the norms.
+   */
+  void ComputeNorms()
+  {
+    ComputeNorms(std::integral_constant<bool, BlockBaseCases>());
+  }
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -179,8 +233,9 @@ class NeighborSearchRules
   typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
       CandidateList;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidate neighbors for each point.  This is shared between
+  //! copies of the rules.
+  std::shared_ptr<std::vector<CandidateList>> candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -194,6 +249,25 @@ class NeighborSearchRules
   //! Relative error to be considered in approximate search.
   const double epsilon;
 
+  //! Convenience typedef.
+  typedef typename TreeType::ElemType ElemType;
+
+  //! If true, LeafBaseCase() computes the distances with a matrix product.
+  static const bool BlockBaseCases = meta::IsEuclidean<MetricType>::Value &&
+      std::is_same<typename TreeType::Mat, arma::Mat<ElemType>>::value;
+
+  //! LeafBaseCase() only uses a matrix product for at least this many
+  //! dimensions; for fewer, the metric is faster.
+  static const size_t BlockBaseCaseMinDimensions = 8;
+
+  //! The squared norm of each query point (only if ComputeNorms() was called
+  //! and BlockBaseCases is true).  This is shared between copies of the rules.
+  std::shared_ptr<arma::Col<ElemType>> queryNorms;
+  //! The squared norm of each reference point (only if ComputeNorms() was
+  //! called and BlockBaseCases is true).  This is shared between copies of the
+  //! rules.
+  std::shared_ptr<arma::Col<ElemType>> referenceNorms;
+
   //! The last query point BaseCase() was called with.
   size_t lastQueryIndex;
   //! The last reference point BaseCase() was called with.
@@ -225,6 +299,28 @@ class NeighborSearchRules
   void InsertNeighbor(const size_t queryIndex,
                       const size_t neighbor,
                       const double distance);
+
+  //! Compute the squared norms of the points, if BlockBaseCases is true.
+  void ComputeNorms(const std::true_type /* blockBaseCases */);
+  //! Nothing to compute when BlockBaseCases is false.
+  void ComputeNorms(const std::false_type /* blockBaseCases */) { }
+
+  /**
+   * Perform the base cases between the given query points and every point in
+   * the reference leaf with the metric.
+   */
+  void LeafBaseCase(const arma::uvec& queries,
+                    TreeType& referenceNode,
+                    const std::false_type /* blockBaseCases */);
+
+  /**
+   * Perform the base cases between the given query points and every point in
+   * the reference leaf; the distances are first computed with a matrix product
+   * from the cached norms.
+   */
+  void LeafBaseCase(const arma::uvec& queries,
+                    TreeType& referenceNode,
+                    const std::true_type /* blockBaseCases */);
 };
 
 } // namespace neighbor
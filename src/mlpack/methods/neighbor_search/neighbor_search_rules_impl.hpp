@@ -29,6 +29,7 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(new std::vector<CandidateList>()),
     k(k),
     metric(metric),
     sameSet(sameSet),
@@ -54,9 +55,9 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
   std::vector<Candidate> vect(k, def);
   CandidateList pqueue(CandidateCmp(), std::move(vect));
 
-  candidates.reserve(querySet.n_cols);
+  candidates->reserve(querySet.n_cols);
   for (size_t i = 0; i < querySet.n_cols; ++i)
-    candidates.push_back(pqueue);
+    candidates->push_back(pqueue);
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -69,7 +70,7 @@ void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
 
   for (size_t i = 0; i < querySet.n_cols; ++i)
   {
-    CandidateList& pqueue = candidates[i];
+    CandidateList& pqueue = (*candidates)[i];
     for (size_t j = 1; j <= k; ++j)
     {
       neighbors(k - j, i) = pqueue.top().second;
@@ -107,6 +108,130 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+size_t NeighborSearchRules<SortPolicy, MetricType, TreeType>::LeafBaseCase(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  // Find the query points that could be improved by the reference node.
+  arma::uvec queries(queryNode.NumPoints());
+  size_t numQueries = 0;
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+  {
+    const size_t queryIndex = queryNode.Point(i);
+    if (Score(queryIndex, referenceNode) != DBL_MAX)
+      queries[numQueries++] = queryIndex;
+  }
+
+  if (numQueries == 0)
+    return 0;
+
+  queries.resize(numQueries);
+  const size_t oldBaseCases = baseCases;
+  LeafBaseCase(queries, referenceNode,
+      std::integral_constant<bool, BlockBaseCases>());
+
+  return baseCases - oldBaseCases;
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::LeafBaseCase(
+    const arma::uvec& queries,
+    TreeType& referenceNode,
+    const std::false_type /* blockBaseCases */)
+{
+  for (size_t i = 0; i < queries.n_elem; ++i)
+    for (size_t j = 0; j < referenceNode.NumPoints(); ++j)
+      BaseCase(queries[i], referenceNode.Point(j));
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::LeafBaseCase(
+    const arma::uvec& queries,
+    TreeType& referenceNode,
+    const std::true_type /* blockBaseCases */)
+{
+  // The norms are not computed if the data is low-dimensional.
+  if (!referenceNorms)
+  {
+    LeafBaseCase(queries, referenceNode, std::false_type());
+    return;
+  }
+
+  const size_t numReferences = referenceNode.NumPoints();
+  arma::uvec references(numReferences);
+  for (size_t j = 0; j < numReferences; ++j)
+    references[j] = referenceNode.Point(j);
+
+  // Compute all squared distances as ||r||^2 + ||q||^2 - 2 r^T q.  Column i
+  // holds the distances from query point queries[i].
+  arma::Mat<ElemType> distances = -2 * referenceSet.cols(references).t() *
+      querySet.cols(queries);
+  distances.each_col() += arma::Col<ElemType>(referenceNorms->elem(references));
+  distances.each_row() += arma::Row<ElemType>(queryNorms->elem(queries).t());
+
+  // The expansion above loses precision when the distance is small compared to
+  // the norms.  This bounds the absolute error of each squared distance
+  // (relative to the sum of the squared norms).
+  const ElemType relativeError = 4 * (querySet.n_rows + 2) *
+      std::numeric_limits<ElemType>::epsilon();
+
+  for (size_t i = 0; i < queries.n_elem; ++i)
+  {
+    const size_t queryIndex = queries[i];
+    const CandidateList& pqueue = (*candidates)[queryIndex];
+    for (size_t j = 0; j < numReferences; ++j)
+    {
+      const size_t referenceIndex = references[j];
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      // Find the range the true distance lies in, and skip the point if it
+      // cannot enter the list of candidates anywhere in that range.
+      const ElemType error = relativeError * ((*queryNorms)[queryIndex] +
+          (*referenceNorms)[referenceIndex]);
+      double lower = std::max(distances(j, i) - error, (ElemType) 0);
+      double upper = distances(j, i) + error;
+      if (MetricType::TakeRoot)
+      {
+        lower = std::sqrt(lower);
+        upper = std::sqrt(upper);
+      }
+
+      const Candidate& worst = pqueue.top();
+      if (!CandidateCmp()(std::make_pair(lower, referenceIndex), worst) &&
+          !CandidateCmp()(std::make_pair(upper, referenceIndex), worst))
+        continue;
+
+      // The point may be a neighbor, so compute the exact distance.
+      const double distance = metric.Evaluate(querySet.col(queryIndex),
+          referenceSet.col(referenceIndex));
+      ++baseCases;
+      InsertNeighbor(queryIndex, referenceIndex, distance);
+    }
+  }
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::ComputeNorms(
+    const std::true_type /* blockBaseCases */)
+{
+  if (referenceSet.n_rows < BlockBaseCaseMinDimensions)
+    return;
+
+  referenceNorms = std::make_shared<arma::Col<ElemType>>(
+      arma::trans(arma::sum(arma::square(referenceSet), 0)));
+  if (&querySet == &referenceSet)
+  {
+    queryNorms = referenceNorms;
+  }
+  else
+  {
+    queryNorms = std::make_shared<arma::Col<ElemType>>(
+        arma::trans(arma::sum(arma::square(querySet), 0)));
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -143,7 +268,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   }
 
   // Compare against the best k'th distance for this query point so far.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = (*candidates)[queryIndex].top().first;
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ?
@@ -179,7 +304,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   const double distance = SortPolicy::ConvertToDistance(oldScore);
 
   // Just check the score again against the distances.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = (*candidates)[queryIndex].top().first;
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
@@ -404,7 +529,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // Loop over points held in the node.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double distance = candidates[queryNode.Point(i)].top().first;
+    const double distance = (*candidates)[queryNode.Point(i)].top().first;
     if (SortPolicy::IsBetter(worstDistance, distance))
       worstDistance = distance;
     if (SortPolicy::IsBetter(distance, bestPointDistance))
@@ -499,7 +624,7 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
+  CandidateList& pqueue = (*candidates)[queryIndex];
   Candidate c = std::make_pair(distance, neighbor);
 
   if (CandidateCmp()(c, pqueue.top()))
@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  *
  * Implementation of the Bootstrap() function, which creates a bootstrapped
- * dataset from the given input dataset.
+ * dataset from the given input dataset, and of the BootstrapSamples()
+ * function, which only draws the indices of the sample.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -47,6 +48,28 @@ void Bootstrap(const MatType& dataset,
   }
 }
 
+/**
+ * Draw the indices of a bootstrap sample of a dataset with the given number of
+ * points.  The sample has as many points as the dataset, drawn with
+ * replacement; this is the sample that Bootstrap() copies.
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param samples Vector to store the indices of the sampled points in.
+ */
+inline void BootstrapSamples(const size_t numPoints,
+                             arma::Col<size_t>& samples)
+{
+  samples.set_size(numPoints);
+  if (numPoints == 0)
+    return;
+
+  // Random sampling with replacement.
+  arma::uvec indices = arma::randi<arma::uvec>(numPoints,
+      arma::distr_param(0, numPoints - 1));
+  for (size_t i = 0; i < numPoints; ++i)
+    samples[i] = indices[i];
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,188 @@
+/**
+ * @file methods/random_forest/compiled_forest.hpp
+ *
+ * Definition of the CompiledForest class, a flat copy of trained decision
+ * trees or random forests for fast batch classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_COMPILED_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_COMPILED_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "random_forest.hpp"
+
+#include <cstdint>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A CompiledForest holds trained decision trees in a layout built for
+ * classifying many points quickly.  The nodes of all the trees are stored in
+ * one array, each tree in breadth-first order, so that the children of a node
+ * are next to each other.  Each node is packed into 16 bytes: its split
+ * dimension, its split threshold, and the index of its first child.  The class
+ * probabilities of the leaves are stored in a separate matrix.
+ *
+ * Points are classified in blocks: every point of a block goes through one
+ * tree before the next tree is used, so that the nodes of the tree stay in the
+ * cache, and blocks are classified in parallel when OpenMP is available.  A
+ * numeric split picks the child with a comparison instead of a branch.
+ *
+ * The predictions and probabilities are the same as those of the compiled
+ * DecisionTree or RandomForest.  The forest is a copy: changing the original
+ * trees afterwards does not change it.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 500);
+ * CompiledForest compiled(rf);
+ * compiled.Classify(testData, predictions, probabilities);
+ * @endcode
+ *
+ * Only trees whose numeric split type splits on a threshold (see
+ * NumericSplitTraits) and whose categorical split type is AllCategoricalSplit
+ * can be compiled.
+ */
+class CompiledForest
+{
+ public:
+  //! The number of points classified together.
+  static const size_t BlockSize = 64;
+
+  /**
+   * Create an empty compiled forest.  Add trees with AddTree().
+   */
+  CompiledForest() : numClasses(0) { }
+
+  /**
+   * Compile the trees of the given random forest.
+   *
+   * @param forest Trained random forest to compile.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename ElemType>
+  explicit CompiledForest(const RandomForest<FitnessFunction,
+                                             DimensionSelectionType,
+                                             NumericSplitType,
+                                             CategoricalSplitType,
+                                             ElemType>& forest);
+
+  /**
+   * Compile the given decision tree.
+   *
+   * @param tree Trained decision tree to compile.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           typename ElemType,
+           bool NoRecursion>
+  explicit CompiledForest(const DecisionTree<FitnessFunction,
+                                             NumericSplitType,
+                                             CategoricalSplitType,
+                                             DimensionSelectionType,
+                                             ElemType,
+                                             NoRecursion>& tree);
+
+  /**
+   * Compile a decision tree and add it to the forest.  The tree must have the
+   * same number of classes as the trees already in the forest.
+   *
+   * @param tree Trained decision tree to add.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           typename ElemType,
+           bool NoRecursion>
+  void AddTree(const DecisionTree<FitnessFunction,
+                                  NumericSplitType,
+                                  CategoricalSplitType,
+                                  DimensionSelectionType,
+                                  ElemType,
+                                  NoRecursion>& tree);
+
+  /**
+   * Predict the classes of each point in the given dataset.  If no trees have
+   * been compiled, this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * class probabilities for each point, averaged over the trees.  If no trees
+   * have been compiled, this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+  //! Get the total number of nodes of all the trees.
+  size_t NumNodes() const { return nodes.size(); }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+ private:
+  //! A compiled tree node.
+  struct Node
+  {
+    //! The split value, if this is a numeric split.
+    double threshold;
+    //! The split dimension, with CategoricalFlag set for a categorical split;
+    //! LeafDimension if this is a leaf.
+    uint32_t dimension;
+    //! The index of the first child, or the column of the class probabilities
+    //! in leafProbabilities if this is a leaf.
+    uint32_t child;
+  };
+
+  //! The dimension of a leaf.
+  static const uint32_t LeafDimension = 0xFFFFFFFF;
+  //! The bit of the dimension that marks a categorical split.
+  static const uint32_t CategoricalFlag = 0x80000000;
+
+  /**
+   * Return the column in leafProbabilities of the leaf that the given point
+   * falls into in the tree with the given root.
+   */
+  template<typename ElemType>
+  size_t Leaf(const size_t root, const ElemType* point) const;
+
+  //! The nodes of all the trees.
+  std::vector<Node> nodes;
+  //! The index of the root of each tree.
+  std::vector<size_t> roots;
+  //! The class probabilities of each leaf, one column per leaf.
+  arma::mat leafProbabilities;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "compiled_forest_impl.hpp"
+
+#endif
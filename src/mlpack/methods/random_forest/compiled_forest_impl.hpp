@@ -0,0 +1,235 @@
+/**
+ * @file methods/random_forest/compiled_forest_impl.hpp
+ *
+ * Implementation of the CompiledForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_COMPILED_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_COMPILED_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "compiled_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+CompiledForest::CompiledForest(const RandomForest<FitnessFunction,
+                                                  DimensionSelectionType,
+                                                  NumericSplitType,
+                                                  CategoricalSplitType,
+                                                  ElemType>& forest) :
+    numClasses(0)
+{
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+CompiledForest::CompiledForest(const DecisionTree<FitnessFunction,
+                                                  NumericSplitType,
+                                                  CategoricalSplitType,
+                                                  DimensionSelectionType,
+                                                  ElemType,
+                                                  NoRecursion>& tree) :
+    numClasses(0)
+{
+  AddTree(tree);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+void CompiledForest::AddTree(const DecisionTree<FitnessFunction,
+                                                NumericSplitType,
+                                                CategoricalSplitType,
+                                                DimensionSelectionType,
+                                                ElemType,
+                                                NoRecursion>& tree)
+{
+  typedef DecisionTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+      DimensionSelectionType, ElemType, NoRecursion> TreeType;
+
+  static_assert(NumericSplitTraits<
+      NumericSplitType<FitnessFunction>>::SplitsOnThreshold,
+      "CompiledForest: only trees whose numeric split type splits on a "
+      "threshold can be compiled.");
+  static_assert(std::is_same<CategoricalSplitType<FitnessFunction>,
+      AllCategoricalSplit<FitnessFunction>>::value,
+      "CompiledForest: only trees that use AllCategoricalSplit can be "
+      "compiled.");
+
+  const size_t treeClasses = tree.NumClasses();
+  if (roots.empty())
+  {
+    numClasses = treeClasses;
+  }
+  else if (treeClasses != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "CompiledForest::AddTree(): tree has " << treeClasses << " classes, "
+        << "but the forest has " << numClasses << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // List the nodes in breadth-first order.  The children of each node are
+  // then contiguous, and come after the children of the nodes before it.
+  std::vector<const TreeType*> queue(1, &tree);
+  size_t numLeaves = 0;
+  for (size_t i = 0; i < queue.size(); ++i)
+  {
+    const std::vector<TreeType*>& children = queue[i]->children;
+    if (children.empty())
+      ++numLeaves;
+    for (size_t j = 0; j < children.size(); ++j)
+      queue.push_back(children[j]);
+  }
+
+  const size_t root = nodes.size();
+  const size_t firstLeaf = leafProbabilities.n_cols;
+  if (root + queue.size() > LeafDimension ||
+      firstLeaf + numLeaves > LeafDimension)
+  {
+    throw std::invalid_argument("CompiledForest::AddTree(): too many nodes to "
+        "compile!");
+  }
+
+  nodes.reserve(root + queue.size());
+  leafProbabilities.resize(numClasses, firstLeaf + numLeaves);
+  size_t nextChild = root + 1;
+  size_t leaf = firstLeaf;
+  for (size_t i = 0; i < queue.size(); ++i)
+  {
+    const TreeType& treeNode = *queue[i];
+    Node node;
+    node.threshold = 0.0;
+    if (treeNode.children.empty())
+    {
+      node.dimension = LeafDimension;
+      node.child = (uint32_t) leaf;
+      leafProbabilities.col(leaf++) = treeNode.classProbabilities;
+    }
+    else
+    {
+      if (treeNode.splitDimension >= CategoricalFlag)
+      {
+        throw std::invalid_argument("CompiledForest::AddTree(): split "
+            "dimension too large to compile!");
+      }
+
+      node.dimension = (uint32_t) treeNode.splitDimension;
+      if ((data::Datatype) treeNode.dimensionTypeOrMajorityClass ==
+          data::Datatype::categorical)
+        node.dimension |= CategoricalFlag;
+      else
+        node.threshold = treeNode.classProbabilities[0];
+
+      node.child = (uint32_t) nextChild;
+      nextChild += treeNode.children.size();
+    }
+
+    nodes.push_back(node);
+  }
+
+  roots.push_back(root);
+}
+
+template<typename MatType>
+void CompiledForest::Classify(const MatType& data,
+                              arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void CompiledForest::Classify(const MatType& data,
+                              arma::Row<size_t>& predictions,
+                              arma::mat& probabilities) const
+{
+  // Check edge case.
+  if (roots.empty())
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("CompiledForest::Classify(): no trees "
+        "compiled!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(numClasses, data.n_cols);
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+
+    // Send every point of the block through a tree before using the next
+    // tree.  The probabilities of each point are still summed in the order of
+    // the trees, like RandomForest::Classify() does.
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const double* leaf = leafProbabilities.colptr(Leaf(roots[t],
+            data.colptr(i)));
+        double* sums = probabilities.colptr(i);
+        for (size_t c = 0; c < numClasses; ++c)
+          sums[c] += leaf[c];
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      probabilities.col(i) /= roots.size();
+      predictions[i] = (size_t) arma::index_max(probabilities.col(i));
+    }
+  }
+}
+
+template<typename ElemType>
+size_t CompiledForest::Leaf(const size_t root, const ElemType* point) const
+{
+  const Node* node = &nodes[root];
+  while (node->dimension != LeafDimension)
+  {
+    if (node->dimension & CategoricalFlag)
+    {
+      node = &nodes[node->child +
+          (size_t) point[node->dimension & ~CategoricalFlag]];
+    }
+    else
+    {
+      // Points with a value above the threshold (or NaN) go to the right,
+      // like with the numeric split types.
+      node = &nodes[node->child +
+          !(point[node->dimension] <= node->threshold)];
+    }
+  }
+
+  return node->child;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -467,48 +467,33 @@ double RandomForest<
   trees.resize(numTrees); // This will fill the vector with untrained trees.
   double avgGain = 0.0;
 
+  // Without dataset information, every dimension is numeric.
+  const data::DatasetInfo numericInfo(UseDatasetInfo ? 0 : dataset.n_rows);
+  const data::DatasetInfo& info = UseDatasetInfo ? datasetInfo : numericInfo;
+
+  // If the numeric split works on histograms, quantize the dataset once here;
+  // every tree then reads the same bins.
+  arma::Mat<unsigned char> binnedData;
+  std::vector<arma::vec> binBoundaries;
+  DecisionTreeType::QuantizeData(dataset, info, binnedData, binBoundaries);
+
   #pragma omp parallel for reduction( + : avgGain)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
+    // Each tree trains on the shared dataset through the indices of its
+    // bootstrap sample, so the dataset is never copied.
     Timer::Start("bootstrap");
-    MatType bootstrapDataset;
-    arma::Row<size_t> bootstrapLabels;
-    arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
+    arma::Col<size_t> samples;
+    BootstrapSamples(dataset.n_cols, samples);
     Timer::Stop("bootstrap");
 
     // Now build the decision tree.
     Timer::Start("train_tree");
-    if (UseWeights)
-    {
-      if (UseDatasetInfo)
-      {
-        avgGain += trees[i].Train(bootstrapDataset, datasetInfo,
-            bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize,
-            minimumGainSplit, maximumDepth, dimensionSelector);
-      }
-      else
-      {
-        avgGain += trees[i].Train(bootstrapDataset, bootstrapLabels, numClasses,
-            bootstrapWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
-            dimensionSelector);
-      }
-    }
-    else
-    {
-      if (UseDatasetInfo)
-      {
-        avgGain += trees[i].Train(bootstrapDataset, datasetInfo,
-            bootstrapLabels, numClasses, minimumLeafSize, minimumGainSplit,
-            maximumDepth, dimensionSelector);
-      }
-      else
-      {
-        avgGain += trees[i].Train(bootstrapDataset, bootstrapLabels, numClasses,
-            minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
-      }
-    }
+    DimensionSelectionType treeDimensionSelector(dimensionSelector);
+    treeDimensionSelector.Dimensions() = dataset.n_rows;
+    avgGain += trees[i].template Train<UseWeights>(dataset, std::move(samples),
+        binnedData, binBoundaries, info, labels, numClasses, weights,
+        minimumLeafSize, minimumGainSplit, maximumDepth, treeDimensionSelector);
     Timer::Stop("train_tree");
   }
   return avgGain / numTrees;
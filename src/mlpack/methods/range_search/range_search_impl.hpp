@@ -17,6 +17,7 @@
 
 // The rules for traversal.
 #include "range_search_rules.hpp"
+#include <mlpack/core/tree/parallel_dual_tree_traverser.hpp>
 
 namespace mlpack {
 namespace range {
@@ -333,26 +334,45 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
         metric);
 
-    // The naive brute-force solution.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    // The naive brute-force solution.  Each thread works on its own query
+    // points with its own copy of the rules.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          threadRules.BaseCase(i, j);
+    }
 
     baseCases += (querySet.n_cols * referenceSet->n_cols);
   }
   else if (singleMode)
   {
-    // Create the traverser.
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
         metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Now traverse for each point.  The query points are split between
+    // threads, each with its own copy of the rules and its own traverser.
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
 
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+      #pragma omp for schedule(dynamic, 64)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += threadRules.BaseCases();
+      threadScores += threadRules.Scores();
+    }
+
+    baseCases += threadBaseCases;
+    scores += threadScores;
   }
   else // Dual-tree recursion.
   {
@@ -363,10 +383,12 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     Timer::Stop("range_search/tree_building");
     Timer::Start("range_search/computing_neighbors");
 
-    // Create the traverser.
+    // Create the traverser.  Independent query subtrees are traversed in
+    // parallel if OpenMP is available.
     RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
         *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    tree::ParallelDualTreeTraverser<RuleType,
+        Tree::template DualTreeTraverser> traverser(rules);
 
     traverser.Traverse(*queryTree, *referenceTree);
 
@@ -488,8 +510,10 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
       distances, metric);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  // Create the traverser.  Independent query subtrees are traversed in
+  // parallel if OpenMP is available.
+  tree::ParallelDualTreeTraverser<RuleType, Tree::template DualTreeTraverser>
+      traverser(rules);
 
   traverser.Traverse(*queryTree, *referenceTree);
 
@@ -557,30 +581,50 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   if (naive)
   {
-    // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    // The naive brute-force solution.  Each thread works on its own query
+    // points with its own copy of the rules.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          threadRules.BaseCase(i, j);
+    }
 
     baseCases = (referenceSet->n_cols * referenceSet->n_cols);
     scores = 0;
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    // Now traverse for each point.  The query points are split between
+    // threads, each with its own copy of the rules and its own traverser.
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+      #pragma omp for schedule(dynamic, 64)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
 
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+      threadBaseCases += threadRules.BaseCases();
+      threadScores += threadRules.Scores();
+    }
+
+    baseCases = threadBaseCases;
+    scores = threadScores;
   }
   else // Dual-tree recursion.
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    // Create the traverser.  Independent query subtrees are traversed in
+    // parallel if OpenMP is available.
+    tree::ParallelDualTreeTraverser<RuleType,
+        Tree::template DualTreeTraverser> traverser(rules);
 
     traverser.Traverse(*referenceTree, *referenceTree);
 
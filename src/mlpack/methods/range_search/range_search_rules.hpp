@@ -21,6 +21,12 @@ namespace range {
  * The RangeSearchRules class is a template helper class used by RangeSearch
  * class when performing range searches.
  *
+ * Copies of a RangeSearchRules object share the vectors the results are stored
+ * in, but each copy holds its own traversal information and base case and
+ * score counts.  So, several copies (for instance, the tasks of a
+ * tree::ParallelDualTreeTraverser) may be used at the same time, so long as
+ * they work on disjoint sets of query points.
+ *
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
  */
@@ -114,8 +120,12 @@ class RangeSearchRules
 
   //! Get the number of base cases.
   size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
   //! Get the number of scores (that is, calls to RangeDistance()).
   size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
 
  private:
   //! The reference set.
@@ -4387,3 +4387,122 @@ TEST_CASE("BatchNormDeterministicTest", "[ANNLayerTest]")
   // The model should switch to training mode for predicting.
   REQUIRE(boost::get<BatchNorm<>*>(module.Model()[0])->Deterministic() == 0);
 }
+
+/**
+ * Make sure that the common layers give the same results with arma::fmat as
+ * with arma::mat.
+ */
+TEST_CASE("SinglePrecisionLayerTest", "[ANNLayerTest]")
+{
+  arma::mat input(4 * 4 * 2, 3, arma::fill::randu);
+  arma::fmat floatInput = arma::conv_to<arma::fmat>::from(input);
+  arma::mat output, delta, gradient;
+  arma::fmat floatOutput, floatDelta, floatGradient;
+
+  // Linear layer.
+  Linear<> linear(32, 5);
+  linear.Parameters().randu();
+  linear.Reset();
+  Linear<arma::fmat, arma::fmat> floatLinear(32, 5);
+  floatLinear.Parameters() =
+      arma::conv_to<arma::fmat>::from(linear.Parameters());
+  floatLinear.Reset();
+
+  linear.Forward(input, output);
+  floatLinear.Forward(floatInput, floatOutput);
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(floatOutput), 1e-3);
+
+  linear.Backward(output, output, delta);
+  floatLinear.Backward(floatOutput, floatOutput, floatDelta);
+  CheckMatrices(delta, arma::conv_to<arma::mat>::from(floatDelta), 1e-3);
+
+  gradient.set_size(linear.Parameters().n_elem, 1);
+  floatGradient.set_size(floatLinear.Parameters().n_elem, 1);
+  linear.Gradient(input, output, gradient);
+  floatLinear.Gradient(floatInput, floatOutput, floatGradient);
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(floatGradient),
+      1e-3);
+
+  // Batch normalization layer.
+  BatchNorm<> batchNorm(32);
+  batchNorm.Reset();
+  BatchNorm<arma::fmat, arma::fmat> floatBatchNorm(32);
+  floatBatchNorm.Reset();
+
+  batchNorm.Forward(input, output);
+  floatBatchNorm.Forward(floatInput, floatOutput);
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(floatOutput), 1e-2);
+
+  batchNorm.Backward(input, output, delta);
+  floatBatchNorm.Backward(floatInput, floatOutput, floatDelta);
+  CheckMatrices(delta, arma::conv_to<arma::mat>::from(floatDelta), 1e-2);
+
+  // Convolution layer with padding.
+  Convolution<> convolution(2, 3, 3, 3, 1, 1, 1, 1, 4, 4);
+  convolution.Parameters().randu();
+  convolution.Reset();
+  Convolution<Im2ColConvolution<ValidConvolution>,
+              Im2ColConvolution<FullConvolution>,
+              Im2ColConvolution<ValidConvolution>,
+              arma::fmat, arma::fmat> floatConvolution(2, 3, 3, 3, 1, 1, 1, 1,
+      4, 4);
+  floatConvolution.Parameters() =
+      arma::conv_to<arma::fmat>::from(convolution.Parameters());
+  floatConvolution.Reset();
+
+  convolution.Forward(input, output);
+  floatConvolution.Forward(floatInput, floatOutput);
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(floatOutput), 1e-3);
+
+  convolution.Backward(input, output, delta);
+  floatConvolution.Backward(floatInput, floatOutput, floatDelta);
+  CheckMatrices(delta, arma::conv_to<arma::mat>::from(floatDelta), 1e-3);
+
+  convolution.Gradient(input, output, gradient);
+  floatConvolution.Gradient(floatInput, floatOutput, floatGradient);
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(floatGradient),
+      1e-3);
+}
+
+/**
+ * Make sure that a network built from the naive convolution layers gives the
+ * same results as one built from the default (im2col) convolution layers.
+ */
+TEST_CASE("NaiveConvolutionNetworkTest", "[ANNLayerTest]")
+{
+  typedef Convolution<NaiveConvolution<ValidConvolution>,
+                      NaiveConvolution<FullConvolution>,
+                      NaiveConvolution<ValidConvolution>> NaiveConvType;
+  typedef TransposedConvolution<NaiveConvolution<ValidConvolution>,
+                                NaiveConvolution<ValidConvolution>,
+                                NaiveConvolution<ValidConvolution>>
+      NaiveTransposedConvType;
+
+  arma::mat input = arma::randu(2 * 6 * 6, 3);
+  arma::mat responses = arma::randu(2 * 6 * 6, 3);
+
+  FFN<MeanSquaredError<>, ConstInitialization> naiveModel(
+      MeanSquaredError<>(), ConstInitialization(0.1));
+  naiveModel.Add<NaiveConvType>(2, 3, 3, 3, 1, 1, 1, 1, 6, 6);
+  naiveModel.Add<NaiveTransposedConvType>(3, 2, 3, 3, 1, 1, 1, 1, 6, 6, 6,
+      6);
+
+  FFN<MeanSquaredError<>, ConstInitialization> model(
+      MeanSquaredError<>(), ConstInitialization(0.1));
+  model.Add<Convolution<>>(2, 3, 3, 3, 1, 1, 1, 1, 6, 6);
+  model.Add<TransposedConvolution<>>(3, 2, 3, 3, 1, 1, 1, 1, 6, 6, 6, 6);
+
+  arma::mat naiveOutput, output;
+  naiveModel.Predict(input, naiveOutput);
+  model.Predict(input, output);
+  CheckMatrices(naiveOutput, output, 1e-5);
+
+  arma::mat naiveGradient, gradient;
+  naiveModel.Forward(input, naiveOutput);
+  const double naiveLoss = naiveModel.Backward(input, responses,
+      naiveGradient);
+  model.Forward(input, output);
+  const double loss = model.Backward(input, responses, gradient);
+  REQUIRE(naiveLoss == Approx(loss).epsilon(1e-5));
+  CheckMatrices(naiveGradient, gradient, 1e-5);
+}
@@ -16,6 +16,8 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/batch_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include "serialization_catch.hpp"
 #include "catch.hpp"
@@ -148,6 +150,10 @@ TEST_CASE("ValidConvolution2DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution as a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -185,6 +191,10 @@ TEST_CASE("FullConvolution2DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution as a matrix product.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -230,6 +240,10 @@ TEST_CASE("ValidConvolution3DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution as a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -279,6 +293,10 @@ TEST_CASE("FullConvolution3DTest", "[ConvolutionTest]")
   // speed up the computation.
   Convolution3DMethodTest<SVDConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
+
+  // Perform the convolution as a matrix product.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
 }
 
 /**
@@ -321,6 +339,10 @@ TEST_CASE("ValidConvolutionBatchTest", "[ConvolutionTest]")
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution as a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
 }
 
 /**
@@ -367,4 +389,72 @@ TEST_CASE("FullConvolutionBatchTest", "[ConvolutionTest]")
   // speed up the computation.
   ConvolutionMethodBatchTest<SVDConvolution<FullConvolution> >(input,
       filterCube, outputCube);
+
+  // Perform the convolution as a matrix product.
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+}
+
+/**
+ * Make sure that the convolutions of a whole batch of multi-channel inputs
+ * computed as a single matrix product match the naive convolutions.
+ */
+template<typename BorderMode>
+void BatchConvolutionTest(const size_t strideWidth,
+                          const size_t strideHeight,
+                          const size_t dilationWidth,
+                          const size_t dilationHeight)
+{
+  const size_t inMaps = 3;
+  const size_t outMaps = 4;
+  const size_t batchSize = 5;
+
+  arma::cube input(11, 11, inMaps * batchSize, arma::fill::randu);
+  arma::cube filter(3, 3, inMaps * outMaps, arma::fill::randu);
+
+  arma::cube naiveOutput, im2colOutput;
+  BatchConvolution<NaiveConvolution<BorderMode> >::Convolution(input, filter,
+      naiveOutput, inMaps, strideWidth, strideHeight, dilationWidth,
+      dilationHeight);
+  BatchConvolution<Im2ColConvolution<BorderMode> >::Convolution(input, filter,
+      im2colOutput, inMaps, strideWidth, strideHeight, dilationWidth,
+      dilationHeight);
+
+  REQUIRE(naiveOutput.n_rows == im2colOutput.n_rows);
+  REQUIRE(naiveOutput.n_cols == im2colOutput.n_cols);
+  REQUIRE(naiveOutput.n_slices == im2colOutput.n_slices);
+  CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+
+  // The errors have the size of the output of a valid convolution.
+  arma::cube error(3, 3, outMaps * batchSize, arma::fill::randu);
+  BatchConvolution<NaiveConvolution<BorderMode> >::GradientConvolution(input,
+      error, naiveOutput, inMaps, strideWidth, strideHeight);
+  BatchConvolution<Im2ColConvolution<BorderMode> >::GradientConvolution(input,
+      error, im2colOutput, inMaps, strideWidth, strideHeight);
+
+  REQUIRE(naiveOutput.n_rows == im2colOutput.n_rows);
+  REQUIRE(naiveOutput.n_cols == im2colOutput.n_cols);
+  REQUIRE(naiveOutput.n_slices == im2colOutput.n_slices);
+  CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+}
+
+/**
+ * Test the valid convolution of a batch of multi-channel inputs.
+ */
+TEST_CASE("ValidBatchConvolutionTest", "[ConvolutionTest]")
+{
+  BatchConvolutionTest<ValidConvolution>(1, 1, 1, 1);
+  BatchConvolutionTest<ValidConvolution>(2, 2, 1, 1);
+  BatchConvolutionTest<ValidConvolution>(1, 1, 2, 2);
+  BatchConvolutionTest<ValidConvolution>(2, 2, 2, 2);
+}
+
+/**
+ * Test the full convolution of a batch of multi-channel inputs.
+ */
+TEST_CASE("FullBatchConvolutionTest", "[ConvolutionTest]")
+{
+  BatchConvolutionTest<FullConvolution>(1, 1, 1, 1);
+  BatchConvolutionTest<FullConvolution>(2, 2, 1, 1);
+  BatchConvolutionTest<FullConvolution>(1, 1, 2, 2);
 }
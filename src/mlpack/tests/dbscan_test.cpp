@@ -309,4 +309,51 @@ BOOST_AUTO_TEST_CASE(RandomPointSelectionTest)
   BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
 }
 
+/**
+ * Make sure that grid-based range search gives the same clustering as
+ * tree-based range search, in two and three dimensions.
+ */
+BOOST_AUTO_TEST_CASE(GridRangeSearchTest)
+{
+  for (size_t dims = 2; dims <= 3; ++dims)
+  {
+    arma::mat points(dims, 2000, arma::fill::randu);
+    points.cols(1000, 1999) += 3.0;
+
+    DBSCAN<> d(0.05, 5);
+    DBSCAN<GridRangeSearch> gridD(0.05, 5);
+
+    arma::Row<size_t> assignments, gridAssignments;
+    const size_t clusters = d.Cluster(points, assignments);
+    const size_t gridClusters = gridD.Cluster(points, gridAssignments);
+
+    BOOST_REQUIRE_GT(clusters, 0);
+    BOOST_REQUIRE_EQUAL(clusters, gridClusters);
+    BOOST_REQUIRE_EQUAL(gridAssignments.n_elem, points.n_cols);
+    for (size_t i = 0; i < assignments.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(assignments[i], gridAssignments[i]);
+  }
+}
+
+/**
+ * Make sure that searching the points in blocks gives the same clustering as
+ * searching them in batch, when there are several blocks.
+ */
+BOOST_AUTO_TEST_CASE(BlockSearchMatchesBatchTest)
+{
+  arma::mat points(2, 25000, arma::fill::randu);
+
+  DBSCAN<> d(0.005, 4);
+  DBSCAN<> blockD(0.005, 4, false);
+
+  arma::Row<size_t> assignments, blockAssignments;
+  const size_t clusters = d.Cluster(points, assignments);
+  const size_t blockClusters = blockD.Cluster(points, blockAssignments);
+
+  BOOST_REQUIRE_EQUAL(clusters, blockClusters);
+  BOOST_REQUIRE_EQUAL(blockAssignments.n_elem, points.n_cols);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], blockAssignments[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -13,6 +13,7 @@
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/information_gain.hpp>
 #include <mlpack/methods/decision_tree/gini_gain.hpp>
+#include <mlpack/methods/decision_tree/histogram_numeric_split.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
 
@@ -376,6 +377,79 @@ TEST_CASE("BestBinaryNumericSplitNoGainTest", "[DecisionTreeTest]")
   REQUIRE(classProbabilities.n_elem == 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit will split on an obviously splittable
+ * dimension.
+ */
+TEST_CASE("HistogramNumericSplitSimpleSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities,
+      aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made.
+  REQUIRE(gain > bestGain);
+
+  // Make sure weight works and is not different than the unweighted one.
+  REQUIRE(gain == weightedGain);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+
+  // With so few values every value has its own bin, so the splitting point
+  // should be between 4 and 5.
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] > 0.4);
+  REQUIRE(classProbabilities[0] < 0.5);
+}
+
+/**
+ * Make sure that HistogramNumericSplit uses at most 256 bins, that each bin
+ * holds a range of values, and that repeated values are not split between bins.
+ */
+TEST_CASE("HistogramNumericSplitQuantizeTest", "[DecisionTreeTest]")
+{
+  arma::rowvec values(10000, arma::fill::randu);
+  values.subvec(0, 999).fill(0.5);
+
+  arma::vec boundaries;
+  HistogramNumericSplit<GiniGain>::Quantize(values, boundaries);
+
+  REQUIRE(boundaries.n_elem < HistogramNumericSplit<GiniGain>::MaxBins);
+  for (size_t i = 1; i < boundaries.n_elem; ++i)
+    REQUIRE(boundaries[i] > boundaries[i - 1]);
+
+  arma::Col<size_t> counts(boundaries.n_elem + 1, arma::fill::zeros);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    const size_t bin = HistogramNumericSplit<GiniGain>::Bin(values[i],
+        boundaries);
+    if (bin > 0)
+      REQUIRE(values[i] > boundaries[bin - 1]);
+    if (bin < boundaries.n_elem)
+      REQUIRE(values[i] <= boundaries[bin]);
+    ++counts[bin];
+  }
+
+  // The bin of the repeated value holds all of its copies, and the other bins
+  // are roughly equal.
+  REQUIRE(counts.max() >= 1000);
+  REQUIRE(counts.max() < 1200);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -1251,3 +1325,114 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * A numeric split that behaves like BestBinaryNumericSplit but does not tell
+ * DecisionTree that it can search presorted points.
+ */
+template<typename FitnessFunction>
+class UnsortedBestBinaryNumericSplit :
+    public BestBinaryNumericSplit<FitnessFunction> { };
+
+/**
+ * Make sure that a tree trained on a large dataset, whose numeric dimensions
+ * are presorted and whose nodes are searched in parallel, is the same as a tree
+ * that sorts at every node.
+ */
+TEST_CASE("PresortedDecisionTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(5, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    labels[i] = (dataset(0, i) + dataset(3, i) > 1.0) ? 1 : 0;
+    if (dataset(2, i) > 0.9)
+      labels[i] = 2;
+  }
+
+  DecisionTree<> d(dataset, labels, 3, 5);
+  DecisionTree<GiniGain, UnsortedBestBinaryNumericSplit> d2(dataset, labels, 3,
+      5);
+
+  REQUIRE(d.NumChildren() == d2.NumChildren());
+
+  arma::Row<size_t> predictions, predictions2;
+  arma::mat probabilities, probabilities2;
+  d.Classify(dataset, predictions, probabilities);
+  d2.Classify(dataset, predictions2, probabilities2);
+
+  REQUIRE(arma::accu(predictions != predictions2) == 0);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    REQUIRE(probabilities[i] == Approx(probabilities2[i]).epsilon(1e-7));
+
+  // The tree should fit the training set well.
+  REQUIRE(arma::accu(predictions == labels) > 0.95 * labels.n_elem);
+}
+
+/**
+ * Make sure that a tree with histogram-based numeric splits fits a large
+ * dataset about as well as a tree with exact splits.
+ */
+TEST_CASE("HistogramDecisionTreeTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(5, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    labels[i] = (dataset(0, i) + dataset(3, i) > 1.0) ? 1 : 0;
+    if (dataset(2, i) > 0.9)
+      labels[i] = 2;
+  }
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  DecisionTree<> d(dataset, labels, 3, 5);
+  DecisionTree<GiniGain, HistogramNumericSplit> hd(dataset, labels, 3, 5);
+  DecisionTree<GiniGain, HistogramNumericSplit> whd(dataset, labels, 3,
+      weights, 5);
+
+  arma::Row<size_t> predictions, histogramPredictions,
+      weightedHistogramPredictions;
+  d.Classify(dataset, predictions);
+  hd.Classify(dataset, histogramPredictions);
+  whd.Classify(dataset, weightedHistogramPredictions);
+
+  const size_t correct = arma::accu(predictions == labels);
+  const size_t histogramCorrect = arma::accu(histogramPredictions == labels);
+  REQUIRE(histogramCorrect > 0.95 * labels.n_elem);
+  REQUIRE(histogramCorrect > 0.98 * correct);
+
+  // Unit weights should fit just as well.
+  REQUIRE(arma::accu(weightedHistogramPredictions == labels) >
+      0.95 * labels.n_elem);
+}
+
+/**
+ * Make sure that a tree with a random dimension selector is the same when it is
+ * trained twice with the same random seed, even on a dataset large enough to
+ * train in parallel.
+ */
+TEST_CASE("RandomDimensionSelectReproducibleTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(10, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (dataset(0, i) + dataset(3, i) + dataset(7, i) > 1.5) ? 1 : 0;
+
+  math::RandomSeed(42);
+  DecisionTree<GiniGain, BestBinaryNumericSplit, AllCategoricalSplit,
+      MultipleRandomDimensionSelect> d(dataset, labels, 2, 5, 1e-7, 0,
+      MultipleRandomDimensionSelect(3));
+  math::RandomSeed(42);
+  DecisionTree<GiniGain, BestBinaryNumericSplit, AllCategoricalSplit,
+      MultipleRandomDimensionSelect> d2(dataset, labels, 2, 5, 1e-7, 0,
+      MultipleRandomDimensionSelect(3));
+
+  arma::Row<size_t> predictions, predictions2;
+  arma::mat probabilities, probabilities2;
+  d.Classify(dataset, predictions, probabilities);
+  d2.Classify(dataset, predictions2, probabilities2);
+
+  REQUIRE(d.NumChildren() == d2.NumChildren());
+  REQUIRE(arma::accu(predictions != predictions2) == 0);
+  REQUIRE(arma::approx_equal(probabilities, probabilities2, "absdiff", 1e-10));
+}
@@ -278,4 +278,40 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Compute the MST of a grid, where nearly all candidate edges have the same
+ * length.  The tied edges must never make a cycle, even when the components are
+ * merged by several threads.
+ */
+BOOST_AUTO_TEST_CASE(GridTiesTest)
+{
+  arma::mat inputData(2, 900);
+  for (size_t i = 0; i < inputData.n_cols; ++i)
+  {
+    inputData(0, i) = i % 30;
+    inputData(1, i) = i / 30;
+  }
+
+  for (const bool naive : { false, true })
+  {
+    DualTreeBoruvka<> dtb(inputData, naive);
+
+    arma::mat results;
+    dtb.ComputeMST(results);
+
+    BOOST_REQUIRE_EQUAL(results.n_cols, inputData.n_cols - 1);
+    BOOST_REQUIRE_CLOSE(arma::accu(results.row(2)), 899.0, 1e-5);
+
+    // The edges must connect every point.
+    UnionFind connections(inputData.n_cols);
+    for (size_t i = 0; i < results.n_cols; ++i)
+    {
+      const size_t a = (size_t) results(0, i);
+      const size_t b = (size_t) results(1, i);
+      BOOST_REQUIRE_NE(connections.Find(a), connections.Find(b));
+      connections.Union(a, b);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -18,6 +18,7 @@
 #include <mlpack/methods/kmeans/kmeans.hpp>
 
 #include <ensmallen.hpp>
+#include <thread>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -525,6 +526,358 @@ BOOST_AUTO_TEST_CASE(PartialForwardTest)
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Make sure that a compiled network predicts the same as the uncompiled one,
+ * also when the number of points is not a multiple of the batch size.
+ */
+BOOST_AUTO_TEST_CASE(CompiledPredictTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat predictions, compiledPredictions;
+  model.Predict(data, predictions);
+
+  model.Compile(7);
+  BOOST_REQUIRE(model.Compiled());
+
+  // Predict twice, so that the buffers of the plan are reused.
+  for (size_t i = 0; i < 2; ++i)
+  {
+    model.Predict(data, compiledPredictions);
+    CheckMatrices(predictions, compiledPredictions);
+  }
+
+  // A single point.
+  model.Predict(data.col(3), compiledPredictions);
+  CheckMatrices(predictions.col(3), compiledPredictions);
+
+  // Adding a layer discards the plan.
+  model.Add<Linear<> >(3, 2);
+  BOOST_REQUIRE(!model.Compiled());
+}
+
+/**
+ * Make sure that the buffers of an execution plan are allocated when it is
+ * compiled with the size of the input, and that they are reused by Predict().
+ */
+BOOST_AUTO_TEST_CASE(CompiledAllocateTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  // The network hasn't seen any data yet, so the size of the input is given.
+  arma::mat data(10, 32, arma::fill::randu);
+  arma::mat predictions, compiledPredictions;
+  model.Compile(16, false, 10);
+  model.Predict(data, compiledPredictions);
+
+  FFN<NegativeLogLikelihood<> > uncompiledModel = model;
+  uncompiledModel.Predict(data, predictions);
+  CheckMatrices(predictions, compiledPredictions);
+
+  // Without the size of the input the plan can't allocate its buffers.
+  ExecutionPlan<> plan;
+  InferenceWorkspace<> workspace;
+  plan.Compile(model.Model(), 16);
+  BOOST_REQUIRE_THROW(plan.Allocate(workspace), std::logic_error);
+
+  plan.Compile(model.Model(), 16, 10);
+  plan.Allocate(workspace);
+  BOOST_REQUIRE_EQUAL(workspace.Activations().size(), plan.NumSteps());
+  for (const arma::mat& activation : workspace.Activations())
+    BOOST_REQUIRE_EQUAL(activation.n_cols, 16);
+
+  // Full batches write into the same memory.
+  const double* memory = workspace.Activations()[0].memptr();
+  plan.Predict(data, compiledPredictions, workspace);
+  CheckMatrices(predictions, compiledPredictions);
+  BOOST_REQUIRE_EQUAL(workspace.Activations()[0].memptr(), memory);
+
+  // No points give empty results, not those of the previous call.
+  plan.Predict(arma::mat(10, 0), compiledPredictions, workspace);
+  BOOST_REQUIRE_EQUAL(compiledPredictions.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(compiledPredictions.n_cols, 0);
+}
+
+/**
+ * Make sure that several threads can predict with one compiled network at
+ * once, each with its own workspace.
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentPredictTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 16);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(16, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  arma::mat data(10, 200, arma::fill::randu);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  // The const overload needs a compiled network.
+  InferenceWorkspace<> workspace;
+  arma::mat unusedPredictions;
+  const FFN<NegativeLogLikelihood<> >& constModel = model;
+  BOOST_REQUIRE_THROW(constModel.Predict(data, unusedPredictions, workspace),
+      std::logic_error);
+
+  model.Compile(16);
+
+  std::vector<arma::mat> threadPredictions(4);
+  std::thread threads[4];
+  for (size_t i = 0; i < 4; ++i)
+  {
+    threads[i] = std::thread([&constModel, &data, &threadPredictions, i]()
+        {
+          InferenceWorkspace<> threadWorkspace;
+          for (size_t j = 0; j < 10; ++j)
+            constModel.Predict(data, threadPredictions[i], threadWorkspace);
+        });
+  }
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    threads[i].join();
+    CheckMatrices(predictions, threadPredictions[i]);
+  }
+}
+
+/**
+ * Make sure that a network compiled in single precision predicts nearly the
+ * same as in double precision.
+ */
+BOOST_AUTO_TEST_CASE(SinglePrecisionPredictTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 16);
+  model.Add<BatchNorm<> >(16);
+  model.Add<TanHLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<LinearNoBias<> >(16, 8);
+  model.Add<LeakyReLU<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  // The copy of the BatchNorm layer has to keep its statistics, scale and
+  // shift.
+  BatchNorm<>* batchNorm = boost::get<BatchNorm<>*>(model.Model()[1]);
+  batchNorm->TrainingMean().randu();
+  batchNorm->TrainingVariance().randu();
+  batchNorm->TrainingVariance() += 0.5;
+  batchNorm->Parameters().randu();
+
+  arma::mat data(10, 50, arma::fill::randu);
+  arma::mat predictions, floatPredictions;
+  model.Predict(data, predictions);
+
+  model.Compile(16, true);
+  BOOST_REQUIRE(model.Compiled());
+
+  model.Predict(data, floatPredictions);
+  CheckMatrices(predictions, floatPredictions, 1e-2);
+
+  // The double-precision workspace doesn't fit a single-precision plan.
+  const FFN<NegativeLogLikelihood<> >& constModel = model;
+  InferenceWorkspace<> workspace;
+  BOOST_REQUIRE_THROW(constModel.Predict(data, floatPredictions, workspace),
+      std::logic_error);
+
+  InferenceWorkspace<arma::fmat> floatWorkspace;
+  constModel.Predict(data, floatPredictions, floatWorkspace);
+  CheckMatrices(predictions, floatPredictions, 1e-2);
+
+  // Layers without a single-precision copy can't be compiled.
+  model.Add<HardTanH<> >();
+  BOOST_REQUIRE_THROW(model.Compile(16, true), std::invalid_argument);
+  BOOST_REQUIRE(!model.Compiled());
+}
+
+/**
+ * Make sure that folding BatchNorm layers and fusing activation layers when
+ * the network is compiled doesn't change the predictions.
+ */
+BOOST_AUTO_TEST_CASE(FusedPredictTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 16);
+  model.Add<BatchNorm<> >(16);
+  model.Add<ReLULayer<> >();
+  model.Add<LinearNoBias<> >(16, 8);
+  model.Add<BatchNorm<> >(4);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  // Give the BatchNorm layers non-trivial statistics and parameters.
+  for (size_t i : { 1, 4 })
+  {
+    BatchNorm<>* batchNorm = boost::get<BatchNorm<>*>(model.Model()[i]);
+    batchNorm->TrainingMean().randu();
+    batchNorm->TrainingVariance().randu();
+    batchNorm->TrainingVariance() += 0.5;
+    batchNorm->Parameters().randu();
+  }
+
+  arma::mat data(10, 50, arma::fill::randu);
+  arma::mat predictions, fusedPredictions;
+  model.Predict(data, predictions);
+
+  model.Compile(16);
+  model.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions, 1e-5);
+
+  // A convolution followed by a BatchNorm layer over its output maps.
+  FFN<NegativeLogLikelihood<> > convModel;
+  convModel.Add<Convolution<> >(1, 4, 3, 3, 1, 1, 1, 1, 6, 6);
+  convModel.Add<BatchNorm<> >(4);
+  convModel.Add<TanHLayer<> >();
+  convModel.Add<Linear<> >(6 * 6 * 4, 3);
+  convModel.Add<LogSoftMax<> >();
+  convModel.ResetParameters();
+
+  BatchNorm<>* batchNorm = boost::get<BatchNorm<>*>(convModel.Model()[1]);
+  batchNorm->TrainingMean().randu();
+  batchNorm->TrainingVariance().randu();
+  batchNorm->TrainingVariance() += 0.5;
+  batchNorm->Parameters().randu();
+
+  arma::mat images(6 * 6, 20, arma::fill::randu);
+  convModel.Predict(images, predictions);
+
+  convModel.Compile(8);
+  convModel.Predict(images, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions, 1e-5);
+}
+
+/**
+ * Make sure that a compiled network with folded layers is compiled again when
+ * its parameters change, also when it is already in deterministic mode.
+ */
+BOOST_AUTO_TEST_CASE(CompiledOutdatedPlanTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(10, 16);
+  model.Add<BatchNorm<> >(16);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(16, 3);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat data(10, 64, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, 64, arma::distr_param(1, 3));
+  model.Compile(16, false, 10);
+
+  const FFN<NegativeLogLikelihood<> >& constModel = model;
+  InferenceWorkspace<> workspace;
+  arma::mat predictions, compiledPredictions;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    if (i == 0)
+    {
+      // Training changes the parameters and the BatchNorm statistics.
+      ens::RMSProp opt(0.01, 16, 0.88, 1e-8, 64, -1);
+      model.Train(data, labels, opt);
+    }
+    else if (i == 1)
+    {
+      // Evaluate the network (this switches it to deterministic mode), as the
+      // L-BFGS optimizer would, and change the parameters in the meantime.
+      model.Evaluate(model.Parameters());
+      model.Parameters() *= 1.5;
+      model.Evaluate(data, labels);
+    }
+    else
+    {
+      model.ResetParameters();
+    }
+
+    // The plan is outdated, so the const overload can't use it.
+    BOOST_REQUIRE_THROW(constModel.Predict(data, compiledPredictions,
+        workspace), std::logic_error);
+
+    FFN<NegativeLogLikelihood<> > uncompiledModel = model;
+    uncompiledModel.Predict(data, predictions);
+
+    model.Predict(data, compiledPredictions);
+    CheckMatrices(predictions, compiledPredictions, 1e-5);
+
+    constModel.Predict(data, compiledPredictions, workspace);
+    CheckMatrices(predictions, compiledPredictions, 1e-5);
+  }
+}
+
+/**
+ * Make sure that training a network in single precision with double-precision
+ * master weights gives nearly the same network as training it in double
+ * precision.
+ */
+BOOST_AUTO_TEST_CASE(MixedPrecisionTrainTest)
+{
+  arma::mat data(10, 128, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, 128, arma::distr_param(1, 3));
+
+  FFN<NegativeLogLikelihood<> > model, floatModel;
+  for (FFN<NegativeLogLikelihood<> >* m : { &model, &floatModel })
+  {
+    m->Add<Linear<> >(10, 16);
+    m->Add<BatchNorm<> >(16);
+    m->Add<SigmoidLayer<> >();
+    m->Add<Linear<> >(16, 3);
+    m->Add<LogSoftMax<> >();
+    m->ResetParameters();
+  }
+
+  // Start from the same parameters; the layers point into the parameters, so
+  // they are copied in place.
+  arma::mat& floatParameters = floatModel.Parameters();
+  floatParameters = model.Parameters();
+  floatModel.MixedPrecision() = true;
+
+  ens::StandardSGD opt(0.05, 16, 5 * data.n_cols, -100, false);
+  model.Train(data, labels, opt);
+  ens::StandardSGD floatOpt(0.05, 16, 5 * data.n_cols, -100, false);
+  floatModel.Train(data, labels, floatOpt);
+
+  CheckMatrices(model.Parameters(), floatModel.Parameters(), 0.1);
+
+  // The running statistics of the BatchNorm layer were collected by the
+  // single-precision copy.
+  BatchNorm<>* batchNorm = boost::get<BatchNorm<>*>(model.Model()[1]);
+  BatchNorm<>* floatBatchNorm = boost::get<BatchNorm<>*>(floatModel.Model()[1]);
+  CheckMatrices(batchNorm->TrainingMean(), floatBatchNorm->TrainingMean(),
+      0.1);
+  CheckMatrices(batchNorm->TrainingVariance(),
+      floatBatchNorm->TrainingVariance(), 0.1);
+
+  arma::mat predictions, floatPredictions;
+  model.Predict(data, predictions);
+  floatModel.Predict(data, floatPredictions);
+  CheckMatrices(predictions, floatPredictions, 0.1);
+
+  // Layers without a single-precision copy can't be trained so.
+  FFN<NegativeLogLikelihood<> > hardTanHModel;
+  hardTanHModel.Add<Linear<> >(10, 3);
+  hardTanHModel.Add<HardTanH<> >();
+  hardTanHModel.Add<LogSoftMax<> >();
+  hardTanHModel.MixedPrecision() = true;
+  BOOST_REQUIRE_THROW(hardTanHModel.Train(data, labels, floatOpt),
+      std::invalid_argument);
+}
+
 /**
  * Test that FFN::Train() returns finite objective value.
  */
@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/gmm/gmm.hpp>
 #include <mlpack/methods/gmm/diagonal_gmm.hpp>
+#include <mlpack/methods/gmm/online_em_fit.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -388,6 +389,128 @@ BOOST_AUTO_TEST_CASE(GMMTrainEMMultipleGaussiansWithProbability)
           - d3.Covariance()(row, col)), 0.7);
 }
 
+/**
+ * Run a single EM iteration on a dataset that spans several of the blocks used
+ * by EMFit, and compare against the update computed directly one point at a
+ * time.
+ */
+BOOST_AUTO_TEST_CASE(GMMTrainEMSingleIterationTest)
+{
+  arma::mat data(3, 3500);
+  data.cols(0, 1999) = arma::randn<arma::mat>(3, 2000);
+  data.cols(2000, 3499) = arma::randn<arma::mat>(3, 1500) + 3.0;
+
+  GMM g(2, 3);
+  g.Component(0).Mean() = arma::vec("-0.5 0.0 0.5");
+  g.Component(0).Covariance(2.0 * arma::eye<arma::mat>(3, 3));
+  g.Component(1).Mean() = arma::vec("2.0 2.5 3.0");
+  g.Component(1).Covariance(arma::mat("1.5 0.2 0.0; 0.2 1.0 0.1; "
+      "0.0 0.1 1.2"));
+  g.Weights() = arma::vec("0.6 0.4");
+
+  // Compute the responsibilities of each component directly.
+  arma::mat responsibilities(2, data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t c = 0; c < 2; ++c)
+    {
+      responsibilities(c, i) = g.Weights()[c] *
+          g.Component(c).Probability(arma::vec(data.col(i)));
+    }
+    responsibilities.col(i) /= arma::accu(responsibilities.col(i));
+  }
+
+  // Two iterations of the loop means only one M-step.
+  EMFit<kmeans::KMeans<>, NoConstraint> fitter(2, 1e-10);
+  g.Train(data, 1, true, fitter);
+
+  for (size_t c = 0; c < 2; ++c)
+  {
+    const double total = arma::accu(responsibilities.row(c));
+    const arma::vec mean = data * responsibilities.row(c).t() / total;
+    const arma::mat diffs = data.each_col() - mean;
+    const arma::mat covariance = (diffs.each_row() % responsibilities.row(c)) *
+        diffs.t() / total;
+
+    BOOST_REQUIRE_CLOSE(g.Weights()[c], total / data.n_cols, 1e-5);
+    for (size_t i = 0; i < 3; ++i)
+      BOOST_REQUIRE_CLOSE(g.Component(c).Mean()[i], mean[i], 1e-5);
+    for (size_t i = 0; i < 9; ++i)
+      BOOST_REQUIRE_CLOSE(g.Component(c).Covariance()[i], covariance[i], 1e-5);
+  }
+}
+
+/**
+ * Stream mini-batches from a known mixture through GMM::Update(), starting
+ * from a poor model, and make sure the model converges to the mixture.
+ */
+BOOST_AUTO_TEST_CASE(GMMOnlineEMUpdateTest)
+{
+  const arma::mat means("0.0 6.0; 0.0 6.0");
+  const arma::vec trueWeights("0.3 0.7");
+
+  GMM g(2, 2);
+  g.Component(0).Mean() = arma::vec("-1.0 1.0");
+  g.Component(1).Mean() = arma::vec("4.0 4.0");
+  g.Component(0).Covariance(4.0 * arma::eye<arma::mat>(2, 2));
+  g.Component(1).Covariance(4.0 * arma::eye<arma::mat>(2, 2));
+  g.Weights() = arma::vec("0.5 0.5");
+
+  OnlineEMFit<> fitter(100, 0.6, 2.0);
+  for (size_t step = 0; step < 200; ++step)
+  {
+    arma::mat batch = arma::randn<arma::mat>(2, 100);
+    for (size_t i = 0; i < batch.n_cols; ++i)
+      batch.col(i) += means.col((i % 10 < 3) ? 0 : 1);
+
+    g.Update(batch, fitter);
+  }
+
+  BOOST_REQUIRE_EQUAL(fitter.Steps(), 200);
+  for (size_t c = 0; c < 2; ++c)
+  {
+    BOOST_REQUIRE_SMALL(g.Weights()[c] - trueWeights[c], 0.03);
+    for (size_t i = 0; i < 2; ++i)
+      BOOST_REQUIRE_SMALL(g.Component(c).Mean()[i] - means(i, c), 0.1);
+    BOOST_REQUIRE_SMALL(g.Component(c).Covariance()(0, 0) - 1.0, 0.15);
+    BOOST_REQUIRE_SMALL(g.Component(c).Covariance()(1, 1) - 1.0, 0.15);
+    BOOST_REQUIRE_SMALL(g.Component(c).Covariance()(0, 1), 0.1);
+  }
+}
+
+/**
+ * Make sure that each trial of GMM::Train() with online EM starts with the
+ * largest step size, so that training twice with the same fitter and the same
+ * random seed gives the same model.
+ */
+BOOST_AUTO_TEST_CASE(GMMOnlineEMTrialsTest)
+{
+  const arma::mat means("0.0 6.0; 0.0 6.0");
+  arma::mat data(2, 5000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i) = means.col(i % 2) + arma::randn<arma::vec>(2);
+
+  OnlineEMFit<> fitter(500);
+  GMM g(2, 2), g2(2, 2);
+
+  math::RandomSeed(7);
+  g.Train(data, 3, false, fitter);
+  // Every trial takes one step per mini-batch, starting from step 0.
+  BOOST_REQUIRE_EQUAL(fitter.Steps(), 10);
+
+  math::RandomSeed(7);
+  g2.Train(data, 3, false, fitter);
+  BOOST_REQUIRE_EQUAL(fitter.Steps(), 10);
+
+  for (size_t c = 0; c < 2; ++c)
+  {
+    BOOST_REQUIRE_CLOSE(g.Weights()[c], g2.Weights()[c], 1e-5);
+    CheckMatrices(g.Component(c).Mean(), g2.Component(c).Mean(), 1e-5);
+    CheckMatrices(g.Component(c).Covariance(), g2.Component(c).Covariance(),
+        1e-5);
+  }
+}
+
 /**
  * Make sure generating observations randomly works.  We'll do this by
  * generating a bunch of random observations and then re-training on them, and
@@ -1181,4 +1304,39 @@ BOOST_AUTO_TEST_CASE(DiagonalGMMLoadSaveTest)
   }
 }
 
+/**
+ * Train a DiagonalGMM with one pass of online EM through DiagonalGMM::Train().
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGMMTrainOnlineEMTest)
+{
+  const arma::mat means("-5.0 5.0; 0.0 10.0; 5.0 -5.0");
+  arma::mat data(3, 20000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    data.col(i) = means.col(i % 2) + arma::vec("1.0 2.0 0.5") %
+        arma::randn<arma::vec>(3);
+  }
+
+  DiagonalGMM g(2, 3);
+  OnlineEMFit<kmeans::KMeans<>, DiagonalConstraint,
+      distribution::DiagonalGaussianDistribution> fitter(500);
+  g.Train(data, 1, false, fitter);
+
+  // Match the components to the true means.
+  const size_t first = (g.Component(0).Mean()[0] < 0.0) ? 0 : 1;
+  for (size_t c = 0; c < 2; ++c)
+  {
+    const size_t component = (c == 0) ? first : 1 - first;
+    BOOST_REQUIRE_SMALL(g.Weights()[component] - 0.5, 0.05);
+    for (size_t i = 0; i < 3; ++i)
+    {
+      BOOST_REQUIRE_SMALL(g.Component(component).Mean()[i] - means(i, c),
+          0.2);
+    }
+    BOOST_REQUIRE_SMALL(g.Component(component).Covariance()[0] - 1.0, 0.2);
+    BOOST_REQUIRE_SMALL(g.Component(component).Covariance()[1] - 4.0, 0.6);
+    BOOST_REQUIRE_SMALL(g.Component(component).Covariance()[2] - 0.25, 0.05);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
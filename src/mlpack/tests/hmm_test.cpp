@@ -530,6 +530,102 @@ BOOST_AUTO_TEST_CASE(DiscreteHMMLogLikelihoodTest)
       -24.51556128368, 1e-5);
 }
 
+/**
+ * Train with Baum-Welch on many short sequences (which are split between
+ * threads), starting near the true model, and make sure the true model is
+ * recovered.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteHMMManyShortSequencesTrainTest)
+{
+  arma::vec initial("0.5 0.5");
+  arma::mat transition("0.8 0.3; 0.2 0.7");
+  std::vector<DiscreteDistribution> emission(2);
+  emission[0].Probabilities() = "0.7 0.2 0.1";
+  emission[1].Probabilities() = "0.1 0.2 0.7";
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+
+  std::vector<arma::mat> sequences(5000);
+  std::vector<arma::Row<size_t>> states(sequences.size());
+  for (size_t i = 0; i < sequences.size(); ++i)
+    hmm.Generate(6, sequences[i], states[i], math::RandInt(2));
+
+  // Start from a perturbed model.
+  std::vector<DiscreteDistribution> startEmission(2);
+  startEmission[0].Probabilities() = "0.5 0.3 0.2";
+  startEmission[1].Probabilities() = "0.2 0.3 0.5";
+  HMM<DiscreteDistribution> hmm2(arma::vec("0.6 0.4"),
+      arma::mat("0.6 0.5; 0.4 0.5"), startEmission, 1e-5);
+
+  double initialLoglik = 0.0;
+  for (size_t i = 0; i < sequences.size(); ++i)
+    initialLoglik += hmm2.LogLikelihood(sequences[i]);
+
+  const double loglik = hmm2.Train(sequences);
+  BOOST_REQUIRE_GT(loglik, initialLoglik);
+
+  BOOST_REQUIRE_LT(arma::norm(hmm.Transition() - hmm2.Transition()), 0.1);
+  for (size_t row = 0; row < 3; row++)
+  {
+    arma::vec obs(1);
+    obs[0] = row;
+    for (size_t col = 0; col < 2; col++)
+    {
+      BOOST_REQUIRE_SMALL(hmm.Emission()[col].Probability(obs) -
+          hmm2.Emission()[col].Probability(obs), 0.05);
+    }
+  }
+}
+
+/**
+ * Make sure the batch versions of Predict() and LogLikelihood() give the same
+ * results as calling them on each sequence.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteHMMBatchPredictLogLikelihoodTest)
+{
+  arma::vec initial("0.5 0.2 0.3");
+  arma::mat transition("0.5 0.0 0.1;"
+                       "0.2 0.6 0.2;"
+                       "0.3 0.4 0.7");
+  std::vector<DiscreteDistribution> emission(3);
+  emission[0].Probabilities() = "0.75 0.25 0.00 0.00";
+  emission[1].Probabilities() = "0.00 0.25 0.25 0.50";
+  emission[2].Probabilities() = "0.10 0.40 0.40 0.10";
+
+  HMM<DiscreteDistribution> hmm(initial, transition, emission);
+
+  std::vector<arma::mat> sequences(200);
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    hmm.Generate(1 + math::RandInt(30), sequences[i], states,
+        math::RandInt(3));
+  }
+
+  std::vector<arma::Row<size_t>> stateSeqs;
+  arma::vec viterbiLogliks, logliks;
+  hmm.Predict(sequences, stateSeqs, viterbiLogliks);
+  hmm.LogLikelihood(sequences, logliks);
+
+  BOOST_REQUIRE_EQUAL(stateSeqs.size(), sequences.size());
+  BOOST_REQUIRE_EQUAL(viterbiLogliks.n_elem, sequences.size());
+  BOOST_REQUIRE_EQUAL(logliks.n_elem, sequences.size());
+  for (size_t i = 0; i < sequences.size(); ++i)
+  {
+    arma::Row<size_t> stateSeq;
+    const double viterbiLoglik = hmm.Predict(sequences[i], stateSeq);
+
+    BOOST_REQUIRE_EQUAL(stateSeqs[i].n_elem, stateSeq.n_elem);
+    for (size_t t = 0; t < stateSeq.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(stateSeqs[i][t], stateSeq[t]);
+    BOOST_REQUIRE_CLOSE(viterbiLogliks[i], viterbiLoglik, 1e-10);
+    BOOST_REQUIRE_CLOSE(logliks[i], hmm.LogLikelihood(sequences[i]), 1e-10);
+
+    // The most probable path can't be more likely than all paths together.
+    BOOST_REQUIRE_LE(viterbiLogliks[i], logliks[i] + 1e-10);
+  }
+}
+
 /**
  * A simple test to make sure HMMs with Gaussian output distributions work.
  */
@@ -1462,4 +1462,121 @@ BOOST_AUTO_TEST_CASE(HoeffdingTreeModelSerializationTest)
   }
 }
 
+/**
+ * Generate a dataset with three numeric features and one categorical feature.
+ */
+void GenerateStreamingDataset(const size_t points,
+                              arma::mat& dataset,
+                              arma::Row<size_t>& labels,
+                              data::DatasetInfo& info)
+{
+  dataset.set_size(4, points);
+  labels.set_size(points);
+  info = data::DatasetInfo(4);
+  info.MapString<double>("0", 3);
+  info.MapString<double>("1", 3);
+  info.MapString<double>("2", 3);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = mlpack::math::RandInt(3);
+    dataset(0, i) = mlpack::math::Random() + 0.3 * labels[i];
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random() - 0.2 * labels[i];
+    dataset(3, i) = (mlpack::math::Random() < 0.8) ? labels[i] :
+        mlpack::math::RandInt(3);
+  }
+}
+
+/**
+ * Make sure that the two given trees have the same nodes and give the same
+ * predictions on the given dataset.
+ */
+void CheckSameTrees(HoeffdingTree<>& pointTree,
+                    HoeffdingTree<>& batchTree,
+                    const arma::mat& dataset)
+{
+  BOOST_REQUIRE_GT(pointTree.NumDescendants(), 1);
+  BOOST_REQUIRE_EQUAL(pointTree.NumDescendants(), batchTree.NumDescendants());
+
+  // Walk both trees together and make sure the nodes are the same.
+  std::stack<std::pair<HoeffdingTree<>*, HoeffdingTree<>*>> stack;
+  stack.push(std::make_pair(&pointTree, &batchTree));
+  while (!stack.empty())
+  {
+    HoeffdingTree<>* pointNode = stack.top().first;
+    HoeffdingTree<>* batchNode = stack.top().second;
+    stack.pop();
+
+    BOOST_REQUIRE_EQUAL(pointNode->NumChildren(), batchNode->NumChildren());
+    BOOST_REQUIRE_EQUAL(pointNode->SplitDimension(),
+        batchNode->SplitDimension());
+    BOOST_REQUIRE_EQUAL(pointNode->MajorityClass(), batchNode->MajorityClass());
+    BOOST_REQUIRE_CLOSE(pointNode->MajorityProbability(),
+        batchNode->MajorityProbability(), 1e-5);
+
+    for (size_t i = 0; i < pointNode->NumChildren(); ++i)
+      stack.push(std::make_pair(&pointNode->Child(i), &batchNode->Child(i)));
+  }
+
+  arma::Row<size_t> pointPredictions, batchPredictions;
+  arma::rowvec pointProbabilities, batchProbabilities;
+  pointTree.Classify(dataset, pointPredictions, pointProbabilities);
+  batchTree.Classify(dataset, batchPredictions, batchProbabilities);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(pointPredictions[i], batchPredictions[i]);
+    BOOST_REQUIRE_CLOSE(pointProbabilities[i], batchProbabilities[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that training on mini-batches in streaming mode gives the same
+ * tree as training on the points one at a time.
+ */
+BOOST_AUTO_TEST_CASE(StreamingMiniBatchTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  data::DatasetInfo info;
+  GenerateStreamingDataset(30000, dataset, labels, info);
+
+  // A small check interval makes the tree split in the middle of batches.
+  HoeffdingTree<> pointTree(info, 3, 0.95, 5000, 50, 100);
+  HoeffdingTree<> batchTree(info, 3, 0.95, 5000, 50, 100);
+
+  for (size_t i = 0; i < 30000; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+  for (size_t i = 0; i < 30000; i += 2500)
+  {
+    const arma::mat batch = dataset.cols(i, i + 2499);
+    const arma::Row<size_t> batchLabels = labels.cols(i, i + 2499);
+    batchTree.Train(batch, batchLabels, false);
+  }
+
+  CheckSameTrees(pointTree, batchTree, dataset);
+}
+
+/**
+ * Make sure that training on one large batch in streaming mode gives the same
+ * tree as training on the points one at a time.  The check interval and the
+ * batch are large enough that the statistics of the dimensions are updated in
+ * parallel, and that the children of the root are trained in parallel.
+ */
+BOOST_AUTO_TEST_CASE(StreamingLargeBatchTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  data::DatasetInfo info;
+  GenerateStreamingDataset(60000, dataset, labels, info);
+
+  HoeffdingTree<> pointTree(info, 3, 0.95, 5000, 1000, 100);
+  HoeffdingTree<> batchTree(info, 3, 0.95, 5000, 1000, 100);
+
+  for (size_t i = 0; i < 60000; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+  batchTree.Train(dataset, labels, false);
+
+  CheckSameTrees(pointTree, batchTree, dataset);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -130,6 +130,49 @@ BOOST_AUTO_TEST_CASE(KDETreeAsArguments)
   delete referenceTree;
 }
 
+/**
+ * Test Train(Tree...) with a tree loaded from a memory-mapped file.
+ */
+BOOST_AUTO_TEST_CASE(KDEMappedTreeTest)
+{
+  arma::mat reference = arma::randu(3, 500);
+  arma::mat query = arma::randu(3, 50);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  arma::vec treeEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.3;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference,
+                                query,
+                                bfEstimations,
+                                kernel);
+
+  // Save a reference tree, and load it from the mapped file.
+  typedef KDTree<EuclideanDistance, kde::KDEStat, arma::mat> Tree;
+  std::vector<size_t> oldFromNew;
+  Tree builtTree(reference, oldFromNew);
+  BOOST_REQUIRE(data::SaveMapped("test_kde_tree.mm", builtTree, oldFromNew));
+
+  {
+    data::MappedFile file("test_kde_tree.mm");
+    Tree referenceTree(file);
+    std::vector<size_t> mappedOldFromNew;
+    BOOST_REQUIRE(data::LoadMapped(file, mappedOldFromNew));
+
+    KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+        kde(relError, 0.0, kernel);
+    kde.Train(&referenceTree, &mappedOldFromNew);
+    kde.Evaluate(query, treeEstimations);
+  }
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError * 100);
+
+  remove("test_kde_tree.mm");
+}
+
 /**
  * Test dual-tree implementation results against brute force results.
  */
@@ -1301,4 +1344,62 @@ BOOST_AUTO_TEST_CASE(GaussianBreadthDualKDTreeMonteCarloKDE)
   BOOST_REQUIRE_GT(correctResults, 70);
 }
 
+/**
+ * Test that the multithreaded single-tree, dual-tree and monochromatic
+ * evaluations still respect the relative error tolerance.  The sets are large
+ * enough for the query points and the query tree to be split between threads.
+ */
+BOOST_AUTO_TEST_CASE(GaussianParallelKDEBruteForceTest)
+{
+  arma::mat reference = arma::randu(3, 3000);
+  arma::mat query = arma::randu(3, 2000);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  arma::vec bfMonoEstimations = arma::vec(reference.n_cols,
+      arma::fill::zeros);
+  const double kernelBandwidth = 0.2;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference,
+                                query,
+                                bfEstimations,
+                                kernel);
+
+  // Brute force monochromatic KDE, without the estimation of a point with
+  // itself.
+  BruteForceKDE<GaussianKernel>(reference,
+                                reference,
+                                bfMonoEstimations,
+                                kernel);
+  bfMonoEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+
+  metric::EuclideanDistance metric;
+  for (const KDEMode mode : { KDEMode::DUAL_TREE_MODE,
+                              KDEMode::SINGLE_TREE_MODE })
+  {
+    KDE<GaussianKernel,
+        metric::EuclideanDistance,
+        arma::mat,
+        tree::KDTree>
+        kde(relError, 0.0, kernel, mode, metric);
+    kde.Train(reference);
+
+    arma::vec treeEstimations;
+    kde.Evaluate(query, treeEstimations);
+    BOOST_REQUIRE_EQUAL(treeEstimations.n_elem, query.n_cols);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError * 100);
+
+    arma::vec monoEstimations;
+    kde.Evaluate(monoEstimations);
+    BOOST_REQUIRE_EQUAL(monoEstimations.n_elem, reference.n_cols);
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(bfMonoEstimations[i], monoEstimations[i],
+          relError * 100);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -17,6 +17,9 @@
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+#include <mlpack/methods/kmeans/kmeans_plus_plus_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
@@ -737,4 +740,183 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+/**
+ * Make sure that the parallel Elkan and Hamerly iterations give the same
+ * clusters as the naive iteration for a larger number of clusters.
+ */
+BOOST_AUTO_TEST_CASE(ElkanHamerlyLargeKTest)
+{
+  arma::mat dataset(5, 5000, arma::fill::randu);
+  const size_t k = 200;
+  arma::mat centroids = dataset.cols(arma::randperm(dataset.n_cols, k));
+
+  KMeans<> km(20);
+  arma::Row<size_t> assignments;
+  arma::mat naiveCentroids(centroids);
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      ElkanKMeans> elkan(20);
+  arma::Row<size_t> elkanAssignments;
+  arma::mat elkanCentroids(centroids);
+  elkan.Cluster(dataset, k, elkanAssignments, elkanCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      HamerlyKMeans> hamerly(20);
+  arma::Row<size_t> hamerlyAssignments;
+  arma::mat hamerlyCentroids(centroids);
+  hamerly.Cluster(dataset, k, hamerlyAssignments, hamerlyCentroids, false,
+      true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(assignments[i], elkanAssignments[i]);
+    BOOST_REQUIRE_EQUAL(assignments[i], hamerlyAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], elkanCentroids[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], hamerlyCentroids[i], 1e-5);
+  }
+}
+
+/**
+ * With one chunk that holds the whole dataset, the first mini-batch step must
+ * be the same as a naive Lloyd step.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchSingleBatchTest)
+{
+  arma::mat dataset(4, 500, arma::fill::randu);
+  arma::mat centroids(4, 6, arma::fill::randu);
+
+  metric::EuclideanDistance metric;
+  NaiveKMeans<metric::EuclideanDistance, arma::mat> naive(dataset, metric);
+  MiniBatchKMeans<metric::EuclideanDistance, arma::mat> miniBatch(dataset,
+      metric, dataset.n_cols);
+
+  arma::mat naiveCentroids, miniBatchCentroids;
+  arma::Col<size_t> naiveCounts, miniBatchCounts;
+  const double naiveNorm = naive.Iterate(centroids, naiveCentroids,
+      naiveCounts);
+  const double miniBatchNorm = miniBatch.Iterate(centroids,
+      miniBatchCentroids, miniBatchCounts);
+
+  BOOST_REQUIRE_CLOSE(naiveNorm, miniBatchNorm, 1e-5);
+  for (size_t i = 0; i < naiveCounts.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(naiveCounts[i], miniBatchCounts[i]);
+    if (naiveCounts[i] == 0)
+      continue;
+
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+    {
+      BOOST_REQUIRE_CLOSE(naiveCentroids(d, i), miniBatchCentroids(d, i),
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that mini-batch k-means finds well-separated clusters in a few
+ * passes.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  arma::mat means("0.0 10.0 -10.0;"
+                  "0.0 10.0   5.0");
+  arma::mat dataset(2, 6000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = means.col(i % 3) + 0.3 * arma::randn<arma::vec>(2);
+
+  // Start from one point of each cluster.
+  arma::mat centroids = dataset.cols(0, 2);
+
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, MiniBatchKMeans> kmeans(5);
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], i % 3);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(centroids[i] - means[i], 0.05);
+}
+
+/**
+ * Make sure that k-means++ picks one point from each of a few well-separated
+ * clusters, and that its centroids are points of the dataset.
+ */
+BOOST_AUTO_TEST_CASE(KMeansPlusPlusInitializationTest)
+{
+  arma::mat means("0.0 50.0 -50.0  50.0;"
+                  "0.0 50.0  50.0 -50.0");
+  arma::mat dataset(2, 2000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = means.col(i % 4) + arma::randn<arma::vec>(2);
+
+  arma::mat centroids;
+  KMeansPlusPlusInitialization().Cluster(dataset, 4, centroids);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, 4);
+
+  arma::Row<size_t> found(4, arma::fill::zeros);
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    const arma::rowvec distances = arma::sum(arma::square(dataset.each_col() -
+        centroids.col(c)), 0);
+    BOOST_REQUIRE_SMALL(distances.min(), 1e-10);
+
+    arma::uword closest;
+    arma::sum(arma::square(means.each_col() - centroids.col(c)), 0).min(
+        closest);
+    found[closest] = 1;
+  }
+
+  // With clusters this far apart, k-means++ picks one point from each.
+  BOOST_REQUIRE_EQUAL(arma::accu(found), 4);
+
+  // Weights that don't match the number of points are an error.
+  BOOST_REQUIRE_THROW(KMeansPlusPlusInitialization::WeightedCluster(dataset,
+      arma::vec(10, arma::fill::ones), 4, centroids), std::invalid_argument);
+}
+
+/**
+ * Make sure that k-means|| gives a good clustering when used as the initial
+ * partition policy, on both dense and sparse data.
+ */
+BOOST_AUTO_TEST_CASE(KMeansParallelInitializationTest)
+{
+  arma::mat means("0.0 50.0 -50.0  50.0 -50.0;"
+                  "0.0 50.0  50.0 -50.0 -50.0");
+  arma::mat dataset(2, 5000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = means.col(i % 5) + arma::randn<arma::vec>(2);
+
+  arma::mat initialCentroids;
+  KMeansParallelInitialization(3, 2.0).Cluster(dataset, 5, initialCentroids);
+  BOOST_REQUIRE_EQUAL(initialCentroids.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(initialCentroids.n_cols, 5);
+
+  KMeans<metric::EuclideanDistance, KMeansParallelInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  kmeans.Cluster(dataset, 5, assignments, centroids);
+
+  // Each of the true clusters should be exactly one cluster.
+  for (size_t i = 5; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], assignments[i % 5]);
+  arma::Row<size_t> firstAssignments = assignments.cols(0, 4);
+  BOOST_REQUIRE_EQUAL(arma::unique(firstAssignments).eval().n_elem, 5);
+
+  // The sparse version only needs to run and give centroids of the right size.
+  arma::sp_mat sparseDataset(arma::conv_to<arma::mat>::from(
+      arma::abs(dataset) > 25.0));
+  KMeansParallelInitialization().Cluster(sparseDataset, 3, initialCentroids);
+  BOOST_REQUIRE_EQUAL(initialCentroids.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(initialCentroids.n_cols, 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -17,6 +17,9 @@
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
 
+#include <cstring>
+#include <fstream>
+
 using namespace mlpack;
 using namespace mlpack::neighbor;
 using namespace mlpack::tree;
@@ -1770,3 +1773,299 @@ TEST_CASE("KNNGreedyTreeSearch", "[KNNTest]")
   // generates a uniform distribution in [0, 1].
   REQUIRE(arma::accu(distances < 0.0 || distances > std::sqrt(3.0)) == 0);
 }
+
+/**
+ * Run a dual-tree search with the given tree type using several threads, and
+ * make sure the results are the same as naive search.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckParallelDualTreeSearch(const arma::mat& dataset,
+                                 const arma::mat& queries)
+{
+  #ifdef HAS_OPENMP
+    const int oldThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, TreeType>
+      treeSearch(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  // Search with a query set.
+  arma::Mat<size_t> treeNeighbors, naiveNeighbors;
+  arma::mat treeDistances, naiveDistances;
+  treeSearch.Search(queries, 10, treeNeighbors, treeDistances);
+  naive.Search(queries, 10, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(treeNeighbors, naiveNeighbors);
+  CheckMatrices(treeDistances, naiveDistances);
+
+  // Now the monochromatic search.
+  treeSearch.Search(10, treeNeighbors, treeDistances);
+  naive.Search(10, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(treeNeighbors, naiveNeighbors);
+  CheckMatrices(treeDistances, naiveDistances);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(oldThreads);
+  #endif
+}
+
+/**
+ * Make sure that the parallel dual-tree traversal gives the same results as
+ * naive search for several different tree types.
+ */
+TEST_CASE("KNNParallelDualTreeSearchTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat queries = arma::randu<arma::mat>(3, 1500);
+
+  CheckParallelDualTreeSearch<KDTree>(dataset, queries);
+  CheckParallelDualTreeSearch<BallTree>(dataset, queries);
+  CheckParallelDualTreeSearch<StandardCoverTree>(dataset, queries);
+  CheckParallelDualTreeSearch<RTree>(dataset, queries);
+  CheckParallelDualTreeSearch<Octree>(dataset, queries);
+  CheckParallelDualTreeSearch<SPTree>(dataset, queries);
+}
+
+/**
+ * Make sure that the parallel dual-tree traverser splits the query tree into
+ * disjoint subtrees, and that each subtree's rules share the candidate lists.
+ */
+TEST_CASE("KNNParallelDualTreeTraverserTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 3000);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  std::vector<size_t> oldFromNew;
+  TreeType kdTree(dataset, oldFromNew);
+
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance, TreeType>
+      RuleType;
+  EuclideanDistance metric;
+  RuleType rules(kdTree.Dataset(), kdTree.Dataset(), 5, metric, 0, true);
+
+  #ifdef HAS_OPENMP
+    const int oldThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  tree::ParallelDualTreeTraverser<RuleType, TreeType::DualTreeTraverser>
+      traverser(rules, 8);
+  traverser.Traverse(kdTree, kdTree);
+
+  #ifdef HAS_OPENMP
+    REQUIRE(traverser.NumTasks() >= 32);
+    omp_set_num_threads(oldThreads);
+  #else
+    REQUIRE(traverser.NumTasks() == 1);
+  #endif
+
+  REQUIRE(rules.BaseCases() > 0);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  rules.GetResults(neighbors, distances);
+
+  KNN naive(kdTree.Dataset(), NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that the leaf base cases computed with a matrix product give the
+ * same results as naive search for high-dimensional data, including points that
+ * are very close to each other.
+ */
+TEST_CASE("KNNLeafBaseCaseTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(64, 1200) + 100.0;
+  // Add near-duplicates of some points, so that some distances are tiny
+  // compared to the norms of the points.
+  arma::mat queries = dataset.cols(0, 299) + 1e-7 *
+      arma::randu<arma::mat>(64, 300);
+  queries.insert_cols(300, arma::randu<arma::mat>(64, 300) + 100.0);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+
+  // Euclidean distance.
+  KNN dualTree(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  dualTree.Search(queries, 5, neighbors, distances);
+  naive.Search(queries, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Only the distances evaluated with the metric are counted, and most
+  // reference points are filtered out without evaluating them.
+  REQUIRE(dualTree.BaseCases() > 0);
+  REQUIRE(dualTree.BaseCases() < naive.BaseCases());
+
+  dualTree.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Squared Euclidean distance, furthest neighbors.
+  NeighborSearch<FurthestNeighborSort, SquaredEuclideanDistance> kfn(dataset);
+  NeighborSearch<FurthestNeighborSort, SquaredEuclideanDistance>
+      naiveKFN(dataset, NAIVE_MODE);
+  kfn.Search(queries, 5, neighbors, distances);
+  naiveKFN.Search(queries, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that a kd-tree saved to a memory-mapped file and loaded from it
+ * gives the same results as naive search, and that its dataset is not copied.
+ */
+TEST_CASE("KNNMappedTreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::mat queries = arma::randu<arma::mat>(5, 200);
+
+  typedef KNN::Tree TreeType;
+  std::vector<size_t> oldFromNew;
+  TreeType builtTree(dataset, oldFromNew);
+  REQUIRE(data::SaveMapped("test_knn_tree.mm", builtTree, oldFromNew));
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  std::vector<size_t> mappedOldFromNew;
+  {
+    data::MappedFile file("test_knn_tree.mm");
+    TreeType mappedTree(file);
+    REQUIRE((const char*) mappedTree.Dataset().memptr() ==
+        file.Data() + file.Header().dataOffset);
+    REQUIRE(mappedTree.NumDescendants() == builtTree.NumDescendants());
+    REQUIRE(data::LoadMapped(file, mappedOldFromNew));
+
+    KNN knn(std::move(mappedTree));
+    knn.Search(queries, 5, neighbors, distances);
+  }
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(queries, 5, naiveNeighbors, naiveDistances);
+
+  // The neighbors found with the mapped tree are indices into the tree's
+  // dataset.
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+    neighbors[i] = mappedOldFromNew[neighbors[i]];
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  remove("test_knn_tree.mm");
+}
+
+/**
+ * Write the given contents to the given file, and make sure that it can't be
+ * mapped.
+ */
+void CheckCorruptMappedFile(const std::string& filename,
+                            const std::string& contents)
+{
+  std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+  out.write(contents.data(), contents.size());
+  out.close();
+
+  REQUIRE_THROWS_AS(data::MappedFile(filename), std::runtime_error);
+}
+
+/**
+ * Change the given node of the tree in the given contents of a mapped file.
+ */
+void SetMappedNode(std::string& contents,
+                   const data::MappedHeader& header,
+                   const size_t index,
+                   const data::MappedNode& node)
+{
+  std::memcpy(&contents[header.nodeOffset + index * sizeof(data::MappedNode)],
+      &node, sizeof(data::MappedNode));
+}
+
+/**
+ * Make sure that a corrupt or truncated tree file is rejected when it is
+ * mapped, instead of reading outside of the file when the tree is built.
+ */
+TEST_CASE("KNNMappedTreeCorruptTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  std::vector<size_t> oldFromNew;
+  KNN::Tree tree(dataset, oldFromNew);
+  REQUIRE(data::SaveMapped("test_corrupt_tree.mm", tree, oldFromNew));
+  REQUIRE_NOTHROW(data::MappedFile("test_corrupt_tree.mm"));
+
+  std::ifstream in("test_corrupt_tree.mm", std::ios::binary);
+  const std::string contents((std::istreambuf_iterator<char>(in)),
+      std::istreambuf_iterator<char>());
+  in.close();
+
+  data::MappedHeader header;
+  std::memcpy(&header, contents.data(), sizeof(data::MappedHeader));
+  REQUIRE(header.numNodes > 3);
+
+  std::vector<data::MappedNode> nodes(header.numNodes);
+  std::memcpy(nodes.data(), contents.data() + header.nodeOffset,
+      header.numNodes * sizeof(data::MappedNode));
+
+  // A child index past the end of the node array.
+  std::string changed = contents;
+  data::MappedNode node = nodes[0];
+  node.left = header.numNodes;
+  SetMappedNode(changed, header, 0, node);
+  CheckCorruptMappedFile("test_corrupt_tree.mm", changed);
+
+  // A node that is its own child.
+  const size_t child = nodes[0].left;
+  REQUIRE(nodes[child].left != 0);
+  changed = contents;
+  node = nodes[child];
+  node.left = child;
+  SetMappedNode(changed, header, child, node);
+  CheckCorruptMappedFile("test_corrupt_tree.mm", changed);
+
+  // Two nodes with the same child.
+  changed = contents;
+  node = nodes[0];
+  node.right = node.left;
+  SetMappedNode(changed, header, 0, node);
+  CheckCorruptMappedFile("test_corrupt_tree.mm", changed);
+
+  // A node whose points lie past the end of the dataset.
+  changed = contents;
+  node = nodes[child];
+  node.begin = header.nCols;
+  SetMappedNode(changed, header, child, node);
+  CheckCorruptMappedFile("test_corrupt_tree.mm", changed);
+
+  // A number of nodes so large that the size of the node array overflows.
+  changed = contents;
+  data::MappedHeader badHeader = header;
+  badHeader.numNodes = ((uint64_t) 1) << 60;
+  std::memcpy(&changed[0], &badHeader, sizeof(data::MappedHeader));
+  CheckCorruptMappedFile("test_corrupt_tree.mm", changed);
+
+  // A truncated file.
+  CheckCorruptMappedFile("test_corrupt_tree.mm",
+      contents.substr(0, contents.size() - 16));
+
+  remove("test_corrupt_tree.mm");
+}
@@ -2388,3 +2388,161 @@ TEST_CASE("DatasetMapperNonUniqueTest", "[LoadSaveTest]")
   REQUIRE(dm.UnmapString(nan, 0, 1) == "goodbye");
   REQUIRE(dm.UnmapString(nan, 0, 2) == "cheese");
 }
+
+/**
+ * Make sure a matrix saved to a mapped file is loaded without a copy.
+ */
+TEST_CASE("MappedMatrixTest", "[LoadSaveTest]")
+{
+  arma::mat matrix = arma::randu<arma::mat>(7, 150);
+  REQUIRE(data::SaveMapped("test_mapped.mm", matrix) == true);
+
+  {
+    data::MappedFile file("test_mapped.mm");
+    REQUIRE(file.Header().numNodes == 0);
+
+    const arma::mat mapped = file.Matrix<double>();
+
+    // The matrix must point into the mapped file.
+    REQUIRE((const char*) mapped.memptr() ==
+        file.Data() + file.Header().dataOffset);
+    REQUIRE(mapped.n_rows == 7);
+    REQUIRE(mapped.n_cols == 150);
+    for (size_t i = 0; i < matrix.n_elem; ++i)
+      REQUIRE(mapped[i] == matrix[i]);
+
+    // The element type must match, and there is no mapping of indices.
+    REQUIRE_THROWS_AS(file.Matrix<float>(), std::invalid_argument);
+    std::vector<size_t> oldFromNew;
+    REQUIRE(data::LoadMapped(file, oldFromNew) == false);
+  }
+
+  remove("test_mapped.mm");
+}
+
+/**
+ * Make sure that a file that is not a mapped file can't be mapped.
+ */
+TEST_CASE("MappedFileInvalidTest", "[LoadSaveTest]")
+{
+  REQUIRE_THROWS_AS(data::MappedFile("does_not_exist.mm"), std::runtime_error);
+
+  arma::mat matrix = arma::randu<arma::mat>(3, 10);
+  REQUIRE(data::Save("test_mapped.csv", matrix) == true);
+  REQUIRE_THROWS_AS(data::MappedFile("test_mapped.csv"), std::runtime_error);
+
+  remove("test_mapped.csv");
+}
+
+/**
+ * Write a CSV with numeric and categorical dimensions that is large enough to
+ * be split into many blocks and chunks.
+ */
+void WriteChunkedCSV(const std::string& filename, const size_t points)
+{
+  std::fstream f;
+  f.open(filename, std::fstream::out);
+  for (size_t i = 0; i < points; ++i)
+  {
+    f << i << ", " << (0.5 * i) << ", cat" << ((7 * i) % 31) << ", "
+        << ((i % 5 == 0) ? "\"yes, really\"" : "no") << std::endl;
+  }
+  f.close();
+}
+
+/**
+ * Make sure that a CSV split into many small blocks is loaded the same way as
+ * if it were parsed line by line, including the order of the categorical
+ * mappings.
+ */
+TEST_CASE("LoadCSVChunkedTest", "[LoadSaveTest]")
+{
+  const size_t points = 20000;
+  WriteChunkedCSV("test_chunked.csv", points);
+
+  for (size_t blockSize : { 1000, 100000, 10000000 })
+  {
+    arma::mat dataset;
+    data::DatasetInfo info;
+    data::LoadCSV loader("test_chunked.csv");
+    loader.BlockSize() = blockSize;
+    loader.Load(dataset, info, true);
+
+    REQUIRE(dataset.n_rows == 4);
+    REQUIRE(dataset.n_cols == points);
+    REQUIRE(info.Type(0) == data::Datatype::numeric);
+    REQUIRE(info.Type(1) == data::Datatype::numeric);
+    REQUIRE(info.Type(2) == data::Datatype::categorical);
+    REQUIRE(info.Type(3) == data::Datatype::categorical);
+    REQUIRE(info.NumMappings(2) == 31);
+    REQUIRE(info.NumMappings(3) == 2);
+
+    for (size_t i = 0; i < points; ++i)
+    {
+      REQUIRE(dataset(0, i) == Approx(i).epsilon(1e-7));
+      REQUIRE(dataset(1, i) == Approx(0.5 * i).epsilon(1e-7));
+      // The categories are mapped in the order they first appear in the file.
+      REQUIRE(dataset(2, i) == i % 31);
+      REQUIRE(dataset(3, i) == ((i % 5 == 0) ? 0 : 1));
+    }
+
+    REQUIRE(info.UnmapString(3, 2) == "cat21");
+    REQUIRE(info.UnmapString(0, 3) == "\"yes, really\"");
+  }
+
+  // A malformed line must be found wherever it is.
+  std::fstream f;
+  f.open("test_chunked.csv", std::fstream::out | std::fstream::app);
+  f << "1, 2, 3" << std::endl;
+  f.close();
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  data::LoadCSV loader("test_chunked.csv");
+  loader.BlockSize() = 1000;
+  REQUIRE_THROWS_AS(loader.Load(dataset, info, true), std::runtime_error);
+
+  remove("test_chunked.csv");
+}
+
+/**
+ * Make sure that the batches of a streamed CSV put together are the same as
+ * the whole file.
+ */
+TEST_CASE("LoadCSVStreamingTest", "[LoadSaveTest]")
+{
+  const size_t points = 10000;
+  WriteChunkedCSV("test_streaming.csv", points);
+
+  arma::mat dataset;
+  data::DatasetInfo info;
+  REQUIRE(data::Load("test_streaming.csv", dataset, info) == true);
+
+  data::LoadCSV loader("test_streaming.csv");
+  loader.BlockSize() = 5000;
+  data::DatasetInfo batchInfo;
+  arma::mat batch;
+  size_t numBatches = 0;
+  size_t col = 0;
+  while (loader.NextBatch(batch, batchInfo, 3000))
+  {
+    ++numBatches;
+    REQUIRE(batch.n_rows == 4);
+    REQUIRE(batch.n_cols == std::min((size_t) 3000, points - col));
+    for (size_t i = 0; i < batch.n_cols; ++i, ++col)
+      for (size_t d = 0; d < 4; ++d)
+        REQUIRE(batch(d, i) == dataset(d, col));
+  }
+
+  REQUIRE(numBatches == 4);
+  REQUIRE(col == points);
+  REQUIRE(batchInfo.NumMappings(2) == info.NumMappings(2));
+  REQUIRE(batchInfo.NumMappings(3) == info.NumMappings(3));
+  REQUIRE(batchInfo.Type(0) == data::Datatype::numeric);
+  REQUIRE(batchInfo.Type(2) == data::Datatype::categorical);
+
+  // There are no more batches.
+  REQUIRE(loader.NextBatch(batch, batchInfo, 3000) == false);
+
+  remove("test_streaming.csv");
+}
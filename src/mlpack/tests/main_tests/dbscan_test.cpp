@@ -429,6 +429,39 @@ BOOST_AUTO_TEST_CASE(DBSCANNaiveSearchTest)
   CheckMatrices(output, naiveOutput);
 }
 
+/**
+ * Check that the assignment of cluster is same if
+ * grid-based search is used on two-dimensional data.
+ */
+BOOST_AUTO_TEST_CASE(DBSCANGridSearchTest)
+{
+  arma::mat inputData(2, 500, arma::fill::randu);
+
+  SetInputParam("input", inputData);
+  SetInputParam("epsilon", 0.05);
+
+  mlpackMain();
+
+  arma::Row<size_t> output;
+  output = std::move(IO::GetParam<arma::Row<size_t>>("assignments"));
+
+  bindings::tests::CleanMemory();
+
+  IO::GetSingleton().Parameters()["input"].wasPassed = false;
+  IO::GetSingleton().Parameters()["epsilon"].wasPassed = false;
+
+  SetInputParam("input", inputData);
+  SetInputParam("epsilon", 0.05);
+  SetInputParam("grid", true);
+
+  mlpackMain();
+
+  arma::Row<size_t> gridOutput;
+  gridOutput = std::move(IO::GetParam<arma::Row<size_t>>("assignments"));
+
+  CheckMatrices(output, gridOutput);
+}
+
 /**
  * Check that the assignment of cluster is different if
  * point selection policies are different.
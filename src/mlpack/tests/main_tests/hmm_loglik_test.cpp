@@ -72,4 +72,40 @@ BOOST_AUTO_TEST_CASE(HMMLoglikOutputNegativeTest)
   BOOST_REQUIRE(loglik <= 0);
 }
 
+/**
+ * Make sure that concatenated sequences with the lengths parameter give one
+ * log-likelihood per sequence.
+ */
+BOOST_AUTO_TEST_CASE(HMMLoglikBatchTest)
+{
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(&trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(&trainSeq);
+
+  // The same sequence twice, then its first half.
+  const size_t half = inp.n_cols / 2;
+  arma::mat batch = arma::join_rows(arma::join_rows(inp, inp),
+      inp.cols(0, half - 1));
+  arma::Row<size_t> lengths = { (size_t) inp.n_cols, (size_t) inp.n_cols,
+      half };
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", std::move(batch));
+  SetInputParam("lengths", std::move(lengths));
+
+  mlpackMain();
+
+  const arma::vec& logliks = IO::GetParam<arma::vec>("log_likelihoods");
+  BOOST_REQUIRE_EQUAL(logliks.n_elem, 3);
+  BOOST_REQUIRE_CLOSE(logliks[0], logliks[1], 1e-5);
+  BOOST_REQUIRE_LE(logliks[0], 0.0);
+  BOOST_REQUIRE_GE(logliks[2], logliks[0]);
+  BOOST_REQUIRE_CLOSE(IO::GetParam<double>("log_likelihood"),
+      arma::accu(logliks), 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/compiled_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -96,6 +97,29 @@ BOOST_AUTO_TEST_CASE(BootstrapWeightsTest)
   }
 }
 
+/**
+ * Make sure bootstrap sample indices are in the dataset.
+ */
+BOOST_AUTO_TEST_CASE(BootstrapSamplesTest)
+{
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::Col<size_t> samples;
+    BootstrapSamples(1000, samples);
+
+    BOOST_REQUIRE_EQUAL(samples.n_elem, 1000);
+    BOOST_REQUIRE_LT(samples.max(), 1000);
+
+    // Sampling with replacement should leave out about a third of the points.
+    arma::Col<size_t> counts(1000, arma::fill::zeros);
+    for (size_t i = 0; i < samples.n_elem; ++i)
+      ++counts[samples[i]];
+    const size_t unused = arma::accu(counts == 0);
+    BOOST_REQUIRE_GT(unused, 250);
+    BOOST_REQUIRE_LT(unused, 480);
+  }
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -152,6 +176,43 @@ BOOST_AUTO_TEST_CASE(UnweightedNumericLearningTest)
   BOOST_REQUIRE_GE(rfCorrect, size_t(0.7 * testDataset.n_cols));
 }
 
+/**
+ * Test numeric learning with histogram-based splits, making sure that we get
+ * performance close to exact splits.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericLearningTest)
+{
+  // Load the vc2 dataset.
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  // Build a random forest with histogram-based splits and a decision tree.
+  RandomForest<GiniGain, MultipleRandomDimensionSelect, HistogramNumericSplit>
+      rf(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+  DecisionTree<> dt(dataset, labels, 3, 5);
+
+  // Get performance statistics on test data.
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> rfPredictions;
+  arma::Row<size_t> dtPredictions;
+
+  rf.Classify(testDataset, rfPredictions);
+  dt.Classify(testDataset, dtPredictions);
+
+  // Calculate the number of correct points.
+  size_t rfCorrect = arma::accu(rfPredictions == testLabels);
+  size_t dtCorrect = arma::accu(dtPredictions == testLabels);
+
+  BOOST_REQUIRE_GE(rfCorrect, dtCorrect * 0.9);
+  BOOST_REQUIRE_GE(rfCorrect, size_t(0.7 * testDataset.n_cols));
+}
+
 /**
  * Test weighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -487,4 +548,126 @@ BOOST_AUTO_TEST_CASE(DifferentTreesTest)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Make sure that a compiled random forest gives the same predictions and
+ * probabilities as the forest.
+ */
+BOOST_AUTO_TEST_CASE(CompiledForestTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1, 1e-7);
+  CompiledForest compiled(rf);
+
+  BOOST_REQUIRE_EQUAL(compiled.NumTrees(), 20);
+  BOOST_REQUIRE_EQUAL(compiled.NumClasses(), 3);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  arma::Row<size_t> predictions, compiledPredictions;
+  arma::mat probabilities, compiledProbabilities;
+  rf.Classify(testDataset, predictions, probabilities);
+  compiled.Classify(testDataset, compiledPredictions, compiledProbabilities);
+
+  BOOST_REQUIRE_EQUAL(compiledPredictions.n_elem, testDataset.n_cols);
+  BOOST_REQUIRE_EQUAL(compiledProbabilities.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(compiledProbabilities.n_cols, testDataset.n_cols);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], compiledPredictions[i]);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(probabilities[i], compiledProbabilities[i], 1e-5);
+}
+
+/**
+ * Compare the time of batch classification with a 500-tree random forest and
+ * with the compiled forest.  The ratio is only reported (run with
+ * --log_level=message to see it), since timings depend on the machine; the
+ * predictions must match.
+ */
+BOOST_AUTO_TEST_CASE(CompiledForestBenchmarkTest)
+{
+  arma::mat dataset(10, 5000, arma::fill::randu);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    labels[i] = (dataset(0, i) + dataset(3, i) > 1.0) ? 1 : 0;
+    if (dataset(5, i) > 0.8)
+      labels[i] = 2;
+  }
+
+  RandomForest<> rf(dataset, labels, 3, 500 /* 500 trees */, 5);
+  CompiledForest compiled(rf);
+
+  const arma::mat testDataset(10, 20000, arma::fill::randu);
+  arma::Row<size_t> predictions, compiledPredictions;
+  arma::mat probabilities, compiledProbabilities;
+
+  arma::wall_clock clock;
+  clock.tic();
+  rf.Classify(testDataset, predictions, probabilities);
+  const double forestTime = clock.toc();
+
+  clock.tic();
+  compiled.Classify(testDataset, compiledPredictions, compiledProbabilities);
+  const double compiledTime = clock.toc();
+
+  BOOST_TEST_MESSAGE("RandomForest::Classify(): " << forestTime << "s; "
+      << "CompiledForest::Classify(): " << compiledTime << "s; speedup "
+      << forestTime / compiledTime << "x.");
+
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], compiledPredictions[i]);
+  for (size_t i = 0; i < probabilities.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(probabilities[i], compiledProbabilities[i], 1e-5);
+}
+
+/**
+ * Make sure that a compiled decision tree with categorical splits gives the
+ * same predictions as the tree.
+ */
+BOOST_AUTO_TEST_CASE(CompiledCategoricalTreeTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  DecisionTree<> tree(d, di, l, 5, 10);
+  CompiledForest compiled(tree);
+
+  BOOST_REQUIRE_EQUAL(compiled.NumTrees(), 1);
+
+  arma::Row<size_t> predictions, compiledPredictions;
+  tree.Classify(d, predictions);
+  compiled.Classify(d, compiledPredictions);
+
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], compiledPredictions[i]);
+}
+
+/**
+ * Make sure that an empty compiled forest cannot predict, and that trees with
+ * different numbers of classes cannot be combined.
+ */
+BOOST_AUTO_TEST_CASE(CompiledForestErrorTest)
+{
+  arma::mat dataset(5, 100, arma::fill::randu);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(100,
+      arma::distr_param(0, 1));
+
+  CompiledForest compiled;
+  arma::Row<size_t> predictions;
+  BOOST_REQUIRE_THROW(compiled.Classify(dataset, predictions),
+      std::invalid_argument);
+
+  DecisionTree<> tree(dataset, labels, 2);
+  DecisionTree<> tree3(dataset, labels, 3);
+  compiled.AddTree(tree);
+  BOOST_REQUIRE_THROW(compiled.AddTree(tree3), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
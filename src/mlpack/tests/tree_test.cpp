@@ -1803,6 +1803,131 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeMoveConstructorTest)
   BOOST_REQUIRE_EQUAL(tree2.NumChildren(), 2);
 }
 
+//! Make sure two binary space trees have the same structure.
+template<typename TreeType>
+void CheckSameTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_CLOSE(a.ParentDistance(), b.ParentDistance(), 1e-5);
+  BOOST_REQUIRE_CLOSE(a.FurthestDescendantDistance(),
+      b.FurthestDescendantDistance(), 1e-5);
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that a kd-tree built with several threads (and its nodes held in an
+ * arena) is the same as a kd-tree built with one thread.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeParallelBuildTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(3, 50000);
+  dataset.randu();
+
+  #ifdef HAS_OPENMP
+    const int oldThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+  #endif
+
+  std::vector<size_t> oldFromNew;
+  TreeType serialTree(dataset, oldFromNew);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(4);
+  #endif
+
+  std::vector<size_t> parallelOldFromNew;
+  TreeType parallelTree(dataset, parallelOldFromNew);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(oldThreads);
+  #endif
+
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), parallelOldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew[i], parallelOldFromNew[i]);
+
+  CheckSameTree(serialTree, parallelTree);
+  CheckPointBounds(parallelTree);
+
+  // A copy of the tree is allocated node by node; it must still be the same.
+  TreeType copy(parallelTree);
+  CheckSameTree(parallelTree, copy);
+
+  // Moving the tree must keep the arena alive.
+  TreeType moved(std::move(parallelTree));
+  CheckSameTree(serialTree, moved);
+}
+
+/**
+ * Make sure that random projection trees built with several threads hold every
+ * point in exactly one leaf, and are the same when built with the same random
+ * seed.
+ */
+BOOST_AUTO_TEST_CASE(RPTreeParallelBuildTest)
+{
+  typedef RPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef MaxRPTree<EuclideanDistance, EmptyStatistic, arma::mat> MaxTreeType;
+
+  arma::mat dataset(5, 30000);
+  dataset.randu();
+
+  #ifdef HAS_OPENMP
+    const int oldThreads = omp_get_max_threads();
+    omp_set_num_threads(4);
+  #endif
+
+  math::RandomSeed(42);
+  std::vector<size_t> oldFromNew;
+  TreeType root(dataset, oldFromNew);
+  MaxTreeType maxRoot(dataset);
+
+  math::RandomSeed(42);
+  std::vector<size_t> otherOldFromNew;
+  TreeType otherRoot(dataset, otherOldFromNew);
+  MaxTreeType otherMaxRoot(dataset);
+
+  #ifdef HAS_OPENMP
+    omp_set_num_threads(oldThreads);
+  #endif
+
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), otherOldFromNew.size());
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew[i], otherOldFromNew[i]);
+  CheckSameTree(root, otherRoot);
+  CheckSameTree(maxRoot, otherMaxRoot);
+
+  std::vector<size_t> counts(dataset.n_cols, 0);
+  std::stack<TreeType*> stack;
+  stack.push(&root);
+  while (!stack.empty())
+  {
+    TreeType* node = stack.top();
+    stack.pop();
+
+    if (node->IsLeaf())
+    {
+      for (size_t i = 0; i < node->NumPoints(); ++i)
+        counts[oldFromNew[node->Point(i)]]++;
+    }
+    else
+    {
+      BOOST_REQUIRE_EQUAL(node->Left()->Count() + node->Right()->Count(),
+          node->Count());
+      stack.push(node->Left());
+      stack.push(node->Right());
+    }
+  }
+
+  for (size_t i = 0; i < counts.size(); ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,39 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+/**
+ * Unite many elements from several threads at once, and make sure that the
+ * components are right and that each merge was reported exactly once.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10000;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < testSize; ++i)
+    BOOST_REQUIRE_EQUAL(testUnionFind.Find(i), i);
+
+  // Join the even and the odd elements into two chains, in both directions, so
+  // that many unions are redundant.
+  size_t merges = 0;
+  #pragma omp parallel for reduction(+:merges)
+  for (omp_size_t i = 2; i < (omp_size_t) testSize; ++i)
+  {
+    if (testUnionFind.Union(i, i - 2))
+      ++merges;
+    if (testUnionFind.Union(i - 2, i))
+      ++merges;
+  }
+
+  BOOST_REQUIRE_EQUAL(merges, testSize - 2);
+  for (size_t i = 2; i < testSize; ++i)
+    BOOST_REQUIRE_EQUAL(testUnionFind.Find(i), testUnionFind.Find(i % 2));
+  BOOST_REQUIRE_NE(testUnionFind.Find(0), testUnionFind.Find(1));
+
+  // Now join the two chains.
+  BOOST_REQUIRE(testUnionFind.Union(0, testSize - 1));
+  BOOST_REQUIRE(!testUnionFind.Union(1, testSize - 2));
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(0), testUnionFind.Find(1));
+}
+
 BOOST_AUTO_TEST_SUITE_END();